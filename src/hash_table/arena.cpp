@@ -0,0 +1,207 @@
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#include "arena.h"
+
+struct ArenaChunk
+{
+    ArenaChunk* next;
+    size_t size;
+};
+
+/* Blocks keep alignment of `malloc` */
+static const size_t block_alignment = 16;
+static const size_t chunk_header_size = sizeof(ArenaChunk);
+
+static_assert(chunk_header_size % block_alignment == 0,
+              "Chunk header breaks block alignment");
+
+__always_inline
+static size_t round_block(size_t size)
+{
+    return (size + block_alignment - 1) & ~(block_alignment - 1);
+}
+
+static int add_chunk(Arena* arena, size_t min_size);
+
+static void* arena_alloc_callback  (void* context, size_t size);
+static void* arena_realloc_callback(void* context, void* ptr,
+                                    size_t old_size, size_t new_size);
+static void  arena_free_callback   (void* context, void* ptr, size_t size);
+
+int arena_ctor(Arena* arena, size_t chunk_size)
+{
+    if (!arena || chunk_size <= chunk_header_size) return -1;
+
+    arena->chunks = NULL;
+    arena->top = NULL;
+    arena->end = NULL;
+    arena->chunk_size = chunk_size;
+    arena->node = -1;
+    arena->allocated = 0;
+    arena->reserved = 0;
+
+    return 0;
+}
+
+int arena_ctor_numa_local(Arena* arena, size_t chunk_size)
+{
+    if (arena_ctor(arena, chunk_size) < 0) return -1;
+
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (getcpu(&cpu, &node) == 0)
+        arena->node = (int) node;
+
+    return 0;
+}
+
+void arena_dtor(Arena* arena)
+{
+    if (!arena) return;
+
+    ArenaChunk* chunk = arena->chunks;
+    while (chunk)
+    {
+        ArenaChunk* next = chunk->next;
+        munmap(chunk, chunk->size);
+        chunk = next;
+    }
+
+    memset(arena, 0, sizeof(*arena));
+}
+
+void arena_reset(Arena* arena)
+{
+    if (!arena || !arena->chunks) return;
+
+    ArenaChunk* current = arena->chunks;
+    ArenaChunk* chunk = current->next;
+    while (chunk)
+    {
+        ArenaChunk* next = chunk->next;
+        arena->reserved -= chunk->size;
+        munmap(chunk, chunk->size);
+        chunk = next;
+    }
+
+    current->next = NULL;
+    arena->top = (char*) current + chunk_header_size;
+    arena->allocated = 0;
+}
+
+void* arena_alloc(Arena* arena, size_t size)
+{
+    const size_t rounded = round_block(size);
+
+    if ((size_t) (arena->end - arena->top) < rounded
+            && add_chunk(arena, rounded) < 0)
+        return NULL;
+
+    void* block = arena->top;
+    arena->top += rounded;
+    arena->allocated += rounded;
+
+    /* Memory of reset chunk is reused */
+    memset(block, 0, size);
+    return block;
+}
+
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size)
+{
+    char* block = (char*) ptr;
+    const size_t old_rounded = round_block(old_size);
+    const size_t new_rounded = round_block(new_size);
+
+    /* Latest block is resized in place */
+    if (block + old_rounded == arena->top
+            && new_rounded <= (size_t) (arena->end - block))
+    {
+        arena->top = block + new_rounded;
+        arena->allocated += new_rounded - old_rounded;
+        return block;
+    }
+
+    void* moved = arena_alloc(arena, new_size);
+    if (!moved)
+        return NULL;
+
+    memcpy(moved, block, old_size < new_size ? old_size : new_size);
+    arena_free(arena, block, old_size);
+
+    return moved;
+}
+
+void arena_free(Arena* arena, void* ptr, size_t size)
+{
+    char* block = (char*) ptr;
+    const size_t rounded = round_block(size);
+
+    if (block + rounded == arena->top)
+    {
+        arena->top = block;
+        arena->allocated -= rounded;
+    }
+}
+
+TableAllocator arena_allocator(Arena* arena)
+{
+    return {
+        .alloc   = arena_alloc_callback,
+        .realloc = arena_realloc_callback,
+        .free    = arena_free_callback,
+        .context = arena
+    };
+}
+
+static int add_chunk(Arena* arena, size_t min_size)
+{
+    size_t size = arena->chunk_size;
+    if (size < min_size + chunk_header_size)
+        size = min_size + chunk_header_size;
+
+    void* pages = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pages == MAP_FAILED)
+        return -1;
+
+    /* Pages are not touched yet, so they will be allocated on the node */
+    if (arena->node >= 0 && (size_t) arena->node < 8 * sizeof(unsigned long))
+    {
+        const unsigned long node_mask = 1lu << arena->node;
+        syscall(SYS_mbind, pages, size, MPOL_PREFERRED, &node_mask,
+                8 * sizeof(node_mask), 0);
+    }
+
+    ArenaChunk* chunk = (ArenaChunk*) pages;
+    chunk->next = arena->chunks;
+    chunk->size = size;
+
+    arena->chunks = chunk;
+    arena->top = (char*) chunk + chunk_header_size;
+    arena->end = (char*) chunk + size;
+    arena->reserved += size;
+
+    return 0;
+}
+
+static void* arena_alloc_callback(void* context, size_t size)
+{
+    return arena_alloc((Arena*) context, size);
+}
+
+static void* arena_realloc_callback(void* context, void* ptr,
+                                    size_t old_size, size_t new_size)
+{
+    return arena_realloc((Arena*) context, ptr, old_size, new_size);
+}
+
+static void arena_free_callback(void* context, void* ptr, size_t size)
+{
+    arena_free((Arena*) context, ptr, size);
+}
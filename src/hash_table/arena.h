@@ -0,0 +1,82 @@
+/**
+ * @file arena.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Bump arena for tables with common lifetime
+ *
+ * Blocks are cut sequentially from large chunks and are freed all at once
+ * by `arena_reset`, so tables created for one request may be dropped in
+ * O(1) per chunk instead of destroying them one by one (keys must not own
+ * memory, as string keys of `FixedHashTable` do). Freeing or resizing the
+ * latest block reuses its space, other freed blocks are reclaimed only by
+ * reset. NUMA-local arena binds its chunks to the memory node of the CPU
+ * it was created on.
+ *
+ * Arena is not thread-safe.
+ *
+ * @version 0.1
+ * @date 2023-05-31
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_ARENA_H
+#define __HASH_TABLE_ARENA_H
+
+#include <stddef.h>
+
+#include "table_allocator.h"
+
+struct ArenaChunk;
+
+struct Arena
+{
+    /** Current chunk, followed by older ones */
+    ArenaChunk* chunks;
+    char* top;
+    char* end;
+
+    size_t chunk_size;
+    /** Memory node of chunks, -1 if chunks are not bound */
+    int node;
+
+    /** Bytes handed out since last reset, for accounting */
+    size_t allocated;
+    /** Bytes mapped for chunks */
+    size_t reserved;
+};
+
+static const size_t ARENA_DEFAULT_CHUNK_SIZE = 2lu << 20;
+
+/**
+ * @brief Construct empty arena. Chunks are mapped on first allocation.
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int  arena_ctor(Arena* arena, size_t chunk_size = ARENA_DEFAULT_CHUNK_SIZE);
+
+/**
+ * @brief Construct arena, which binds its chunks to memory node of calling
+ * CPU. Chunks are left unbound if binding is not permitted.
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int  arena_ctor_numa_local(Arena* arena,
+                           size_t chunk_size = ARENA_DEFAULT_CHUNK_SIZE);
+
+void arena_dtor(Arena* arena);
+
+/**
+ * @brief Free all blocks at once. Current chunk is kept for reuse.
+ */
+void arena_reset(Arena* arena);
+
+void* arena_alloc  (Arena* arena, size_t size);
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size);
+void  arena_free   (Arena* arena, void* ptr, size_t size);
+
+/**
+ * @brief Get descriptor allocating from arena
+ */
+TableAllocator arena_allocator(Arena* arena);
+
+#endif /* arena.h */
@@ -0,0 +1,47 @@
+#include <string.h>
+
+#include "hashes/hash_functions.h"
+
+#include "bloom_filter.h"
+
+/* Allocators guarantee only alignment of `malloc` */
+__always_inline
+static size_t memory_size(size_t block_exp)
+{
+    return (sizeof(BloomFilterBlock) << block_exp) + alignof(BloomFilterBlock);
+}
+
+int bloom_filter_ctor(BloomFilter* filter, size_t block_exp,
+                      const TableAllocator* allocator)
+{
+    if (!filter || !allocator || block_exp >= 48) return -1;
+
+    filter->memory = table_alloc(allocator, memory_size(block_exp));
+    if (!filter->memory) return -1;
+
+    const uintptr_t alignment = alignof(BloomFilterBlock);
+    const uintptr_t address = (uintptr_t) filter->memory;
+    filter->blocks = (BloomFilterBlock*)
+                            ((address + alignment - 1) & ~(alignment - 1));
+    filter->block_exp = block_exp;
+    filter->allocator = *allocator;
+
+    uint64_t seed[2] = {};
+    hash_random_seed(seed);
+    filter->seed = seed[0];
+
+    return 0;
+}
+
+void bloom_filter_dtor(BloomFilter* filter)
+{
+    if (!filter) return;
+    table_free(&filter->allocator, filter->memory,
+               memory_size(filter->block_exp));
+    memset(filter, 0, sizeof(*filter));
+}
+
+void bloom_filter_clear(BloomFilter* filter)
+{
+    memset(filter->blocks, 0, sizeof(*filter->blocks) << filter->block_exp);
+}
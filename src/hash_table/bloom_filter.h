@@ -0,0 +1,126 @@
+/**
+ * @file bloom_filter.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Blocked Bloom filter of 32-bit keys
+ *
+ * Every key sets one bit in each of 8 words of a single 64-byte block, so
+ * that query touches one cache line. See Putze et al. "Cache-, hash- and
+ * space-efficient Bloom filters".
+ *
+ * @version 0.1
+ * @date 2023-05-30
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_BLOOM_FILTER_H
+#define __HASH_TABLE_BLOOM_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <immintrin.h>
+
+#include "table_allocator.h"
+
+static const size_t BLOOM_BLOCK_WORDS = 8;
+
+struct alignas(64) BloomFilterBlock
+{
+    uint64_t words[BLOOM_BLOCK_WORDS];
+};
+
+struct BloomFilter
+{
+    BloomFilterBlock* blocks;
+    size_t block_exp;
+
+    uint64_t seed;
+
+    /** Block allocated by `allocator`, which contains aligned `blocks` */
+    void* memory;
+    TableAllocator allocator;
+};
+
+/**
+ * @brief Construct empty filter of `2^block_exp` blocks, allocated by
+ * `allocator` of owning table
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int  bloom_filter_ctor (BloomFilter* filter, size_t block_exp,
+                        const TableAllocator* allocator);
+void bloom_filter_dtor (BloomFilter* filter);
+void bloom_filter_clear(BloomFilter* filter);
+
+// Odd multipliers giving independent bit positions, as in Impala
+static const uint32_t bloom_salts[BLOOM_BLOCK_WORDS] = {
+    0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du,
+    0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u,
+};
+
+__always_inline
+static uint64_t bloom_filter_hash(const BloomFilter* filter, uint32_t key)
+{
+    uint64_t mixed = key ^ filter->seed;
+    mixed = (mixed ^ (mixed >> 33)) * 0xFF51AFD7ED558CCD;
+    mixed = (mixed ^ (mixed >> 33)) * 0xC4CEB9FE1A85EC53;
+    return mixed ^ (mixed >> 33);
+}
+
+__always_inline
+static BloomFilterBlock* bloom_filter_block(const BloomFilter* filter,
+                                            uint64_t hash)
+{
+    /* Block is selected by high bits, bits inside it by low ones */
+    return filter->blocks + (filter->block_exp ? hash >> (64 - filter->block_exp)
+                                               : 0);
+}
+
+/**
+ * @brief Get single bit in every block word. Computed with AVX-512: scalar
+ * loop takes several times more instructions, which limits the number of
+ * chain lookups overlapped by out-of-order execution.
+ */
+__always_inline
+static __m512i bloom_filter_mask(uint64_t hash)
+{
+    const __m256i salts = _mm256_loadu_si256((const __m256i*) bloom_salts);
+    const __m256i bits  = _mm256_srli_epi32(
+                            _mm256_mullo_epi32(
+                                _mm256_set1_epi32((int) (uint32_t) hash),
+                                salts),
+                            26);
+
+    /* Unmasked forms trigger false -Wmaybe-uninitialized in GCC 12 */
+    return _mm512_maskz_sllv_epi64(0xFF, _mm512_set1_epi64(1),
+                                   _mm512_maskz_cvtepu32_epi64(0xFF, bits));
+}
+
+__always_inline
+static void bloom_filter_add(BloomFilter* filter, uint32_t key)
+{
+    const uint64_t hash = bloom_filter_hash(filter, key);
+    BloomFilterBlock* block = bloom_filter_block(filter, hash);
+
+    _mm512_store_si512(block,
+                       _mm512_or_si512(_mm512_load_si512(block),
+                                       bloom_filter_mask(hash)));
+}
+
+/**
+ * @brief Check if key may have been added. Added keys are never rejected.
+ */
+__always_inline
+static int bloom_filter_may_contain(const BloomFilter* filter, uint32_t key)
+{
+    const uint64_t hash = bloom_filter_hash(filter, key);
+    const BloomFilterBlock* block = bloom_filter_block(filter, hash);
+
+    const __m512i missing = _mm512_maskz_andnot_epi64(0xFF,
+                                                _mm512_load_si512(block),
+                                                bloom_filter_mask(hash));
+
+    return _mm512_test_epi64_mask(missing, missing) == 0;
+}
+
+#endif /* bloom_filter.h */
@@ -0,0 +1,131 @@
+#include <stdlib.h>
+#include <coroutine>
+
+#include "hashes/table_hash.h"
+#include "closed_addr_hash_table.h"
+
+/* Enough in-flight lookups to cover DRAM latency with useful work */
+static const size_t batch_width = 32;
+
+/**
+ * @brief Lookups of every `stride`-th key. Suspends after issuing prefetch
+ * of every filter block or node it is about to read.
+ */
+struct LookupTask
+{
+    struct promise_type
+    {
+        LookupTask get_return_object()
+        {
+            return { std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+
+        std::suspend_never  initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend()   noexcept { return {}; }
+
+        void return_void() {}
+        void unhandled_exception() { abort(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/* GCC lowers coroutine body into switch without default case */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-default"
+
+static LookupTask lookup(ClosedAddrHashTable* table, const uint32_t* keys,
+                         size_t count, size_t first, size_t stride,
+                         uint8_t* results)
+{
+    for (size_t i = first; i < count; i += stride)
+    {
+        const uint32_t key = keys[i];
+
+        results[i] = 0;
+        if (table->filter.blocks)
+        {
+            __builtin_prefetch(bloom_filter_block(&table->filter,
+                                    bloom_filter_hash(&table->filter, key)));
+            co_await std::suspend_always{};
+
+            if (!bloom_filter_may_contain(&table->filter, key))
+                continue;
+        }
+
+        const size_t hash = table_hash_index(&table->hash, key,
+                                             table->size_exp);
+        const ClosedAddrHashTableEntry* node = table->buckets + hash;
+
+        __builtin_prefetch(node);
+        co_await std::suspend_always{};
+
+#ifdef HASH_TABLE_STATS
+        size_t length = 0;
+#endif
+        while ((node = node->next))
+        {
+            __builtin_prefetch(node);
+            co_await std::suspend_always{};
+
+#ifdef HASH_TABLE_STATS
+            ++ length;
+#endif
+            if (node->key == key)
+            {
+                results[i] = 1;
+                break;
+            }
+        }
+
+#ifdef HASH_TABLE_STATS
+        table_stats_record_probe(&table->stats, length);
+#endif
+    }
+}
+
+#pragma GCC diagnostic pop
+
+int closed_addr_hash_table_contains_batch(ClosedAddrHashTable* table,
+                                          const uint32_t* keys, size_t count,
+                                          uint8_t* results)
+{
+    if (!table || !table->allocator.alloc || !keys || !results) return -1;
+
+    /* Small table has no chains to interleave */
+    if (!table->buckets)
+    {
+        for (size_t i = 0; i < count; ++i)
+            results[i] = (uint8_t) closed_addr_hash_table_contains(table,
+                                                                   keys[i]);
+        return 0;
+    }
+
+    std::coroutine_handle<LookupTask::promise_type> tasks[batch_width] = {};
+
+    /* Lookup coroutines run until their first prefetch */
+    size_t active = 0;
+    for (; active < batch_width && active < count; ++active)
+        tasks[active] = lookup(table, keys, count, active, batch_width,
+                               results).handle;
+
+    /* Round-robin over in-flight lookups */
+    while (active > 0)
+    {
+        for (size_t i = 0; i < batch_width; ++i)
+        {
+            if (!tasks[i])
+                continue;
+
+            tasks[i].resume();
+            if (!tasks[i].done())
+                continue;
+
+            tasks[i].destroy();
+            tasks[i] = nullptr;
+            -- active;
+        }
+    }
+
+    return 0;
+}
@@ -1,38 +1,63 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "hashes/hash_functions.h"
+#include "hashes/table_hash.h"
 #include "closed_addr_hash_table.h"
+#include "tracer.h"
 
-static const size_t default_size = 1024;
-static const double fill_factor = 0.75;
+/* Bucket array of small table is allocated at this size or larger one,
+ * which keeps fill factor */
+static const size_t min_size_exp = 6;
+static const double default_fill_factor = 0.75;
+/* Maximal fill factor of well-hashed adaptive table */
+static const double tuned_fill_factor = 1.5;
+/* Filter has one 64-byte block per 64 buckets */
+static const size_t filter_exp_shift = 6;
 
-// As per Donald E. Knuth "The Art of Computer Programming" vol 3 ed. 2
-// section 6.4
-// ~= 2^64 / phi
-static const uint64_t fib_constant = 11400714819323198485llu;
-
-static ClosedAddrHashTableEntry* get_parent_node(ClosedAddrHashTableEntry* head,
-                                                 uint32_t key);
+static ClosedAddrHashTableEntry* get_parent_node(ClosedAddrHashTable* table,
+                                                 size_t hash, uint32_t key);
 static int try_rehash(ClosedAddrHashTable* table);
+static int rehash(ClosedAddrHashTable* table, size_t size_exp,
+                  const TableHashState* new_hash);
+static int tune(ClosedAddrHashTable* table);
+static int rebuild_filter(ClosedAddrHashTable* table);
+static int insert_small(ClosedAddrHashTable* table, uint32_t key);
 
+/* Tables are constructed with allocator and are destroyed by zeroing */
 __always_inline
-static size_t fibonacci_hash(uint64_t key, size_t size_exp)
+static int is_constructed(const ClosedAddrHashTable* table)
 {
-    const size_t shift = 64 - size_exp;
-    key ^= key >> shift;
-    return (fib_constant * key) >> shift;
+    return table && table->allocator.alloc;
 }
 
-void closed_addr_hash_table_ctor(ClosedAddrHashTable* table)
+__always_inline
+static int filter_may_contain(const ClosedAddrHashTable* table, uint32_t key)
+{
+    return !table->filter.blocks
+        || bloom_filter_may_contain(&table->filter, key);
+}
+
+void closed_addr_hash_table_ctor(ClosedAddrHashTable* table, table_hash hash,
+                                 const TableAllocator* allocator)
 {
     if (!table) return;
 
-    table->buckets = (ClosedAddrHashTableEntry*)
-                        calloc(default_size, sizeof(*table->buckets));
-    table->bucket_count = default_size;
-    table->size_exp = 10;
+    table->allocator = allocator ? *allocator : TABLE_DEFAULT_ALLOCATOR;
+    table->buckets = NULL;
+    table->small = {};
+    table->bucket_count = 0;
+    table->size_exp = 0;
     table->distinct_count = 0;
+    table->fill_factor = default_fill_factor;
+    table_hash_init(&table->hash, hash);
+    table->tuner = {};
+    table->rehash_count = 0;
+    table->filter = {};
+    table->filter_erased = 0;
+
+#ifdef HASH_TABLE_STATS
+    table->stats = {};
+#endif
 }
 
 void closed_addr_hash_table_dtor(ClosedAddrHashTable* table)
@@ -45,110 +70,384 @@ void closed_addr_hash_table_dtor(ClosedAddrHashTable* table)
         {
             ClosedAddrHashTableEntry* tmp = cur;
             cur = cur->next;
-            free(tmp);
+            table_free(&table->allocator, tmp, sizeof(*tmp));
         }
     }
-    free(table->buckets);
+    table_free(&table->allocator, table->buckets,
+               table->bucket_count * sizeof(*table->buckets));
+    bloom_filter_dtor(&table->filter);
     memset(table, 0, sizeof(*table));
 }
 
 int  closed_addr_hash_table_insert  (ClosedAddrHashTable* table, uint32_t key)
 {
-    if (!table || !table->buckets) return -1;
-    size_t hash = fibonacci_hash(key, table->size_exp);
-    ClosedAddrHashTableEntry* node =
-                get_parent_node(table->buckets + hash, key)->next;
+    if (!is_constructed(table)) return -1;
+    TRACER_OP(TRACER_EVENT_INSERT, "closed_addr", table->distinct_count);
+
+    if (!table->buckets)
+        return insert_small(table, key);
+
+    size_t hash = table_hash_index(&table->hash, key, table->size_exp);
 
-    if (node) return -1;
+    /* Keys rejected by filter are absent, no need to walk chain */
+    if (filter_may_contain(table, key)
+            && get_parent_node(table, hash, key)->next)
+        return -1;
+
+    ClosedAddrHashTableEntry* node = (ClosedAddrHashTableEntry*)
+                table_alloc(&table->allocator, sizeof(*node));
+    if (!node) return -1;
 
-    node = (ClosedAddrHashTableEntry*) calloc(1, sizeof(*node));
     node->key = key;
     node->next = table->buckets[hash].next;
     table->buckets[hash].next = node;
 
+    if (table->filter.blocks)
+        bloom_filter_add(&table->filter, key);
+
     ++ table->distinct_count;
+
+    if (table_tuner_due(&table->tuner) && tune(table) < 0)
+        return -1;
+
     return try_rehash(table);
 }
 
 int closed_addr_hash_table_erase(ClosedAddrHashTable* table, uint32_t key)
 {
-    if (!table || !table->buckets) return -1;
-    size_t hash = fibonacci_hash(key, table->size_exp);
+    if (!is_constructed(table)) return -1;
+    TRACER_OP(TRACER_EVENT_ERASE, "closed_addr", table->distinct_count);
+
+    /* Filter of small table is only rebuilt when bucket array is
+     * allocated */
+    if (!table->buckets)
+    {
+        const int index = inline_keys_find(&table->small, key);
+        if (index < 0)
+            return -1;
+
+        inline_keys_remove(&table->small, index);
+        return 0;
+    }
+
+    if (!filter_may_contain(table, key)) return -1;
+
+    size_t hash = table_hash_index(&table->hash, key, table->size_exp);
     ClosedAddrHashTableEntry* parent =
-                get_parent_node(table->buckets + hash, key);
+                get_parent_node(table, hash, key);
     ClosedAddrHashTableEntry* node = parent->next;
 
     if (!node) return -1;
     
     parent->next = node->next;
-    free(node);
+    table_free(&table->allocator, node, sizeof(*node));
     -- table->distinct_count;
 
+    /* Bits of erased keys cannot be cleared, so filter is rebuilt when
+     * they accumulate */
+    if (table->filter.blocks
+            && ++ table->filter_erased > table->bucket_count / 2)
+        rebuild_filter(table);
+
+    if (table_tuner_due(&table->tuner))
+        return tune(table);
+
     return 0;
 }
 
 int closed_addr_hash_table_contains(ClosedAddrHashTable* table, uint32_t key)
 {
-    if (!table || !table->buckets) return 0;
-    size_t hash = fibonacci_hash(key, table->size_exp);
+    if (!is_constructed(table)) return 0;
+    TRACER_OP(TRACER_EVENT_CONTAINS, "closed_addr", table->distinct_count);
+
+    /* Single compare is cheaper than filter */
+    if (!table->buckets)
+        return inline_keys_find(&table->small, key) >= 0;
+
+    if (!filter_may_contain(table, key)) return 0;
+
+    size_t hash = table_hash_index(&table->hash, key, table->size_exp);
     ClosedAddrHashTableEntry* node =
-                get_parent_node(table->buckets + hash, key)->next;
-    return !!node;
+                get_parent_node(table, hash, key)->next;
+    const int found = !!node;
+
+    /* Table stays correct if tuning fails */
+    if (table_tuner_due(&table->tuner))
+        tune(table);
+
+    return found;
+}
+
+int closed_addr_hash_table_get_stats(
+                            [[maybe_unused]] const ClosedAddrHashTable* table,
+                            [[maybe_unused]] TableStats* stats)
+{
+#ifdef HASH_TABLE_STATS
+    if (!is_constructed(table) || !stats) return -1;
+
+    memset(stats, 0, sizeof(*stats));
+    table_stats_copy_counters(stats, &table->stats);
+
+    for (size_t i = 0; i < table->bucket_count; ++i)
+    {
+        size_t length = 0;
+        for (const ClosedAddrHashTableEntry* cur = table->buckets[i].next;
+                cur; cur = cur->next)
+            ++ length;
+
+        ++ stats->chain_lengths[table_stats_hist_index(length)];
+        if (length > 0 && length - 1 > stats->max_displacement)
+            stats->max_displacement = length - 1;
+    }
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+int closed_addr_hash_table_enable_filter(ClosedAddrHashTable* table)
+{
+    if (!is_constructed(table)) return -1;
+
+    return rebuild_filter(table);
 }
 
-static ClosedAddrHashTableEntry* get_parent_node(ClosedAddrHashTableEntry* head,
-                                                 uint32_t key)
+int closed_addr_hash_table_enable_tuning(ClosedAddrHashTable* table)
 {
-    if (!head) return NULL;
+    if (!is_constructed(table)) return -1;
 
-    ClosedAddrHashTableEntry* parent = head;
+    table_tuner_enable(&table->tuner, table->fill_factor,
+                       table->fill_factor > tuned_fill_factor
+                       ? table->fill_factor
+                       : tuned_fill_factor);
+
+    return 0;
+}
+
+static ClosedAddrHashTableEntry* get_parent_node(ClosedAddrHashTable* table,
+                                                 size_t hash, uint32_t key)
+{
+    ClosedAddrHashTableEntry* parent = table->buckets + hash;
     ClosedAddrHashTableEntry* current = parent->next;
 
+    size_t length = 0;
+
     while (current && current->key != key)
     {
         parent = current;
         current = parent->next;
+        ++ length;
     }
 
+    /* Matching node is inspected as well */
+#ifdef HASH_TABLE_STATS
+    table_stats_record_probe(&table->stats, current ? length + 1 : length);
+#endif
+    table_tuner_record(&table->tuner, current ? length + 1 : length,
+                       current != NULL);
+
     return parent;
 }
 
 static int try_rehash(ClosedAddrHashTable* table)
 {
-    if (fill_factor*(double)table->bucket_count 
+    if (table->fill_factor*(double)table->bucket_count
             > (double) table->distinct_count)
         return 0;
 
+    return rehash(table, table->size_exp + 1, &table->hash);
+}
+
+/**
+ * @brief Relink nodes into `2^size_exp` buckets, which are indexed by hash
+ * function `new_hash`
+ */
+static int rehash(ClosedAddrHashTable* table, size_t size_exp,
+                  const TableHashState* new_hash)
+{
+#ifdef HASH_TABLE_STATS
+    const uint64_t start_ns = table_stats_now_ns();
+#endif
+    TRACER_BEGIN(trace_start_ns);
+
     const size_t old_size = table->bucket_count;
 
     ClosedAddrHashTableEntry* old_entries = table->buckets;
 
     table->buckets = (ClosedAddrHashTableEntry*)
-                        calloc(2*old_size, sizeof(*table->buckets));
+                        table_alloc(&table->allocator,
+                                    (1lu << size_exp)
+                                            * sizeof(*table->buckets));
     if (!table->buckets)
     {
         table->buckets = old_entries;
         return -1;
     }
 
-    table->bucket_count *= 2;
-    ++table->size_exp;
-    table->distinct_count = 0;
+    table->bucket_count = 1lu << size_exp;
+    table->size_exp = size_exp;
+    table->hash = *new_hash;
+    table_tuner_restart(&table->tuner);
+    ++ table->rehash_count;
 
+    /* Nodes are relinked into new buckets, so that allocator is not used */
     for (size_t i = 0; i < old_size; ++i)
     {
         ClosedAddrHashTableEntry* cur = old_entries[i].next;
         while (cur)
         {
-            ClosedAddrHashTableEntry* tmp = cur;
-            closed_addr_hash_table_insert(table, cur->key);
+            ClosedAddrHashTableEntry* next = cur->next;
+            const size_t hash = table_hash_index(&table->hash, cur->key,
+                                                 table->size_exp);
 
-            cur = cur->next;
-            free(tmp);
+            cur->next = table->buckets[hash].next;
+            table->buckets[hash].next = cur;
+            cur = next;
         }
     }
 
-    free(old_entries);
+    table_free(&table->allocator, old_entries,
+               old_size * sizeof(*old_entries));
+
+    /* Filter is rebuilt for new size */
+    if (table->filter.blocks)
+        rebuild_filter(table);
+
+#ifdef HASH_TABLE_STATS
+    table_stats_record_rehash(&table->stats, start_ns);
+#endif
+
+    TRACER_END(trace_start_ns, TRACER_EVENT_REHASH, "closed_addr",
+               table->bucket_count);
+
     return 0;
 }
 
+/**
+ * @brief Adjust fill factor or hash function using lookups of complete
+ * tuner window
+ */
+static int tune(ClosedAddrHashTable* table)
+{
+    TableTuner* tuner = &table->tuner;
+
+    /* Chain of uniformly hashed keys has `load_factor` keys on average, and
+     * found key is preceded by half of other keys of its chain */
+    const double load_factor = (double) table->distinct_count
+                             / (double) table->bucket_count;
+    const double hit_mean = 1 + load_factor / 2;
+    const double miss_mean = load_factor;
+
+    switch (table_tuner_evaluate(tuner, hit_mean, miss_mean, table->size_exp))
+    {
+    case TABLE_TUNER_FILL_MORE:
+        table->fill_factor += TABLE_TUNER_FILL_STEP;
+        if (table->fill_factor > tuner->max_fill_factor)
+            table->fill_factor = tuner->max_fill_factor;
+        return 0;
+    case TABLE_TUNER_REHASH:
+    {
+        /* Table keeps its size, unless keys do not fit default fill */
+        table->fill_factor = tuner->min_fill_factor;
+        size_t size_exp = table->size_exp;
+        while (table->fill_factor * (double) (1lu << size_exp)
+                    <= (double) table->distinct_count)
+            ++ size_exp;
+
+        TableHashState hash = {};
+        table_hash_init(&hash, table_tuner_stronger_hash(table->hash.kind));
+        return rehash(table, size_exp, &hash);
+    }
+    case TABLE_TUNER_KEEP:
+    default:
+        return 0;
+    }
+}
+
+static int rebuild_filter(ClosedAddrHashTable* table)
+{
+    const size_t block_exp = table->size_exp > filter_exp_shift
+                           ? table->size_exp - filter_exp_shift
+                           : 0;
+
+    if (table->filter.blocks && table->filter.block_exp == block_exp)
+        bloom_filter_clear(&table->filter);
+    else
+    {
+        /* Table stays correct without filter, if it cannot be allocated */
+        bloom_filter_dtor(&table->filter);
+        if (bloom_filter_ctor(&table->filter, block_exp,
+                              &table->allocator) < 0)
+            return -1;
+    }
+
+    for (size_t i = 0; i < table->bucket_count; ++i)
+        for (const ClosedAddrHashTableEntry* cur = table->buckets[i].next;
+                cur; cur = cur->next)
+            bloom_filter_add(&table->filter, cur->key);
+
+    for (size_t i = 0; i < table->small.count; ++i)
+        bloom_filter_add(&table->filter, table->small.keys[i]);
+
+    table->filter_erased = 0;
+    return 0;
+}
+
+/**
+ * @brief Insert key into small table, allocating bucket array when it is
+ * full
+ */
+static int insert_small(ClosedAddrHashTable* table, uint32_t key)
+{
+    if (inline_keys_find(&table->small, key) >= 0)
+        return -1;
+
+    if (table->small.count < INLINE_KEYS_CAPACITY)
+    {
+        inline_keys_add(&table->small, key);
+        if (table->filter.blocks)
+            bloom_filter_add(&table->filter, key);
+        return 0;
+    }
+
+    /* Nodes are allocated first, so that table stays small upon failure */
+    ClosedAddrHashTableEntry* nodes[INLINE_KEYS_CAPACITY] = {};
+    int status = 0;
+    for (size_t i = 0; i < table->small.count && status == 0; ++i)
+    {
+        nodes[i] = (ClosedAddrHashTableEntry*)
+                    table_alloc(&table->allocator, sizeof(*nodes[i]));
+        status = nodes[i] ? 0 : -1;
+    }
+
+    size_t size_exp = min_size_exp;
+    while (table->fill_factor * (double) (1lu << size_exp)
+                <= (double) (table->small.count + 1))
+        ++ size_exp;
+
+    /* Inline keys are moved into chains after filter is rebuilt, which
+     * keeps them in filter */
+    if (status < 0 || rehash(table, size_exp, &table->hash) < 0)
+    {
+        for (size_t i = 0; i < table->small.count; ++i)
+            table_free(&table->allocator, nodes[i], sizeof(*nodes[i]));
+        return -1;
+    }
+
+    for (size_t i = 0; i < table->small.count; ++i)
+    {
+        const size_t hash = table_hash_index(&table->hash,
+                                             table->small.keys[i],
+                                             table->size_exp);
+
+        nodes[i]->key = table->small.keys[i];
+        nodes[i]->next = table->buckets[hash].next;
+        table->buckets[hash].next = nodes[i];
+        ++ table->distinct_count;
+    }
+
+    table->small.count = 0;
+
+    return closed_addr_hash_table_insert(table, key);
+}
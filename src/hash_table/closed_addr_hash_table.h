@@ -15,6 +15,13 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "hashes/table_hash.h"
+#include "bloom_filter.h"
+#include "inline_keys.h"
+#include "table_allocator.h"
+#include "table_stats.h"
+#include "table_tuner.h"
+
 struct ClosedAddrHashTableEntry
 {
     uint32_t key;
@@ -23,17 +30,89 @@ struct ClosedAddrHashTableEntry
 
 struct ClosedAddrHashTable
 {
+    /** Bucket array, NULL while keys fit into `small` */
     ClosedAddrHashTableEntry* buckets;
+    InlineKeys small;
 
     size_t size_exp;
     size_t bucket_count;
     size_t distinct_count;
+    /** Table is grown when there are this many keys per bucket */
+    double fill_factor;
+
+    TableHashState hash;
+
+    /** Adjusts fill factor and hash function if enabled */
+    TableTuner tuner;
+
+    /** Rehashes since construction, including ones at the same size */
+    size_t rehash_count;
+
+    /** Rejects most absent keys, disabled if `filter.blocks` is NULL */
+    BloomFilter filter;
+    /** Erased keys still present in filter */
+    size_t filter_erased;
+
+    TableAllocator allocator;
+
+#ifdef HASH_TABLE_STATS
+    TableStatsCounters stats;
+#endif
 };
 
-void closed_addr_hash_table_ctor    (ClosedAddrHashTable* table);
+/**
+ * @brief Construct empty table. First `INLINE_KEYS_CAPACITY` keys are kept
+ * inside table, and bucket array and chain nodes are allocated after that
+ * by `allocator`, or by `TABLE_DEFAULT_ALLOCATOR` if it is NULL.
+ */
+void closed_addr_hash_table_ctor    (ClosedAddrHashTable* table,
+                                     table_hash hash = TABLE_HASH_FIBONACCI,
+                                     const TableAllocator* allocator = NULL);
 void closed_addr_hash_table_dtor    (ClosedAddrHashTable* table);
 int  closed_addr_hash_table_insert  (ClosedAddrHashTable* table, uint32_t key);
 int  closed_addr_hash_table_erase   (ClosedAddrHashTable* table, uint32_t key);
 int  closed_addr_hash_table_contains(ClosedAddrHashTable* table, uint32_t key);
 
+/**
+ * @brief Enable Bloom filter, which lets lookups, erases and insertions of
+ * absent keys skip bucket chains. Filter takes a byte per bucket and is
+ * rebuilt after rehash and after every `bucket_count / 2` erases.
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int  closed_addr_hash_table_enable_filter(ClosedAddrHashTable* table);
+
+/**
+ * @brief Enable adaptive mode. Lookups are monitored, and table is rehashed
+ * early with stronger hash function if chains are longer than expected, or
+ * keeps more keys per bucket (up to 1.5) if they are not.
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int  closed_addr_hash_table_enable_tuning(ClosedAddrHashTable* table);
+
+/**
+ * @brief Look up many keys at once. Chain walks of several keys are
+ * interleaved by coroutines, so that cache misses of one lookup are
+ * overlapped with work of other ones.
+ *
+ * @param[in]  table    - Hash table
+ * @param[in]  keys     - Looked up keys
+ * @param[in]  count    - Number of keys
+ * @param[out] results  - 1 for keys contained in table, 0 otherwise
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int  closed_addr_hash_table_contains_batch(ClosedAddrHashTable* table,
+                                           const uint32_t* keys, size_t count,
+                                           uint8_t* results);
+
+/**
+ * @brief Get table statistics
+ *
+ * @return 0 upon success, -1 if table is invalid or statistics are disabled
+ */
+int  closed_addr_hash_table_get_stats(const ClosedAddrHashTable* table,
+                                      TableStats* stats);
+
 #endif /* closed_addr_hash_table.h */
@@ -0,0 +1,575 @@
+#include <fcntl.h>
+#include <immintrin.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "hashes/table_hash.h"
+#include "extendible_hash_table.h"
+
+static const char header_magic[8] = { 'E', 'X', 'T', 'H', 'A', 'S', 'H', '1' };
+
+/* Directory of 2^40 entries would take 8TB */
+static const size_t max_global_depth = 40;
+
+static const uint32_t no_frame = UINT32_MAX;
+static const uint64_t no_page  = UINT64_MAX;
+
+static const size_t bucket_capacity =
+                sizeof(((ExtendibleBucket*) NULL)->keys) / sizeof(uint64_t);
+
+/**
+ * @brief First page of data file
+ */
+struct ExtendibleHeader
+{
+    char magic[sizeof(header_magic)];
+    uint64_t page_size;
+    uint64_t global_depth;
+    uint64_t page_count;
+    uint64_t distinct_count;
+};
+
+/* Bucket is chosen by high bits of Fibonacci hash, so that index at larger
+ * depth refines index at smaller one */
+__always_inline
+static uint64_t key_hash(uint64_t key)
+{
+    return fib_constant * key;
+}
+
+__always_inline
+static size_t hash_prefix(uint64_t hash, size_t depth)
+{
+    return depth ? hash >> (64 - depth) : 0;
+}
+
+/**
+ * @brief Find key in bucket comparing 8 keys at once
+ *
+ * @return Index of key, `bucket->count` if it is absent
+ */
+static size_t find_key(const ExtendibleBucket* bucket, uint64_t key)
+{
+    const __m512i needle = _mm512_set1_epi64((long long) key);
+
+    for (size_t i = 0; i < bucket->count; i += 8)
+    {
+        const size_t left = bucket->count - i;
+        const __mmask8 valid = left >= 8 ? (__mmask8) 0xFF
+                                         : (__mmask8) ((1u << left) - 1);
+        const __m512i keys =
+                    _mm512_maskz_loadu_epi64(valid, &bucket->keys[i]);
+        const __mmask8 equal =
+                    _mm512_mask_cmpeq_epi64_mask(valid, keys, needle);
+        if (equal)
+            return i + (size_t) __builtin_ctz(equal);
+    }
+
+    return bucket->count;
+}
+
+static int  pool_ctor(ExtendibleBufferPool* pool, size_t frame_count,
+                      uint64_t page_count);
+static void pool_dtor(ExtendibleBufferPool* pool);
+static ExtendibleBucket* pool_fetch(ExtendibleHashTable* table,
+                                    uint64_t page, int fresh);
+static void pool_mark_dirty(ExtendibleHashTable* table,
+                            const ExtendibleBucket* bucket);
+static int  pool_write_frame(ExtendibleHashTable* table, uint32_t frame);
+
+static int open_files(ExtendibleHashTable* table, const char* path);
+static int create_table(ExtendibleHashTable* table);
+static int load_table(ExtendibleHashTable* table);
+static int map_directory(ExtendibleHashTable* table);
+static int grow_directory(ExtendibleHashTable* table);
+static int split_bucket(ExtendibleHashTable* table, uint64_t hash);
+
+int extendible_hash_table_ctor(ExtendibleHashTable* table, const char* path,
+                               size_t pool_pages)
+{
+    if (!table || !path || pool_pages < 2 || pool_pages >= no_frame)
+        return -1;
+
+    memset(table, 0, sizeof(*table));
+    table->data_fd = -1;
+    table->directory_fd = -1;
+
+    if (open_files(table, path) < 0)
+        return -1;
+
+    struct stat data_stat = {};
+    int status = fstat(table->data_fd, &data_stat);
+    if (status == 0)
+        status = data_stat.st_size == 0 ? create_table(table)
+                                        : load_table(table);
+    if (status == 0)
+        status = pool_ctor(&table->pool, pool_pages, table->page_count);
+
+    /* Root bucket of new table is written through pool */
+    if (status == 0 && data_stat.st_size == 0)
+    {
+        ExtendibleBucket* root = pool_fetch(table, table->directory[0], 1);
+        if (root)
+            pool_mark_dirty(table, root);
+        status = root ? extendible_hash_table_flush(table) : -1;
+    }
+
+    if (status < 0)
+    {
+        pool_dtor(&table->pool);
+        if (table->directory)
+            munmap(table->directory, sizeof(uint64_t) << table->global_depth);
+        close(table->data_fd);
+        close(table->directory_fd);
+        memset(table, 0, sizeof(*table));
+        return -1;
+    }
+
+    return 0;
+}
+
+int extendible_hash_table_dtor(ExtendibleHashTable* table)
+{
+    if (!table || !table->directory) return -1;
+
+    const int status = extendible_hash_table_flush(table);
+
+    pool_dtor(&table->pool);
+    munmap(table->directory, sizeof(uint64_t) << table->global_depth);
+    close(table->data_fd);
+    close(table->directory_fd);
+    memset(table, 0, sizeof(*table));
+
+    return status;
+}
+
+int extendible_hash_table_insert(ExtendibleHashTable* table, uint64_t key)
+{
+    if (!table || !table->directory) return -1;
+
+    const uint64_t hash = key_hash(key);
+
+    /* Every split moves about half of keys, but all of them may share
+     * the next bit, so bucket is split until key fits */
+    while (true)
+    {
+        const uint64_t page =
+                    table->directory[hash_prefix(hash, table->global_depth)];
+        ExtendibleBucket* bucket = pool_fetch(table, page, 0);
+        if (!bucket) return -1;
+
+        if (find_key(bucket, key) < bucket->count)
+            return -1;
+
+        if (bucket->count < bucket_capacity)
+        {
+            bucket->keys[bucket->count++] = key;
+            pool_mark_dirty(table, bucket);
+            ++ table->distinct_count;
+            return 0;
+        }
+
+        if (split_bucket(table, hash) < 0)
+            return -1;
+    }
+}
+
+int extendible_hash_table_erase(ExtendibleHashTable* table, uint64_t key)
+{
+    if (!table || !table->directory) return -1;
+
+    const uint64_t hash = key_hash(key);
+    const uint64_t page =
+                table->directory[hash_prefix(hash, table->global_depth)];
+    ExtendibleBucket* bucket = pool_fetch(table, page, 0);
+    if (!bucket) return -1;
+
+    const size_t index = find_key(bucket, key);
+    if (index == bucket->count)
+        return -1;
+
+    /* Buckets are never merged, as sets rarely shrink much */
+    bucket->keys[index] = bucket->keys[--bucket->count];
+    pool_mark_dirty(table, bucket);
+    -- table->distinct_count;
+    return 0;
+}
+
+int extendible_hash_table_contains(ExtendibleHashTable* table, uint64_t key)
+{
+    if (!table || !table->directory) return 0;
+
+    const uint64_t hash = key_hash(key);
+    const uint64_t page =
+                table->directory[hash_prefix(hash, table->global_depth)];
+    const ExtendibleBucket* bucket = pool_fetch(table, page, 0);
+    if (!bucket) return 0;
+
+    return find_key(bucket, key) < bucket->count;
+}
+
+int extendible_hash_table_flush(ExtendibleHashTable* table)
+{
+    if (!table || !table->directory) return -1;
+
+    int status = 0;
+    for (uint32_t i = 0; i < table->pool.used_frames; ++i)
+        if (table->pool.frames[i].dirty && pool_write_frame(table, i) < 0)
+            status = -1;
+
+    ExtendibleHeader header = {
+        .magic = {},
+        .page_size = EXTENDIBLE_PAGE_SIZE,
+        .global_depth = table->global_depth,
+        .page_count = table->page_count,
+        .distinct_count = table->distinct_count
+    };
+    memcpy(header.magic, header_magic, sizeof(header_magic));
+
+    if (pwrite(table->data_fd, &header, sizeof(header), 0)
+            != (ssize_t) sizeof(header))
+        status = -1;
+
+    if (msync(table->directory, sizeof(uint64_t) << table->global_depth,
+              MS_SYNC) < 0
+     || fdatasync(table->data_fd) < 0)
+        status = -1;
+
+    return status;
+}
+
+static int open_files(ExtendibleHashTable* table, const char* path)
+{
+    const size_t path_length = strlen(path);
+    char* directory_path = (char*) calloc(path_length + sizeof(".dir"), 1);
+    if (!directory_path)
+        return -1;
+
+    memcpy(directory_path, path, path_length);
+    memcpy(directory_path + path_length, ".dir", sizeof(".dir"));
+
+    table->data_fd      = open(path, O_RDWR | O_CREAT, 0644);
+    table->directory_fd = open(directory_path, O_RDWR | O_CREAT, 0644);
+    free(directory_path);
+
+    if (table->data_fd < 0 || table->directory_fd < 0)
+    {
+        close(table->data_fd);
+        close(table->directory_fd);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int create_table(ExtendibleHashTable* table)
+{
+    /* Page 0 is header, page 1 is root bucket */
+    table->global_depth = 0;
+    table->page_count = 2;
+    table->distinct_count = 0;
+
+    if (ftruncate(table->directory_fd, sizeof(uint64_t)) < 0
+     || map_directory(table) < 0)
+        return -1;
+
+    table->directory[0] = 1;
+    return 0;
+}
+
+static int load_table(ExtendibleHashTable* table)
+{
+    ExtendibleHeader header = {};
+    if (pread(table->data_fd, &header, sizeof(header), 0)
+            != (ssize_t) sizeof(header))
+        return -1;
+
+    if (memcmp(header.magic, header_magic, sizeof(header_magic)) != 0
+     || header.page_size != EXTENDIBLE_PAGE_SIZE
+     || header.global_depth > max_global_depth)
+        return -1;
+
+    /* Every page, including header and root bucket, must be in file */
+    struct stat data_stat = {};
+    if (fstat(table->data_fd, &data_stat) < 0
+     || header.page_count < 2
+     || header.page_count > (uint64_t) data_stat.st_size
+                                            / EXTENDIBLE_PAGE_SIZE)
+        return -1;
+
+    table->global_depth = header.global_depth;
+    table->page_count = header.page_count;
+    table->distinct_count = header.distinct_count;
+
+    struct stat directory_stat = {};
+    if (fstat(table->directory_fd, &directory_stat) < 0
+     || (size_t) directory_stat.st_size
+                    != sizeof(uint64_t) << table->global_depth)
+        return -1;
+
+    if (map_directory(table) < 0)
+        return -1;
+
+    /* Header page is never a bucket */
+    const size_t directory_size = 1lu << table->global_depth;
+    for (size_t i = 0; i < directory_size; ++i)
+        if (table->directory[i] == 0
+         || table->directory[i] >= table->page_count)
+            return -1;
+
+    return 0;
+}
+
+static int map_directory(ExtendibleHashTable* table)
+{
+    void* directory = mmap(NULL, sizeof(uint64_t) << table->global_depth,
+                           PROT_READ | PROT_WRITE, MAP_SHARED,
+                           table->directory_fd, 0);
+    if (directory == MAP_FAILED)
+        return -1;
+
+    table->directory = (uint64_t*) directory;
+    return 0;
+}
+
+static int grow_directory(ExtendibleHashTable* table)
+{
+    if (table->global_depth >= max_global_depth)
+        return -1;
+
+    const size_t old_entries = 1lu << table->global_depth;
+    const size_t old_size = old_entries * sizeof(uint64_t);
+
+    if (ftruncate(table->directory_fd, (off_t) (2 * old_size)) < 0)
+        return -1;
+
+    void* directory = mremap(table->directory, old_size, 2 * old_size,
+                             MREMAP_MAYMOVE);
+    if (directory == MAP_FAILED)
+    {
+        ftruncate(table->directory_fd, (off_t) old_size);
+        return -1;
+    }
+
+    /* Every entry is duplicated for both values of the new bit. Going
+     * downwards, entries are read before they are overwritten. */
+    uint64_t* entries = (uint64_t*) directory;
+    for (size_t i = old_entries; i-- > 0;)
+    {
+        entries[2 * i + 1] = entries[i];
+        entries[2 * i]     = entries[i];
+    }
+
+    table->directory = entries;
+    ++ table->global_depth;
+
+    return 0;
+}
+
+static int split_bucket(ExtendibleHashTable* table, uint64_t hash)
+{
+    const uint64_t page =
+                table->directory[hash_prefix(hash, table->global_depth)];
+    ExtendibleBucket* bucket = pool_fetch(table, page, 0);
+    if (!bucket) return -1;
+
+    if (bucket->local_depth == table->global_depth
+            && grow_directory(table) < 0)
+        return -1;
+
+    /* Bucket was just used, so it is not evicted by fetching sibling */
+    const uint64_t sibling_page = table->page_count++;
+    ExtendibleBucket* sibling = pool_fetch(table, sibling_page, 1);
+    if (!sibling)
+    {
+        -- table->page_count;
+        return -1;
+    }
+
+    const size_t depth = bucket->local_depth + 1;
+    size_t kept = 0;
+    for (size_t i = 0; i < bucket->count; ++i)
+    {
+        const uint64_t key = bucket->keys[i];
+        if (hash_prefix(key_hash(key), depth) & 1)
+            sibling->keys[sibling->count++] = key;
+        else
+            bucket->keys[kept++] = key;
+    }
+
+    bucket->count = (uint32_t) kept;
+    bucket->local_depth = (uint32_t) depth;
+    sibling->local_depth = (uint32_t) depth;
+    pool_mark_dirty(table, bucket);
+    pool_mark_dirty(table, sibling);
+
+    /* Bucket was referenced by entries sharing its old prefix, those with
+     * set new bit now reference sibling */
+    const size_t shift = table->global_depth - depth;
+    const size_t first = (hash_prefix(hash, depth) | 1) << shift;
+    for (size_t i = 0; i < 1lu << shift; ++i)
+        table->directory[first + i] = sibling_page;
+
+    return 0;
+}
+
+static int pool_ctor(ExtendibleBufferPool* pool, size_t frame_count,
+                     uint64_t page_count)
+{
+    pool->pages = (ExtendibleBucket*)
+                    aligned_alloc(EXTENDIBLE_PAGE_SIZE,
+                                  frame_count * sizeof(*pool->pages));
+    pool->frames = (ExtendibleFrame*)
+                    calloc(frame_count, sizeof(*pool->frames));
+
+    pool->page_frames_capacity = page_count > 1024 ? page_count : 1024;
+    pool->page_frames = (uint32_t*)
+                    malloc(pool->page_frames_capacity
+                                    * sizeof(*pool->page_frames));
+
+    if (!pool->pages || !pool->frames || !pool->page_frames)
+        return -1;
+
+    memset(pool->page_frames, 0xFF,
+           pool->page_frames_capacity * sizeof(*pool->page_frames));
+
+    pool->frame_count = frame_count;
+    pool->used_frames = 0;
+    pool->head = no_frame;
+    pool->tail = no_frame;
+
+    return 0;
+}
+
+static void pool_dtor(ExtendibleBufferPool* pool)
+{
+    free(pool->pages);
+    free(pool->frames);
+    free(pool->page_frames);
+    memset(pool, 0, sizeof(*pool));
+}
+
+static void pool_unlink(ExtendibleBufferPool* pool, uint32_t frame)
+{
+    ExtendibleFrame* entry = &pool->frames[frame];
+
+    if (entry->prev != no_frame)
+        pool->frames[entry->prev].next = entry->next;
+    else
+        pool->head = entry->next;
+
+    if (entry->next != no_frame)
+        pool->frames[entry->next].prev = entry->prev;
+    else
+        pool->tail = entry->prev;
+}
+
+static void pool_push_front(ExtendibleBufferPool* pool, uint32_t frame)
+{
+    ExtendibleFrame* entry = &pool->frames[frame];
+
+    entry->prev = no_frame;
+    entry->next = pool->head;
+
+    if (pool->head != no_frame)
+        pool->frames[pool->head].prev = frame;
+    else
+        pool->tail = frame;
+
+    pool->head = frame;
+}
+
+static ExtendibleBucket* pool_fetch(ExtendibleHashTable* table,
+                                    uint64_t page, int fresh)
+{
+    ExtendibleBufferPool* pool = &table->pool;
+
+    if (page >= pool->page_frames_capacity)
+    {
+        size_t capacity = pool->page_frames_capacity;
+        while (capacity <= page)
+            capacity *= 2;
+
+        uint32_t* page_frames = (uint32_t*)
+                    realloc(pool->page_frames,
+                            capacity * sizeof(*page_frames));
+        if (!page_frames)
+            return NULL;
+
+        memset(page_frames + pool->page_frames_capacity, 0xFF,
+               (capacity - pool->page_frames_capacity)
+                                            * sizeof(*page_frames));
+        pool->page_frames = page_frames;
+        pool->page_frames_capacity = capacity;
+    }
+
+    uint32_t frame = pool->page_frames[page];
+    if (frame != no_frame)
+    {
+        ++ pool->hits;
+        pool_unlink(pool, frame);
+        pool_push_front(pool, frame);
+        return &pool->pages[frame];
+    }
+
+    ++ pool->misses;
+
+    if (pool->used_frames < pool->frame_count)
+        frame = (uint32_t) pool->used_frames++;
+    else
+    {
+        frame = pool->tail;
+        if (pool->frames[frame].dirty && pool_write_frame(table, frame) < 0)
+            return NULL;
+
+        pool_unlink(pool, frame);
+        if (pool->frames[frame].page != no_page)
+            pool->page_frames[pool->frames[frame].page] = no_frame;
+    }
+
+    ExtendibleBucket* bucket = &pool->pages[frame];
+    if (fresh)
+        memset(bucket, 0, sizeof(*bucket));
+    else if (pread(table->data_fd, bucket, sizeof(*bucket),
+                   (off_t) (page * EXTENDIBLE_PAGE_SIZE))
+                != (ssize_t) sizeof(*bucket))
+    {
+        /* Frame is kept in list without page */
+        pool->frames[frame].page = no_page;
+        pool->frames[frame].dirty = 0;
+        pool_push_front(pool, frame);
+        return NULL;
+    }
+
+    pool->frames[frame].page = page;
+    pool->frames[frame].dirty = 0;
+    pool->page_frames[page] = frame;
+    pool_push_front(pool, frame);
+
+    return bucket;
+}
+
+static void pool_mark_dirty(ExtendibleHashTable* table,
+                            const ExtendibleBucket* bucket)
+{
+    table->pool.frames[bucket - table->pool.pages].dirty = 1;
+}
+
+static int pool_write_frame(ExtendibleHashTable* table, uint32_t frame)
+{
+    ExtendibleFrame* entry = &table->pool.frames[frame];
+
+    if (pwrite(table->data_fd, &table->pool.pages[frame],
+               EXTENDIBLE_PAGE_SIZE,
+               (off_t) (entry->page * EXTENDIBLE_PAGE_SIZE))
+            != (ssize_t) EXTENDIBLE_PAGE_SIZE)
+        return -1;
+
+    ++ table->pool.writes;
+    entry->dirty = 0;
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file extendible_hash_table.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Disk-resident set of 64-bit keys using extendible hashing
+ *
+ * Keys are stored in page-sized buckets of data file. Directory of
+ * `2^global_depth` bucket page numbers is kept in memory-mapped directory
+ * file next to it, and is indexed by high bits of Fibonacci hash of key.
+ * Overflowing bucket is split in two by next hash bit, doubling directory
+ * only if bucket was referenced by single directory entry. Bucket pages are
+ * read and written through LRU buffer pool of fixed number of frames, so
+ * table may be much larger than memory.
+ *
+ * Table is persistent: constructing it on existing file reopens stored
+ * set. Changes reach the file when dirty pages are evicted, and all of them
+ * are written by `extendible_hash_table_flush` and destructor.
+ *
+ * @version 0.1
+ * @date 2023-06-01
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_EXTENDIBLE_HASH_TABLE_H
+#define __HASH_TABLE_EXTENDIBLE_HASH_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+static const size_t EXTENDIBLE_PAGE_SIZE = 4096;
+static const size_t EXTENDIBLE_DEFAULT_POOL_PAGES = 1024;
+
+struct ExtendibleBucket
+{
+    uint32_t local_depth;
+    uint32_t count;
+    uint64_t keys[(EXTENDIBLE_PAGE_SIZE - 2 * sizeof(uint32_t))
+                                                        / sizeof(uint64_t)];
+};
+
+static_assert(sizeof(ExtendibleBucket) == EXTENDIBLE_PAGE_SIZE,
+              "Bucket must occupy exactly one page");
+
+/**
+ * @brief Frame of buffer pool, linked into LRU list by frame indices
+ */
+struct ExtendibleFrame
+{
+    uint64_t page;
+    uint32_t prev;
+    uint32_t next;
+    int dirty;
+};
+
+struct ExtendibleBufferPool
+{
+    ExtendibleBucket* pages;
+    ExtendibleFrame* frames;
+    size_t frame_count;
+    /** Frames in use, free frames are taken before evicting */
+    size_t used_frames;
+
+    /** Most and least recently used frames */
+    uint32_t head;
+    uint32_t tail;
+
+    /** Frame of every page of data file, `UINT32_MAX` if not cached */
+    uint32_t* page_frames;
+    size_t page_frames_capacity;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t writes;
+};
+
+struct ExtendibleHashTable
+{
+    int data_fd;
+    int directory_fd;
+
+    uint64_t* directory;
+    size_t global_depth;
+
+    /** Pages of data file, including header */
+    uint64_t page_count;
+    uint64_t distinct_count;
+
+    ExtendibleBufferPool pool;
+};
+
+/**
+ * @brief Open table stored in `path` and `path`.dir, creating empty one if
+ * files do not exist
+ *
+ * @param[out] table        - Constructed table
+ * @param[in]  path         - Data file path
+ * @param[in]  pool_pages   - Number of cached pages, at least 2
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int  extendible_hash_table_ctor    (ExtendibleHashTable* table,
+                                    const char* path,
+                                    size_t pool_pages =
+                                            EXTENDIBLE_DEFAULT_POOL_PAGES);
+
+/**
+ * @brief Write all changes and close table
+ *
+ * @return 0 upon success, -1 if changes could not be written
+ */
+int  extendible_hash_table_dtor    (ExtendibleHashTable* table);
+
+/**
+ * @return 0 upon success, -1 if key is present or I/O failed
+ */
+int  extendible_hash_table_insert  (ExtendibleHashTable* table, uint64_t key);
+
+/**
+ * @return 0 upon success, -1 if key is absent or I/O failed
+ */
+int  extendible_hash_table_erase   (ExtendibleHashTable* table, uint64_t key);
+
+/**
+ * @return 1 if key is present, 0 if it is absent or I/O failed
+ */
+int  extendible_hash_table_contains(ExtendibleHashTable* table, uint64_t key);
+
+/**
+ * @brief Write dirty pages, header and directory to files
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int  extendible_hash_table_flush   (ExtendibleHashTable* table);
+
+#endif /* extendible_hash_table.h */
@@ -1,5 +1,3 @@
-#include <typeinfo>
-
 #include <stdlib.h>
 #include <string.h>
 
@@ -8,11 +6,19 @@
 #include "hashes/hash_functions.h"
 
 #include "fixed_hash_table.h"
+#include "tracer.h"
+
+template <typename Preset, typename Preset::hash_fn* Hash>
+static typename FixedHashTable<Preset, Hash>::entry_type* find_parent_node(
+                                    const FixedHashTable<Preset, Hash>* table,
+                                    typename Preset::key_type key,
+                                    uint64_t key_hash);
 
-static FixedHashTableEntry* find_parent_node(const FixedHashTable* table,
-                                            KEY_TYPE key, uint64_t key_hash);
-static void mark_free(FixedHashTableEntry* entries, size_t entry_count);
-static int try_grow(FixedHashTable* table);
+template <typename Entry>
+static void mark_free(Entry* entries, size_t entry_count);
+
+template <typename Preset, typename Preset::hash_fn* Hash>
+static int try_grow(FixedHashTable<Preset, Hash>* table);
 
 __always_inline
 static size_t round_to_pow2(size_t x)
@@ -23,8 +29,13 @@ static size_t round_to_pow2(size_t x)
     return result;
 }
 
-int fixed_hash_table_ctor(FixedHashTable* table, const size_t bucket_count)
+template <typename Preset, typename Preset::hash_fn* Hash>
+int fixed_hash_table_ctor(FixedHashTable<Preset, Hash>* table,
+                          const size_t bucket_count,
+                          const TableAllocator* allocator)
 {
+    typedef typename FixedHashTable<Preset, Hash>::entry_type entry_type;
+
     SAFE_BLOCK_START
     {
         ASSERT_TRUE(table != NULL);
@@ -37,13 +48,17 @@ int fixed_hash_table_ctor(FixedHashTable* table, const size_t bucket_count)
     }
     SAFE_BLOCK_END
 
+    if (!allocator)
+        allocator = &TABLE_DEFAULT_ALLOCATOR;
+
     size_t capacity = round_to_pow2(2*bucket_count);
-    FixedHashTableEntry* buffer = NULL;
+    entry_type* buffer = NULL;
 
     SAFE_BLOCK_START
     {
         ASSERT_SIMPLE(
-            buffer = (FixedHashTableEntry*)calloc(capacity, sizeof(*buffer)),
+            buffer = (entry_type*)table_alloc(allocator,
+                                              capacity * sizeof(*buffer)),
             action_result != NULL);
     }
     SAFE_BLOCK_HANDLE_ERRORS
@@ -62,11 +77,17 @@ int fixed_hash_table_ctor(FixedHashTable* table, const size_t bucket_count)
 
     table->capacity = capacity;
     table->distinct_count = 0;
+    table->allocator = *allocator;
+
+#ifdef HASH_TABLE_STATS
+    table->stats = {};
+#endif
 
     return 0;
 }
 
-int fixed_hash_table_dtor(FixedHashTable* table)
+template <typename Preset, typename Preset::hash_fn* Hash>
+int fixed_hash_table_dtor(FixedHashTable<Preset, Hash>* table)
 {
     SAFE_BLOCK_START
     {
@@ -83,21 +104,24 @@ int fixed_hash_table_dtor(FixedHashTable* table)
 
     for (size_t i = 0; i < table->bucket_count; ++i)
     {
-        FixedHashTableEntry* entry = table->buckets[i].next;
+        auto* entry = table->buckets[i].next;
         while (entry)
         {
-            KEY_DTOR(entry->key);
+            Preset::dtor(entry->key);
             entry = entry->next;
         }
     }
-    free(table->buckets);
+    table_free(&table->allocator, table->buckets,
+               table->capacity * sizeof(*table->buckets));
 
     memset(table, 0, sizeof(*table));
 
     return 0;
 }
 
-int fixed_hash_table_add_key(FixedHashTable* table, KEY_TYPE key)
+template <typename Preset, typename Preset::hash_fn* Hash>
+int fixed_hash_table_add_key(FixedHashTable<Preset, Hash>* table,
+                             typename Preset::key_type key)
 {
     SAFE_BLOCK_START
     {
@@ -112,8 +136,10 @@ int fixed_hash_table_add_key(FixedHashTable* table, KEY_TYPE key)
     }
     SAFE_BLOCK_END
 
-    size_t key_hash = HASH_FUNCTION(key) % table->bucket_count;
-    FixedHashTableEntry* key_entry = find_parent_node(table, key, key_hash)->next;
+    TRACER_OP(TRACER_EVENT_INSERT, "fixed", table->distinct_count);
+
+    size_t key_hash = Hash(key) % table->bucket_count;
+    auto* key_entry = find_parent_node(table, key, key_hash)->next;
 
     if (key_entry)
         return -1;
@@ -134,7 +160,7 @@ int fixed_hash_table_add_key(FixedHashTable* table, KEY_TYPE key)
     key_entry = table->free;
     table->free = table->free->next;
     
-    key_entry->key = KEY_COPY(key);
+    key_entry->key = Preset::copy(key);
     key_entry->next = table->buckets[key_hash].next;
     
     table->buckets[key_hash].next = key_entry;
@@ -143,60 +169,121 @@ int fixed_hash_table_add_key(FixedHashTable* table, KEY_TYPE key)
     return 0;
 }
 
-int fixed_hash_table_has_key(const FixedHashTable* table, KEY_TYPE key)
+template <typename Preset, typename Preset::hash_fn* Hash>
+int fixed_hash_table_has_key(const FixedHashTable<Preset, Hash>* table,
+                             typename Preset::key_type key)
 {
     /* If there is no table, it does not contain any keys */
     if (!table || !table->buckets) return 0;
+    TRACER_OP(TRACER_EVENT_CONTAINS, "fixed", table->distinct_count);
 
-    size_t key_hash = HASH_FUNCTION(key) % table->bucket_count;
+    size_t key_hash = Hash(key) % table->bucket_count;
 
-    FixedHashTableEntry* key_entry =
-        find_parent_node(table, key, key_hash)->next;
+    auto* key_entry = find_parent_node(table, key, key_hash)->next;
 
     return !!key_entry;
 }
 
-static FixedHashTableEntry* find_parent_node(const FixedHashTable* table,
-                                            KEY_TYPE key, uint64_t key_hash)
+template <typename Preset, typename Preset::hash_fn* Hash>
+static typename FixedHashTable<Preset, Hash>::entry_type* find_parent_node(
+                                    const FixedHashTable<Preset, Hash>* table,
+                                    typename Preset::key_type key,
+                                    uint64_t key_hash)
 {
-    FixedHashTableEntry* lst_entry = &table->buckets[key_hash];
-    FixedHashTableEntry* key_entry = lst_entry->next;
+    auto* lst_entry = &table->buckets[key_hash];
+    auto* key_entry = lst_entry->next;
 
-    while (key_entry && !KEY_EQUAL(key_entry->key, key))
+#ifdef HASH_TABLE_STATS
+    size_t length = 0;
+#endif
+
+    while (key_entry && !Preset::equal(key_entry->key, key))
     {
         lst_entry = key_entry;
         key_entry = lst_entry->next;
+#ifdef HASH_TABLE_STATS
+        ++ length;
+#endif
     }
+
+#ifdef HASH_TABLE_STATS
+    /* Matching node is inspected as well */
+    table_stats_record_probe(&table->stats, key_entry ? length + 1 : length);
+#endif
+
     return lst_entry;
 }
 
-static void mark_free(FixedHashTableEntry* entries, size_t entry_count)
+template <typename Preset, typename Preset::hash_fn* Hash>
+int fixed_hash_table_get_stats(
+                [[maybe_unused]] const FixedHashTable<Preset, Hash>* table,
+                [[maybe_unused]] TableStats* stats)
+{
+#ifdef HASH_TABLE_STATS
+    if (!table || !table->buckets || !stats) return -1;
+
+    memset(stats, 0, sizeof(*stats));
+    table_stats_copy_counters(stats, &table->stats);
+
+    for (size_t i = 0; i < table->bucket_count; ++i)
+    {
+        size_t length = 0;
+        for (auto* entry = table->buckets[i].next; entry; entry = entry->next)
+            ++ length;
+
+        ++ stats->chain_lengths[table_stats_hist_index(length)];
+        if (length > 0 && length - 1 > stats->max_displacement)
+            stats->max_displacement = length - 1;
+    }
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+template <typename Entry>
+static void mark_free(Entry* entries, size_t entry_count)
 {
+    TRACER_BEGIN(trace_start_ns);
+
     for (size_t i = 0; i < entry_count; ++i)
     {
         entries[i].next = i + 1 < entry_count
                             ? entries + i + 1
                             : NULL;
     }
+
+    TRACER_END(trace_start_ns, TRACER_EVENT_MARK_FREE, "fixed", entry_count);
 }
 
 
-static int try_grow(FixedHashTable* table)
+template <typename Preset, typename Preset::hash_fn* Hash>
+static int try_grow(FixedHashTable<Preset, Hash>* table)
 {
+    typedef typename FixedHashTable<Preset, Hash>::entry_type entry_type;
+
     const size_t cap_growth = 2;
     if (table->free) return 0;
 
+#ifdef HASH_TABLE_STATS
+    const uint64_t start_ns = table_stats_now_ns();
+#endif
+    TRACER_BEGIN(trace_start_ns);
+
     const intptr_t old_addr = (intptr_t) table->buckets;
 
     const size_t old_cap = table->capacity;
     const size_t new_cap = old_cap * cap_growth;
-    FixedHashTableEntry* data = NULL;
+    entry_type* data = NULL;
 
     SAFE_BLOCK_START
     {
         ASSERT_SIMPLE(
-                data = (FixedHashTableEntry*)
-                        realloc(table->buckets, new_cap*sizeof(*data)),
+                data = (entry_type*)
+                        table_realloc(&table->allocator, table->buckets,
+                                      old_cap*sizeof(*data),
+                                      new_cap*sizeof(*data)),
                 action_result != NULL);
     }
     SAFE_BLOCK_HANDLE_ERRORS
@@ -213,7 +300,7 @@ static int try_grow(FixedHashTable* table)
     if (addr_offset)
         for (size_t i = 0; i < old_cap; ++i)
             if (data[i].next)
-                data[i].next = (FixedHashTableEntry*)
+                data[i].next = (entry_type*)
                                     ((intptr_t)data[i].next + addr_offset);
 
     mark_free(data + old_cap, new_cap - old_cap);
@@ -222,5 +309,27 @@ static int try_grow(FixedHashTable* table)
     table->free = data + old_cap;
     table->capacity = new_cap;
 
+#ifdef HASH_TABLE_STATS
+    table_stats_record_rehash(&table->stats, start_ns);
+#endif
+
+    TRACER_END(trace_start_ns, TRACER_EVENT_GROW, "fixed", new_cap);
+
     return 0;
 }
+
+#define INSTANTIATE_FIXED_HASH_TABLE(preset, hash)                          \
+    template int fixed_hash_table_ctor    (FixedHashTable<preset, hash>*,  \
+                                           size_t,                         \
+                                           const TableAllocator*);         \
+    template int fixed_hash_table_dtor    (FixedHashTable<preset, hash>*); \
+    template int fixed_hash_table_add_key (FixedHashTable<preset, hash>*,  \
+                                           preset::key_type);              \
+    template int fixed_hash_table_has_key (                                \
+                                    const FixedHashTable<preset, hash>*,   \
+                                    preset::key_type);                     \
+    template int fixed_hash_table_get_stats (                              \
+                                    const FixedHashTable<preset, hash>*,   \
+                                    TableStats*);
+
+FOR_EACH_HASH_PRESET(INSTANTIATE_FIXED_HASH_TABLE)
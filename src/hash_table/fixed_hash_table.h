@@ -14,39 +14,76 @@
 
 #include <stddef.h>
 
-#ifndef HASH_PRESET
-#define HASH_PRESET "presets/hash_int.h"
-#endif
-
-#include HASH_PRESET
-
-struct FixedHashTableEntry;
+#include "presets/hash_presets.h"
+#include "table_allocator.h"
+#include "table_stats.h"
 
+template <typename Key>
 struct FixedHashTableEntry
 {
-    KEY_TYPE key;
+    Key key;
 
     FixedHashTableEntry* next;
 };
 
+/**
+ * @brief Hash table with fixed bucket count. Every combination of `Preset`
+ * and `Hash` listed in `FOR_EACH_HASH_PRESET` is instantiated.
+ *
+ * @tparam Preset   - Key type and key operations
+ * @tparam Hash     - Hash function
+ */
+template <typename Preset, typename Preset::hash_fn* Hash>
 struct FixedHashTable
 {
-    FixedHashTableEntry* buckets;
+    typedef typename Preset::key_type key_type;
+    typedef FixedHashTableEntry<key_type> entry_type;
+
+    entry_type* buckets;
     size_t bucket_count;
 
-    FixedHashTableEntry* free;
+    entry_type* free;
 
     size_t capacity;
     size_t distinct_count;
+
+    TableAllocator allocator;
+
+#ifdef HASH_TABLE_STATS
+    /* Lookups through const table are counted too */
+    mutable TableStatsCounters stats;
+#endif
 };
 
-int fixed_hash_table_ctor      (FixedHashTable* table, size_t bucket_count);
+/**
+ * @brief Construct empty table. Entry pool is allocated by `allocator`, or
+ * by `TABLE_DEFAULT_ALLOCATOR` if it is NULL.
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+template <typename Preset, typename Preset::hash_fn* Hash>
+int fixed_hash_table_ctor      (FixedHashTable<Preset, Hash>* table,
+                                size_t bucket_count,
+                                const TableAllocator* allocator = NULL);
 
-int fixed_hash_table_dtor      (FixedHashTable* table);
+template <typename Preset, typename Preset::hash_fn* Hash>
+int fixed_hash_table_dtor      (FixedHashTable<Preset, Hash>* table);
 
-int fixed_hash_table_add_key   (FixedHashTable* table, KEY_TYPE key);
+template <typename Preset, typename Preset::hash_fn* Hash>
+int fixed_hash_table_add_key   (FixedHashTable<Preset, Hash>* table,
+                                typename Preset::key_type key);
 
-int fixed_hash_table_has_key   (const FixedHashTable* table, KEY_TYPE key);
+template <typename Preset, typename Preset::hash_fn* Hash>
+int fixed_hash_table_has_key   (const FixedHashTable<Preset, Hash>* table,
+                                typename Preset::key_type key);
 
-#endif /* fixed_hash_table.h */
+/**
+ * @brief Get table statistics. Rehashes are growths of entry pool.
+ *
+ * @return 0 upon success, -1 if table is invalid or statistics are disabled
+ */
+template <typename Preset, typename Preset::hash_fn* Hash>
+int fixed_hash_table_get_stats (const FixedHashTable<Preset, Hash>* table,
+                                TableStats* stats);
 
+#endif /* fixed_hash_table.h */
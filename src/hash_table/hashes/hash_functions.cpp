@@ -1,4 +1,6 @@
 #include <string.h>
+#include <time.h>
+#include <sys/random.h>
 
 #include "hash_functions.h"
 
@@ -191,3 +193,125 @@ uint64_t hash_str_crc64(const char* value)
 		crc = crc_table[(crc ^ (uint64_t) *(value++)) & 0xff] ^ (crc >> 8);
     return ~crc;
 }
+
+__always_inline
+static uint64_t rotl(uint64_t x, unsigned bits)
+{
+    return (x << bits) | (x >> (64 - bits));
+}
+
+struct SipState
+{
+    uint64_t v0, v1, v2, v3;
+};
+
+__always_inline
+static void sip_round(SipState* s)
+{
+    s->v0 += s->v1; s->v1 = rotl(s->v1, 13); s->v1 ^= s->v0;
+    s->v0 = rotl(s->v0, 32);
+    s->v2 += s->v3; s->v3 = rotl(s->v3, 16); s->v3 ^= s->v2;
+    s->v0 += s->v3; s->v3 = rotl(s->v3, 21); s->v3 ^= s->v0;
+    s->v2 += s->v1; s->v1 = rotl(s->v1, 17); s->v1 ^= s->v2;
+    s->v2 = rotl(s->v2, 32);
+}
+
+__always_inline
+static SipState sip_init(const uint64_t key[2])
+{
+    return {
+        .v0 = key[0] ^ 0x736f6d6570736575,
+        .v1 = key[1] ^ 0x646f72616e646f6d,
+        .v2 = key[0] ^ 0x6c7967656e657261,
+        .v3 = key[1] ^ 0x7465646279746573
+    };
+}
+
+/* SipHash-1-3: one compression round per block, three finalization rounds */
+__always_inline
+static void sip_compress(SipState* s, uint64_t block)
+{
+    s->v3 ^= block;
+    sip_round(s);
+    s->v0 ^= block;
+}
+
+__always_inline
+static uint64_t sip_finalize(SipState* s)
+{
+    s->v2 ^= 0xff;
+    sip_round(s);
+    sip_round(s);
+    sip_round(s);
+    return s->v0 ^ s->v1 ^ s->v2 ^ s->v3;
+}
+
+uint64_t hash_siphash13(const void* data, size_t length, const uint64_t key[2])
+{
+    const uint8_t* bytes = (const uint8_t*) data;
+    SipState state = sip_init(key);
+
+    const size_t full_blocks = length / sizeof(uint64_t);
+    for (size_t i = 0; i < full_blocks; ++i)
+    {
+        uint64_t block = 0;
+        memcpy(&block, bytes + i * sizeof(block), sizeof(block));
+        sip_compress(&state, block);
+    }
+
+    uint64_t last = length << 56;
+    const uint8_t* tail = bytes + full_blocks * sizeof(uint64_t);
+    for (size_t i = 0; i < length % sizeof(uint64_t); ++i)
+        last |= (uint64_t) tail[i] << (8 * i);
+    sip_compress(&state, last);
+
+    return sip_finalize(&state);
+}
+
+uint64_t hash_siphash13_u64(uint64_t value, const uint64_t key[2])
+{
+    SipState state = sip_init(key);
+    sip_compress(&state, value);
+    sip_compress(&state, sizeof(value) << 56);
+    return sip_finalize(&state);
+}
+
+/* Entropy drawn once per thread: seeds are SipHash of counter under it */
+struct SeedSource
+{
+    uint64_t key[2];
+    uint64_t counter;
+    bool ready;
+};
+
+static thread_local SeedSource seed_source;
+
+static void draw_entropy(uint64_t seed[2])
+{
+    if (getrandom(seed, 2 * sizeof(*seed), GRND_NONBLOCK)
+            == (ssize_t) (2 * sizeof(*seed)))
+        return;
+
+    /* Entropy pool unavailable: fall back to clock and address bits */
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const uint64_t stack_addr = (uintptr_t) &now;
+    const uint64_t entropy[2] = {
+        (uint64_t) now.tv_nsec ^ stack_addr,
+        (uint64_t) now.tv_sec  ^ (uintptr_t) seed
+    };
+    seed[0] = hash_siphash13_u64(entropy[0], entropy);
+    seed[1] = hash_siphash13_u64(entropy[1], entropy);
+}
+
+void hash_random_seed(uint64_t seed[2])
+{
+    if (!seed_source.ready)
+    {
+        draw_entropy(seed_source.key);
+        seed_source.ready = true;
+    }
+
+    seed[0] = hash_siphash13_u64(seed_source.counter++, seed_source.key);
+    seed[1] = hash_siphash13_u64(seed_source.counter++, seed_source.key);
+}
@@ -13,6 +13,7 @@
 #define __HASH_FUNCTIONS_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 uint64_t hash_int_identity      (int32_t value);
 uint64_t hash_int_multiplicative(int32_t value);
@@ -25,4 +26,36 @@ uint64_t hash_str_sum_char  (const char* value);
 uint64_t hash_str_polynome  (const char* value);
 uint64_t hash_str_crc64     (const char* value);
 
+/**
+ * @brief SipHash-1-3 of byte sequence keyed with 128-bit key
+ *
+ * @param[in] data      - Bytes to be hashed
+ * @param[in] length    - Length of `data`
+ * @param[in] key       - Secret key
+ *
+ * @return Hash value
+ */
+uint64_t hash_siphash13     (const void* data, size_t length,
+                             const uint64_t key[2]);
+
+/**
+ * @brief SipHash-1-3 of single 64-bit integer, equivalent to hashing
+ * its little-endian byte representation with `hash_siphash13`
+ *
+ * @param[in] value     - Value to be hashed
+ * @param[in] key       - Secret key
+ *
+ * @return Hash value
+ */
+uint64_t hash_siphash13_u64 (uint64_t value, const uint64_t key[2]);
+
+/**
+ * @brief Generate random 128-bit seed for keyed hash functions. Entropy is
+ * requested from OS once per thread, and seeds are derived from it by
+ * SipHash of a counter, so that generating seed takes no system calls.
+ *
+ * @param[out] seed - Generated seed
+ */
+void hash_random_seed(uint64_t seed[2]);
+
 #endif /* hash_functions.h */
@@ -0,0 +1,104 @@
+/**
+ * @file table_hash.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Bucket index computation shared by dynamic hash tables
+ *
+ * @version 0.1
+ * @date 2023-05-20
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_HASHES_TABLE_HASH_H
+#define __HASH_TABLE_HASHES_TABLE_HASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "hash_functions.h"
+
+enum table_hash
+{
+    /** Unseeded Fibonacci hashing, deterministic across runs */
+    TABLE_HASH_FIBONACCI        = 0,
+    /** Fibonacci hashing of key mixed with per-table random seed */
+    TABLE_HASH_FIBONACCI_SEEDED = 1,
+    /** SipHash-1-3 keyed with per-table random seed */
+    TABLE_HASH_SIPHASH          = 2,
+    /** Low bits of key, keeps clusters of sequential keys */
+    TABLE_HASH_IDENTITY         = 3,
+};
+
+static const char* const TABLE_HASH_NAMES[] = {
+    "fibonacci",
+    "fibonacci_seeded",
+    "siphash13",
+    "identity",
+};
+static const size_t TABLE_HASH_COUNT =
+                        sizeof(TABLE_HASH_NAMES) / sizeof(*TABLE_HASH_NAMES);
+
+struct TableHashState
+{
+    table_hash kind;
+    uint64_t seed[2];
+};
+
+// As per Donald E. Knuth "The Art of Computer Programming" vol 3 ed. 2
+// section 6.4
+// ~= 2^64 / phi
+static const uint64_t fib_constant = 11400714819323198485llu;
+
+__always_inline
+static size_t fibonacci_hash(uint64_t key, size_t size_exp)
+{
+    const size_t shift = 64 - size_exp;
+    key ^= key >> shift;
+    return (fib_constant * key) >> shift;
+}
+
+/**
+ * @brief Initialize hash state. Fresh random seed is drawn only for seeded
+ * hash functions.
+ *
+ * @param[out] state - Hash state
+ * @param[in]  kind  - Hash function used for key indexing
+ */
+__always_inline
+static void table_hash_init(TableHashState* state, table_hash kind)
+{
+    state->kind = kind;
+    state->seed[0] = state->seed[1] = 0;
+
+    if (kind == TABLE_HASH_FIBONACCI_SEEDED || kind == TABLE_HASH_SIPHASH)
+        hash_random_seed(state->seed);
+}
+
+/**
+ * @brief Get bucket index of key in table of size `2^size_exp`
+ *
+ * @param[in] state     - Hash state of table
+ * @param[in] key       - Key to be hashed
+ * @param[in] size_exp  - Base 2 logarithm of table size
+ *
+ * @return Bucket index
+ */
+__always_inline
+static size_t table_hash_index(const TableHashState* state,
+                               uint64_t key, size_t size_exp)
+{
+    switch (state->kind)
+    {
+    case TABLE_HASH_FIBONACCI_SEEDED:
+        return fibonacci_hash(key ^ state->seed[0], size_exp);
+    case TABLE_HASH_SIPHASH:
+        return hash_siphash13_u64(key, state->seed) >> (64 - size_exp);
+    case TABLE_HASH_IDENTITY:
+        return key & ((1lu << size_exp) - 1);
+    case TABLE_HASH_FIBONACCI:
+    default:
+        return fibonacci_hash(key, size_exp);
+    }
+}
+
+#endif /* table_hash.h */
@@ -0,0 +1,378 @@
+#include "hopscotch_hash_table.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashes/table_hash.h"
+#include "table_tuner.h"
+#include "tracer.h"
+
+static const size_t default_size = 1024;
+static const size_t default_size_exp = 10;
+static const double fill_factor = 0.9;
+
+/* Free slot is searched this far from home before growing table */
+static const size_t max_free_distance = 512;
+
+/* Keys, which do not fit after table is grown, are rehashed this many times
+ * with fresh hash seeds before insertion fails */
+static const size_t max_reseed_count = 8;
+
+static const size_t not_found = SIZE_MAX;
+
+static_assert(HOPSCOTCH_NEIGHBORHOOD
+                    == 8 * sizeof(((HopscotchHashTableEntry*) NULL)->hop),
+              "Hop bitmap must cover whole neighborhood");
+
+__always_inline
+static size_t occupied_words(size_t size)
+{
+    return (size + 63) / 64;
+}
+
+__always_inline
+static int is_occupied(const HopscotchHashTable* table, size_t index)
+{
+    return (int) ((table->occupied[index / 64] >> (index % 64)) & 1);
+}
+
+__always_inline
+static void set_occupied(HopscotchHashTable* table, size_t index)
+{
+    table->occupied[index / 64] |= 1lu << (index % 64);
+}
+
+__always_inline
+static void clear_occupied(HopscotchHashTable* table, size_t index)
+{
+    table->occupied[index / 64] &= ~(1lu << (index % 64));
+}
+
+static size_t find_key(HopscotchHashTable* table, uint32_t key, size_t home);
+static int place_key(HopscotchHashTable* table, uint32_t key);
+static int fill_table(HopscotchHashTable* table, HopscotchHashTable* new_table);
+static int rehash(HopscotchHashTable* table, size_t size_exp,
+                  const TableHashState* hash);
+
+void hopscotch_hash_table_ctor(HopscotchHashTable* table, table_hash hash,
+                               const TableAllocator* allocator)
+{
+    if (!table) return;
+
+    table->allocator = allocator ? *allocator : TABLE_DEFAULT_ALLOCATOR;
+    table->data = (HopscotchHashTableEntry*)
+                    table_alloc(&table->allocator,
+                                default_size * sizeof(*table->data));
+    table->occupied = (uint64_t*)
+                    table_alloc(&table->allocator,
+                                occupied_words(default_size)
+                                            * sizeof(*table->occupied));
+    table->size = default_size;
+    table->size_exp = default_size_exp;
+    table->distinct_count = 0;
+    table_hash_init(&table->hash, hash);
+    table->rehash_count = 0;
+
+    /* Table without slot array is left unconstructed */
+    if (!table->data || !table->occupied)
+    {
+        hopscotch_hash_table_dtor(table);
+        return;
+    }
+
+#ifdef HASH_TABLE_STATS
+    table->stats = {};
+#endif
+}
+
+void hopscotch_hash_table_dtor(HopscotchHashTable* table)
+{
+    if (!table) return;
+    table_free(&table->allocator, table->data,
+               table->size * sizeof(*table->data));
+    table_free(&table->allocator, table->occupied,
+               occupied_words(table->size) * sizeof(*table->occupied));
+    memset(table, 0, sizeof(*table));
+}
+
+int hopscotch_hash_table_insert(HopscotchHashTable* table, uint32_t key)
+{
+    if (!table || !table->data) return -1;
+    TRACER_OP(TRACER_EVENT_INSERT, "hopscotch", table->distinct_count);
+
+    const size_t home = table_hash_index(&table->hash, key, table->size_exp);
+    if (find_key(table, key, home) != not_found)
+        return -1;
+
+    /* If key does not fit after table is doubled, it shares home slot with
+     * too many keys under current hash, which further growth does not fix */
+    for (size_t attempt = 0; place_key(table, key) < 0; ++attempt)
+    {
+        if (attempt > max_reseed_count)
+            return -1;
+
+        TableHashState hash = table->hash;
+        size_t size_exp = table->size_exp;
+        if (attempt == 0)
+            ++ size_exp;
+        else
+            table_hash_init(&hash, table_tuner_stronger_hash(hash.kind));
+
+        if (rehash(table, size_exp, &hash) < 0)
+            return -1;
+    }
+
+    ++ table->distinct_count;
+
+    if (fill_factor*(double)table->size > (double) table->distinct_count)
+        return 0;
+
+    return rehash(table, table->size_exp + 1, &table->hash);
+}
+
+int hopscotch_hash_table_erase(HopscotchHashTable* table, uint32_t key)
+{
+    if (!table || !table->data) return -1;
+    TRACER_OP(TRACER_EVENT_ERASE, "hopscotch", table->distinct_count);
+
+    const size_t home = table_hash_index(&table->hash, key, table->size_exp);
+    const size_t index = find_key(table, key, home);
+    if (index == not_found)
+        return -1;
+
+    const size_t offset = (index - home) & (table->size - 1);
+    table->data[home].hop &= ~(1u << offset);
+    table->data[index].key = 0;
+    clear_occupied(table, index);
+    -- table->distinct_count;
+
+    return 0;
+}
+
+int hopscotch_hash_table_contains(HopscotchHashTable* table, uint32_t key)
+{
+    if (!table || !table->data) return 0;
+    TRACER_OP(TRACER_EVENT_CONTAINS, "hopscotch", table->distinct_count);
+
+    const size_t home = table_hash_index(&table->hash, key, table->size_exp);
+
+    return find_key(table, key, home) != not_found;
+}
+
+int hopscotch_hash_table_get_stats(
+                            [[maybe_unused]] const HopscotchHashTable* table,
+                            [[maybe_unused]] TableStats* stats)
+{
+#ifdef HASH_TABLE_STATS
+    if (!table || !table->data || !stats) return -1;
+
+    memset(stats, 0, sizeof(*stats));
+    table_stats_copy_counters(stats, &table->stats);
+
+    for (size_t i = 0; i < table->size; ++i)
+    {
+        const uint32_t hop = table->data[i].hop;
+        if (!hop)
+            continue;
+
+        const size_t keys = (size_t) __builtin_popcount(hop);
+        ++ stats->chain_lengths[table_stats_hist_index(keys)];
+
+        const size_t displacement = 31 - (size_t) __builtin_clz(hop);
+        if (displacement > stats->max_displacement)
+            stats->max_displacement = displacement;
+    }
+
+    /* Erased slots are freed at once */
+    stats->tombstone_ratio = 0;
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief Find key among slots marked in hop bitmap of its home slot
+ *
+ * @return Index of key slot, `not_found` if key is absent
+ */
+static size_t find_key(HopscotchHashTable* table, uint32_t key, size_t home)
+{
+    const size_t mask = table->size - 1;
+    uint32_t hop = table->data[home].hop;
+    [[maybe_unused]] size_t probes = 0;
+
+    while (hop)
+    {
+        const size_t index = (home + (size_t) __builtin_ctz(hop)) & mask;
+        ++ probes;
+
+        if (table->data[index].key == key)
+        {
+#ifdef HASH_TABLE_STATS
+            table_stats_record_probe(&table->stats, probes);
+#endif
+            return index;
+        }
+
+        hop &= hop - 1;
+    }
+
+#ifdef HASH_TABLE_STATS
+    table_stats_record_probe(&table->stats, probes);
+#endif
+
+    return not_found;
+}
+
+/**
+ * @brief Put absent key into neighborhood of its home slot, moving other
+ * keys within their neighborhoods if needed
+ *
+ * @return 0 upon success, -1 if table must be grown
+ */
+static int place_key(HopscotchHashTable* table, uint32_t key)
+{
+    const size_t mask = table->size - 1;
+    const size_t home = table_hash_index(&table->hash, key, table->size_exp);
+
+    size_t free_slot = home;
+    size_t distance = 0;
+    while (is_occupied(table, free_slot))
+    {
+        if (++ distance >= max_free_distance || distance >= table->size)
+            return -1;
+        free_slot = (free_slot + 1) & mask;
+    }
+
+    /* Free slot is moved towards home by swapping it with key, whose home
+     * is farthest from it, but whose neighborhood still covers it */
+    while (distance >= HOPSCOTCH_NEIGHBORHOOD)
+    {
+        size_t back = HOPSCOTCH_NEIGHBORHOOD - 1;
+        for (; back > 0; --back)
+        {
+            const size_t candidate = (free_slot - back) & mask;
+            const uint32_t before_free =
+                            table->data[candidate].hop & ((1u << back) - 1);
+            if (!before_free)
+                continue;
+
+            const size_t offset = (size_t) __builtin_ctz(before_free);
+            const size_t from = (candidate + offset) & mask;
+
+            table->data[free_slot].key = table->data[from].key;
+            table->data[candidate].hop ^= (1u << offset) | (1u << back);
+            set_occupied(table, free_slot);
+            clear_occupied(table, from);
+
+            free_slot = from;
+            distance -= back - offset;
+            break;
+        }
+
+        if (back == 0)
+            return -1;
+    }
+
+    table->data[free_slot].key = key;
+    table->data[home].hop |= 1u << distance;
+    set_occupied(table, free_slot);
+
+    return 0;
+}
+
+/**
+ * @brief Allocate arrays of `new_table` and move all keys of `table` into it
+ *
+ * @return 0 upon success, 1 if some key did not fit into its neighborhood,
+ * -1 if allocation failed
+ */
+static int fill_table(HopscotchHashTable* table, HopscotchHashTable* new_table)
+{
+    new_table->data = (HopscotchHashTableEntry*)
+                table_alloc(&table->allocator,
+                            new_table->size * sizeof(*new_table->data));
+    new_table->occupied = (uint64_t*)
+                table_alloc(&table->allocator,
+                            occupied_words(new_table->size)
+                                        * sizeof(*new_table->occupied));
+    if (!new_table->data || !new_table->occupied)
+    {
+        hopscotch_hash_table_dtor(new_table);
+        return -1;
+    }
+
+    for (size_t home = 0; home < table->size; ++home)
+    {
+        for (uint32_t hop = table->data[home].hop; hop; hop &= hop - 1)
+        {
+            const size_t index = (home + (size_t) __builtin_ctz(hop))
+                                                    & (table->size - 1);
+            if (place_key(new_table, table->data[index].key) == 0)
+                continue;
+
+            table_free(&table->allocator, new_table->data,
+                       new_table->size * sizeof(*new_table->data));
+            table_free(&table->allocator, new_table->occupied,
+                       occupied_words(new_table->size)
+                                        * sizeof(*new_table->occupied));
+            new_table->data = NULL;
+            new_table->occupied = NULL;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Move all keys into table of size `2^size_exp` with given hash. If
+ * keys do not fit into their neighborhoods, table of the same size is
+ * retried with freshly seeded stronger hash.
+ */
+static int rehash(HopscotchHashTable* table, size_t size_exp,
+                  const TableHashState* hash)
+{
+#ifdef HASH_TABLE_STATS
+    const uint64_t start_ns = table_stats_now_ns();
+#endif
+    TRACER_BEGIN(trace_start_ns);
+
+    HopscotchHashTable new_table = {};
+    new_table.size = 1lu << size_exp;
+    new_table.size_exp = size_exp;
+    new_table.hash = *hash;
+    new_table.allocator = table->allocator;
+
+    int status = fill_table(table, &new_table);
+    for (size_t attempt = 0; status > 0 && attempt < max_reseed_count;
+            ++attempt)
+    {
+        table_hash_init(&new_table.hash,
+                        table_tuner_stronger_hash(new_table.hash.kind));
+        status = fill_table(table, &new_table);
+    }
+
+    if (status != 0)
+        return -1;
+
+    new_table.distinct_count = table->distinct_count;
+    new_table.rehash_count = table->rehash_count + 1;
+
+#ifdef HASH_TABLE_STATS
+    new_table.stats = table->stats;
+#endif
+
+    hopscotch_hash_table_dtor(table);
+    *table = new_table;
+
+#ifdef HASH_TABLE_STATS
+    table_stats_record_rehash(&table->stats, start_ns);
+#endif
+
+    TRACER_END(trace_start_ns, TRACER_EVENT_REHASH, "hopscotch", table->size);
+
+    return 0;
+}
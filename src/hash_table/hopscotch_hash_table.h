@@ -0,0 +1,84 @@
+/**
+ * @file hopscotch_hash_table.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Open addressing hash table with hopscotch displacement
+ *
+ * Every key is kept within `HOPSCOTCH_NEIGHBORHOOD` slots after its home
+ * slot. Home slot stores bitmap of occupied slots of its neighborhood, which
+ * hold keys with this home, so lookup checks only those slots instead of
+ * probing a cluster. Insertion takes first free slot after home and moves
+ * it closer by swapping it with keys, which stay in their own neighborhoods.
+ * If no key can be moved, table is grown. If key still does not fit, it
+ * shares home slot with too many keys, so table is rehashed at the same size
+ * with freshly seeded stronger hash. Erased slots are freed at once, as no
+ * probe sequence passes through them.
+ *
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_HOPSCOTCH_HASH_TABLE_H
+#define __HASH_TABLE_HOPSCOTCH_HASH_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "hashes/table_hash.h"
+#include "table_allocator.h"
+#include "table_stats.h"
+
+static const size_t HOPSCOTCH_NEIGHBORHOOD = 32;
+
+struct HopscotchHashTableEntry
+{
+    uint32_t key;
+    /** Bit `i` is set if slot `i` after this one holds key with this home */
+    uint32_t hop;
+};
+
+struct HopscotchHashTable
+{
+    HopscotchHashTableEntry* data;
+    /** Bitmap of occupied slots */
+    uint64_t* occupied;
+
+    size_t size_exp;
+    size_t size;
+    size_t distinct_count;
+
+    TableHashState hash;
+
+    /** Rehashes since construction, including ones at the same size */
+    size_t rehash_count;
+
+    TableAllocator allocator;
+
+#ifdef HASH_TABLE_STATS
+    TableStatsCounters stats;
+#endif
+};
+
+/**
+ * @brief Construct empty table. Arrays are allocated by `allocator`,
+ * or by `TABLE_DEFAULT_ALLOCATOR` if it is NULL.
+ */
+void hopscotch_hash_table_ctor    (HopscotchHashTable* table,
+                                   table_hash hash = TABLE_HASH_FIBONACCI,
+                                   const TableAllocator* allocator = NULL);
+void hopscotch_hash_table_dtor    (HopscotchHashTable* table);
+int  hopscotch_hash_table_insert  (HopscotchHashTable* table, uint32_t key);
+int  hopscotch_hash_table_erase   (HopscotchHashTable* table, uint32_t key);
+int  hopscotch_hash_table_contains(HopscotchHashTable* table, uint32_t key);
+
+/**
+ * @brief Get table statistics. Chain lengths are numbers of keys in
+ * neighborhoods of home slots.
+ *
+ * @return 0 upon success, -1 if table is invalid or statistics are disabled
+ */
+int  hopscotch_hash_table_get_stats(const HopscotchHashTable* table,
+                                    TableStats* stats);
+
+#endif /* hopscotch_hash_table.h */
@@ -0,0 +1,559 @@
+#include "hybrid_set.h"
+
+#include <string.h>
+
+#include "tracer.h"
+
+static const size_t chunk_bits = 16;
+static const uint32_t low_mask = (1u << chunk_bits) - 1;
+static const size_t bitmap_words = (1lu << chunk_bits) / 64;
+static const size_t bitmap_bytes = bitmap_words * sizeof(uint64_t);
+
+/* Array of this many keys takes as much as bitmap */
+static const uint32_t array_max_count = (uint32_t) (bitmap_bytes
+                                                    / sizeof(uint16_t));
+/* Bitmap is not turned back into array at once, so that keys erased and
+ * inserted around the limit do not convert chunk every time */
+static const uint32_t bitmap_min_count = array_max_count / 2;
+static const size_t array_min_capacity = 4;
+static const size_t directory_min_capacity = 4;
+
+/* Hash table turns into chunks at this many keys per chunk, where they are
+ * mostly bitmaps, as binary search in full arrays is slower than hash table
+ * lookup. Chunks return to hash table below the other limit. */
+static const size_t dense_chunk_keys = 2 * (size_t) array_max_count;
+static const size_t sparse_chunk_keys = dense_chunk_keys / 8;
+static const size_t min_check_keys = dense_chunk_keys;
+
+static_assert(min_check_keys > INLINE_KEYS_CAPACITY,
+              "Keys are counted only in slot array of hash table");
+
+static const size_t not_found = SIZE_MAX;
+
+static size_t find_chunk(const HybridSet* set, uint32_t high);
+static size_t chunk_lower_bound(const HybridSet* set, uint32_t high);
+static size_t array_lower_bound(const HybridSetChunk* chunk, uint16_t low);
+
+static int chunk_insert(HybridSet* set, uint32_t key);
+static int chunk_erase(HybridSet* set, uint32_t key);
+static int add_chunk(HybridSet* set, size_t index, uint32_t high);
+static void remove_chunk(HybridSet* set, size_t index);
+static int array_to_bitmap(HybridSet* set, HybridSetChunk* chunk);
+static int bitmap_to_array(HybridSet* set, HybridSetChunk* chunk);
+static void free_chunks(HybridSet* set);
+
+static size_t count_table_chunks(const HybridSet* set);
+static int to_chunked(HybridSet* set);
+static int to_hash(HybridSet* set);
+
+__always_inline
+static int bitmap_test(const uint64_t* bitmap, uint32_t low)
+{
+    return (int) ((bitmap[low / 64] >> (low % 64)) & 1);
+}
+
+void hybrid_set_ctor(HybridSet* set, table_hash hash,
+                     const TableAllocator* allocator)
+{
+    if (!set) return;
+
+    set->allocator = allocator ? *allocator : TABLE_DEFAULT_ALLOCATOR;
+    set->mode = HYBRID_SET_HASH;
+    set->key_count = 0;
+    set->hash = hash;
+    open_addr_hash_table_ctor(&set->table, hash, &set->allocator);
+
+    set->chunks = NULL;
+    set->chunk_count = 0;
+    set->chunk_capacity = 0;
+    set->container_bytes = 0;
+    set->next_check = min_check_keys;
+    set->rehash_count = 0;
+}
+
+void hybrid_set_dtor(HybridSet* set)
+{
+    if (!set) return;
+
+    open_addr_hash_table_dtor(&set->table);
+    free_chunks(set);
+    memset(set, 0, sizeof(*set));
+}
+
+int hybrid_set_insert(HybridSet* set, uint32_t key)
+{
+    if (!set) return -1;
+
+    if (set->mode == HYBRID_SET_CHUNKED)
+    {
+        const size_t chunk_count = set->chunk_count;
+        if (chunk_insert(set, key) < 0)
+            return -1;
+
+        /* New chunk may make set sparse */
+        if (set->chunk_count > chunk_count
+                && set->key_count < sparse_chunk_keys * set->chunk_count)
+            return to_hash(set);
+
+        return 0;
+    }
+
+    if (open_addr_hash_table_insert(&set->table, key) < 0)
+        return -1;
+    ++ set->key_count;
+
+    /* Chunks are counted by scanning table, so that it is done as rarely
+     * as table is rehashed */
+    if (set->key_count < set->next_check)
+        return 0;
+    set->next_check = 2 * set->key_count;
+
+    const size_t chunks = count_table_chunks(set);
+    if (chunks != not_found && set->key_count >= dense_chunk_keys * chunks)
+        return to_chunked(set);
+
+    return 0;
+}
+
+int hybrid_set_erase(HybridSet* set, uint32_t key)
+{
+    if (!set) return -1;
+
+    if (set->mode == HYBRID_SET_HASH)
+    {
+        if (open_addr_hash_table_erase(&set->table, key) < 0)
+            return -1;
+        -- set->key_count;
+        return 0;
+    }
+
+    if (chunk_erase(set, key) < 0)
+        return -1;
+
+    if (set->key_count < sparse_chunk_keys * set->chunk_count)
+        return to_hash(set);
+
+    return 0;
+}
+
+int hybrid_set_contains(HybridSet* set, uint32_t key)
+{
+    if (!set) return 0;
+
+    if (set->mode == HYBRID_SET_HASH)
+        return open_addr_hash_table_contains(&set->table, key);
+
+    const size_t index = find_chunk(set, key >> chunk_bits);
+    if (index == not_found)
+        return 0;
+
+    const HybridSetChunk* chunk = set->chunks + index;
+    const uint16_t low = (uint16_t) (key & low_mask);
+
+    if (chunk->bitmap)
+        return bitmap_test(chunk->bitmap, low);
+
+    const size_t pos = array_lower_bound(chunk, low);
+    return pos < chunk->count && chunk->array[pos] == low;
+}
+
+size_t hybrid_set_footprint(const HybridSet* set)
+{
+    if (!set) return 0;
+
+    if (set->mode == HYBRID_SET_HASH)
+        return set->table.size * sizeof(*set->table.data);
+
+    return set->chunk_capacity * sizeof(*set->chunks) + set->container_bytes;
+}
+
+/**
+ * @brief Find chunk of keys with given upper bits. Chunks of dense ranges
+ * are consecutive, so chunk is first looked up by offset from first one.
+ *
+ * @return Chunk index, `not_found` if there is no such chunk
+ */
+static size_t find_chunk(const HybridSet* set, uint32_t high)
+{
+    if (set->chunk_count == 0)
+        return not_found;
+
+    const size_t offset = (size_t) (high - set->chunks[0].high);
+    if (offset < set->chunk_count && set->chunks[offset].high == high)
+        return offset;
+
+    const size_t index = chunk_lower_bound(set, high);
+    if (index < set->chunk_count && set->chunks[index].high == high)
+        return index;
+
+    return not_found;
+}
+
+/**
+ * @return Index of first chunk with upper bits not less than `high`
+ */
+static size_t chunk_lower_bound(const HybridSet* set, uint32_t high)
+{
+    size_t left = 0;
+    size_t right = set->chunk_count;
+
+    while (left < right)
+    {
+        const size_t mid = left + (right - left) / 2;
+        if (set->chunks[mid].high < high)
+            left = mid + 1;
+        else
+            right = mid;
+    }
+
+    return left;
+}
+
+/**
+ * @return Index of first array element not less than `low`
+ */
+static size_t array_lower_bound(const HybridSetChunk* chunk, uint16_t low)
+{
+    size_t left = 0;
+    size_t right = chunk->count;
+
+    while (left < right)
+    {
+        const size_t mid = left + (right - left) / 2;
+        if (chunk->array[mid] < low)
+            left = mid + 1;
+        else
+            right = mid;
+    }
+
+    return left;
+}
+
+static int chunk_insert(HybridSet* set, uint32_t key)
+{
+    const uint32_t high = key >> chunk_bits;
+    const uint16_t low = (uint16_t) (key & low_mask);
+
+    size_t index = find_chunk(set, high);
+    if (index == not_found)
+    {
+        index = chunk_lower_bound(set, high);
+        if (add_chunk(set, index, high) < 0)
+            return -1;
+    }
+
+    HybridSetChunk* chunk = set->chunks + index;
+
+    if (!chunk->bitmap && chunk->count == array_max_count)
+    {
+        const size_t pos = array_lower_bound(chunk, low);
+        if (pos < chunk->count && chunk->array[pos] == low)
+            return -1;
+        if (array_to_bitmap(set, chunk) < 0)
+            return -1;
+    }
+
+    if (chunk->bitmap)
+    {
+        if (bitmap_test(chunk->bitmap, low))
+            return -1;
+        chunk->bitmap[low / 64] |= 1lu << (low % 64);
+    }
+    else
+    {
+        const size_t pos = array_lower_bound(chunk, low);
+        if (pos < chunk->count && chunk->array[pos] == low)
+            return -1;
+
+        if (chunk->count == chunk->array_capacity)
+        {
+            const size_t capacity = 2 * chunk->array_capacity;
+            uint16_t* array = (uint16_t*)
+                    table_realloc(&set->allocator, chunk->array,
+                                  chunk->array_capacity * sizeof(*array),
+                                  capacity * sizeof(*array));
+            if (!array)
+                return -1;
+
+            set->container_bytes += (capacity - chunk->array_capacity)
+                                                    * sizeof(*array);
+            chunk->array = array;
+            chunk->array_capacity = capacity;
+        }
+
+        memmove(chunk->array + pos + 1, chunk->array + pos,
+                (chunk->count - pos) * sizeof(*chunk->array));
+        chunk->array[pos] = low;
+    }
+
+    ++ chunk->count;
+    ++ set->key_count;
+
+    return 0;
+}
+
+static int chunk_erase(HybridSet* set, uint32_t key)
+{
+    const size_t index = find_chunk(set, key >> chunk_bits);
+    if (index == not_found)
+        return -1;
+
+    HybridSetChunk* chunk = set->chunks + index;
+    const uint16_t low = (uint16_t) (key & low_mask);
+
+    if (chunk->bitmap)
+    {
+        if (!bitmap_test(chunk->bitmap, low))
+            return -1;
+        chunk->bitmap[low / 64] &= ~(1lu << (low % 64));
+    }
+    else
+    {
+        const size_t pos = array_lower_bound(chunk, low);
+        if (pos >= chunk->count || chunk->array[pos] != low)
+            return -1;
+
+        memmove(chunk->array + pos, chunk->array + pos + 1,
+                (chunk->count - pos - 1) * sizeof(*chunk->array));
+    }
+
+    -- chunk->count;
+    -- set->key_count;
+
+    if (chunk->count == 0)
+        remove_chunk(set, index);
+    else if (chunk->bitmap && chunk->count < bitmap_min_count)
+        /* Set stays correct if bitmap is kept */
+        bitmap_to_array(set, chunk);
+
+    return 0;
+}
+
+/**
+ * @brief Insert empty array chunk at `index` of directory
+ */
+static int add_chunk(HybridSet* set, size_t index, uint32_t high)
+{
+    if (set->chunk_count == set->chunk_capacity)
+    {
+        const size_t capacity = set->chunk_capacity
+                              ? 2 * set->chunk_capacity
+                              : directory_min_capacity;
+        HybridSetChunk* chunks = (HybridSetChunk*)
+                table_realloc(&set->allocator, set->chunks,
+                              set->chunk_capacity * sizeof(*chunks),
+                              capacity * sizeof(*chunks));
+        if (!chunks)
+            return -1;
+
+        set->chunks = chunks;
+        set->chunk_capacity = capacity;
+    }
+
+    uint16_t* array = (uint16_t*)
+                table_alloc(&set->allocator,
+                            array_min_capacity * sizeof(*array));
+    if (!array)
+        return -1;
+
+    memmove(set->chunks + index + 1, set->chunks + index,
+            (set->chunk_count - index) * sizeof(*set->chunks));
+    set->chunks[index] = {
+        .high = high,
+        .count = 0,
+        .array = array,
+        .array_capacity = array_min_capacity,
+        .bitmap = NULL
+    };
+
+    ++ set->chunk_count;
+    set->container_bytes += array_min_capacity * sizeof(*array);
+
+    return 0;
+}
+
+static void remove_chunk(HybridSet* set, size_t index)
+{
+    HybridSetChunk* chunk = set->chunks + index;
+
+    if (chunk->bitmap)
+    {
+        table_free(&set->allocator, chunk->bitmap, bitmap_bytes);
+        set->container_bytes -= bitmap_bytes;
+    }
+    else
+    {
+        table_free(&set->allocator, chunk->array,
+                   chunk->array_capacity * sizeof(*chunk->array));
+        set->container_bytes -= chunk->array_capacity
+                                        * sizeof(*chunk->array);
+    }
+
+    memmove(set->chunks + index, set->chunks + index + 1,
+            (set->chunk_count - index - 1) * sizeof(*set->chunks));
+    -- set->chunk_count;
+}
+
+static int array_to_bitmap(HybridSet* set, HybridSetChunk* chunk)
+{
+    uint64_t* bitmap = (uint64_t*) table_alloc(&set->allocator, bitmap_bytes);
+    if (!bitmap)
+        return -1;
+
+    for (size_t i = 0; i < chunk->count; ++i)
+        bitmap[chunk->array[i] / 64] |= 1lu << (chunk->array[i] % 64);
+
+    table_free(&set->allocator, chunk->array,
+               chunk->array_capacity * sizeof(*chunk->array));
+    set->container_bytes += bitmap_bytes
+                          - chunk->array_capacity * sizeof(*chunk->array);
+
+    chunk->array = NULL;
+    chunk->array_capacity = 0;
+    chunk->bitmap = bitmap;
+
+    return 0;
+}
+
+static int bitmap_to_array(HybridSet* set, HybridSetChunk* chunk)
+{
+    /* Array is left room to grow back to bitmap limit */
+    const size_t capacity = 2 * (size_t) chunk->count;
+    uint16_t* array = (uint16_t*)
+                table_alloc(&set->allocator, capacity * sizeof(*array));
+    if (!array)
+        return -1;
+
+    size_t count = 0;
+    for (size_t word = 0; word < bitmap_words; ++word)
+        for (uint64_t bits = chunk->bitmap[word]; bits; bits &= bits - 1)
+            array[count++] = (uint16_t) (64 * word
+                                         + (size_t) __builtin_ctzll(bits));
+
+    table_free(&set->allocator, chunk->bitmap, bitmap_bytes);
+    set->container_bytes += capacity * sizeof(*array) - bitmap_bytes;
+
+    chunk->bitmap = NULL;
+    chunk->array = array;
+    chunk->array_capacity = capacity;
+
+    return 0;
+}
+
+static void free_chunks(HybridSet* set)
+{
+    while (set->chunk_count > 0)
+        remove_chunk(set, set->chunk_count - 1);
+
+    table_free(&set->allocator, set->chunks,
+               set->chunk_capacity * sizeof(*set->chunks));
+    set->chunks = NULL;
+    set->chunk_capacity = 0;
+    set->container_bytes = 0;
+}
+
+/**
+ * @brief Count distinct upper 16 bits of keys in hash table
+ *
+ * @return Number of chunks, `not_found` if it cannot be counted
+ */
+static size_t count_table_chunks(const HybridSet* set)
+{
+    uint64_t* seen = (uint64_t*) table_alloc(&set->allocator, bitmap_bytes);
+    if (!seen)
+        return not_found;
+
+    size_t chunks = 0;
+    for (size_t i = 0; i < set->table.size; ++i)
+    {
+        if (set->table.data[i].status != NODE_OCCUPIED)
+            continue;
+
+        const uint32_t high = set->table.data[i].key >> chunk_bits;
+        if (bitmap_test(seen, high))
+            continue;
+
+        seen[high / 64] |= 1lu << (high % 64);
+        ++ chunks;
+    }
+
+    table_free(&set->allocator, seen, bitmap_bytes);
+    return chunks;
+}
+
+static int to_chunked(HybridSet* set)
+{
+    TRACER_BEGIN(trace_start_ns);
+
+    const size_t key_count = set->key_count;
+    set->key_count = 0;
+
+    int status = 0;
+    for (size_t i = 0; i < set->table.size && status == 0; ++i)
+        if (set->table.data[i].status == NODE_OCCUPIED)
+            status = chunk_insert(set, set->table.data[i].key);
+
+    if (status < 0)
+    {
+        /* Table is kept until chunks are complete */
+        free_chunks(set);
+        set->key_count = key_count;
+        return -1;
+    }
+
+    set->rehash_count += set->table.rehash_count + 1;
+    open_addr_hash_table_dtor(&set->table);
+    set->mode = HYBRID_SET_CHUNKED;
+
+    TRACER_END(trace_start_ns, TRACER_EVENT_REHASH, "hybrid",
+               set->chunk_count << chunk_bits);
+
+    return 0;
+}
+
+static int to_hash(HybridSet* set)
+{
+    TRACER_BEGIN(trace_start_ns);
+
+    open_addr_hash_table_ctor(&set->table, set->hash, &set->allocator);
+
+    int status = 0;
+    for (size_t i = 0; i < set->chunk_count; ++i)
+    {
+        const HybridSetChunk* chunk = set->chunks + i;
+        const uint32_t base = chunk->high << chunk_bits;
+
+        if (!chunk->bitmap)
+        {
+            for (size_t j = 0; j < chunk->count; ++j)
+                status |= open_addr_hash_table_insert(&set->table,
+                                                      base | chunk->array[j]);
+            continue;
+        }
+
+        for (size_t word = 0; word < bitmap_words; ++word)
+            for (uint64_t bits = chunk->bitmap[word]; bits; bits &= bits - 1)
+                status |= open_addr_hash_table_insert(&set->table,
+                            base | (uint32_t) (64 * word
+                                         + (size_t) __builtin_ctzll(bits)));
+    }
+
+    if (status < 0)
+    {
+        /* Chunks are kept until table is complete */
+        open_addr_hash_table_dtor(&set->table);
+        return -1;
+    }
+
+    free_chunks(set);
+    set->mode = HYBRID_SET_HASH;
+    ++ set->rehash_count;
+    set->next_check = 2 * set->key_count > min_check_keys
+                    ? 2 * set->key_count
+                    : min_check_keys;
+
+    TRACER_END(trace_start_ns, TRACER_EVENT_REHASH, "hybrid",
+               set->table.size);
+
+    return 0;
+}
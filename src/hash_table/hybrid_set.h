@@ -0,0 +1,100 @@
+/**
+ * @file hybrid_set.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Set of keys switching between hash table and chunked bitmap
+ *
+ * Sparse sets are kept in `OpenAddrHashTable`. Dense ones are split into
+ * chunks by upper 16 bits of keys, like in Roaring bitmaps: chunk holds
+ * sorted array of lower 16 bits while it has at most 4096 keys, and a
+ * 65536-bit bitmap otherwise. Array never takes more than bitmap, so chunked
+ * set takes at most 2 bytes per key, and a bit per key of dense chunks.
+ *
+ * Hash table is checked every time its number of keys doubles, and is
+ * converted into chunks if there are at least 8192 keys per chunk, so that
+ * most of them are bitmaps. Chunked set returns to hash table if there are
+ * less than 1024 keys per chunk.
+ *
+ * @version 0.1
+ * @date 2023-06-04
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_HYBRID_SET_H
+#define __HASH_TABLE_HYBRID_SET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "hashes/table_hash.h"
+#include "open_addr_hash_table.h"
+#include "table_allocator.h"
+
+enum hybrid_set_mode
+{
+    HYBRID_SET_HASH,
+    HYBRID_SET_CHUNKED,
+};
+
+struct HybridSetChunk
+{
+    /** Upper 16 bits of keys */
+    uint32_t high;
+    /** Number of keys */
+    uint32_t count;
+
+    /** Sorted lower 16 bits of keys, NULL if chunk is a bitmap */
+    uint16_t* array;
+    size_t array_capacity;
+
+    /** Bit per possible lower 16 bits of key, NULL if chunk is an array */
+    uint64_t* bitmap;
+};
+
+struct HybridSet
+{
+    hybrid_set_mode mode;
+    size_t key_count;
+
+    /** Keys of sparse set, empty in chunked mode */
+    OpenAddrHashTable table;
+
+    /** Chunks of dense set sorted by upper bits, empty in hash mode */
+    HybridSetChunk* chunks;
+    size_t chunk_count;
+    size_t chunk_capacity;
+    /** Bytes taken by arrays and bitmaps of chunks */
+    size_t container_bytes;
+
+    /** Density of hash table is checked upon reaching this many keys */
+    size_t next_check;
+
+    /** Mode switches and rehashes of destroyed hash tables, rehashes of
+     * current one are counted by it */
+    size_t rehash_count;
+
+    table_hash hash;
+
+    TableAllocator allocator;
+};
+
+/**
+ * @brief Construct empty set in hash mode. Hash table, chunk arrays and
+ * bitmaps are allocated by `allocator`, or by `TABLE_DEFAULT_ALLOCATOR` if
+ * it is NULL.
+ */
+void hybrid_set_ctor    (HybridSet* set,
+                         table_hash hash = TABLE_HASH_FIBONACCI,
+                         const TableAllocator* allocator = NULL);
+void hybrid_set_dtor    (HybridSet* set);
+int  hybrid_set_insert  (HybridSet* set, uint32_t key);
+int  hybrid_set_erase   (HybridSet* set, uint32_t key);
+int  hybrid_set_contains(HybridSet* set, uint32_t key);
+
+/**
+ * @brief Get bytes of hash table or chunks of set, excluding allocator
+ * overhead
+ */
+size_t hybrid_set_footprint(const HybridSet* set);
+
+#endif /* hybrid_set.h */
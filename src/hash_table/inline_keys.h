@@ -0,0 +1,68 @@
+/**
+ * @file inline_keys.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Few keys stored inside table struct
+ *
+ * Small tables keep their keys in unordered array of 16 keys, which fits
+ * a single AVX-512 register, so that lookup is one masked compare. Table is
+ * not allocated until array is full.
+ *
+ * @version 0.1
+ * @date 2023-06-05
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_INLINE_KEYS_H
+#define __HASH_TABLE_INLINE_KEYS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <immintrin.h>
+
+static const uint32_t INLINE_KEYS_CAPACITY = 16;
+
+struct InlineKeys
+{
+    uint32_t keys[INLINE_KEYS_CAPACITY];
+    uint32_t count;
+};
+
+static_assert(sizeof(((InlineKeys*) NULL)->keys) == sizeof(__m512i),
+              "Inline keys must fill one vector");
+
+/**
+ * @return Index of key, -1 if it is absent
+ */
+__always_inline
+static int inline_keys_find(const InlineKeys* small, uint32_t key)
+{
+    /* Slots past `count` may hold stale keys, so they are masked out */
+    const __mmask16 valid = (__mmask16) ((1u << small->count) - 1);
+    const __mmask16 match = _mm512_mask_cmpeq_epi32_mask(
+                                    valid,
+                                    _mm512_loadu_si512(small->keys),
+                                    _mm512_set1_epi32((int) key));
+
+    return match ? __builtin_ctz(match) : -1;
+}
+
+/**
+ * @brief Append key, which must be absent. Array must not be full.
+ */
+__always_inline
+static void inline_keys_add(InlineKeys* small, uint32_t key)
+{
+    small->keys[small->count++] = key;
+}
+
+/**
+ * @brief Remove key at `index`, replacing it with the last one
+ */
+__always_inline
+static void inline_keys_remove(InlineKeys* small, int index)
+{
+    small->keys[index] = small->keys[-- small->count];
+}
+
+#endif /* inline_keys.h */
@@ -1,53 +1,158 @@
 #include "open_addr_hash_table.h"
 
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "hashes/hash_functions.h"
+#include "hashes/table_hash.h"
 #include "closed_addr_hash_table.h"
+#include "tracer.h"
 
-static const size_t default_size = 1024;
-static const double fill_factor = 0.75;
+/* Slot array of small table is allocated at this size or larger one, which
+ * keeps fill factor */
+static const size_t min_size_exp = 6;
+static const double max_fill_factor = 0.99;
 
-// As per Donald E. Knuth "The Art of Computer Programming" vol 3 ed. 2
-// section 6.4
-// ~= 2^64 / phi
-static const uint64_t fib_constant = 11400714819323198485llu;
+/* Maximal fill factors of well-hashed adaptive tables. Linear probing
+ * clusters degrade faster than other sequences. */
+static const double tuned_linear_fill_factor = 0.85;
+static const double tuned_fill_factor = 0.9;
 
-static OpenAddrHashTableEntry* find_node(OpenAddrHashTable* table,
+static const size_t slots_per_line = 64 / sizeof(OpenAddrHashTableEntry);
+
+static_assert(64 % sizeof(OpenAddrHashTableEntry) == 0,
+              "Entries must not cross cache lines");
+
+/**
+ * @brief Position in probe sequence of key
+ */
+struct ProbeState
+{
+    size_t index;
+    size_t mask;
+    /** Number of visited slots */
+    size_t attempt;
+    /** Double hashing step, or number of lines jumped over */
+    size_t step;
+};
+
+template <open_addr_probe Probe>
+__always_inline
+static ProbeState probe_start(size_t home, size_t mask)
+{
+    return {
+        .index = home,
+        .mask = mask,
+        .attempt = 1,
+        .step = 0
+    };
+}
+
+/* Every sequence visits every slot of table of power of two size, so it
+ * reaches a free slot, which is kept by fill factor */
+template <open_addr_probe Probe>
+__always_inline
+static void probe_next(ProbeState* probe, uint32_t key)
+{
+    switch (Probe)
+    {
+    case OPEN_ADDR_PROBE_TRIANGULAR:
+        probe->index = (probe->index + probe->attempt) & probe->mask;
+        break;
+    case OPEN_ADDR_PROBE_DOUBLE:
+        /* Second hash is taken only if home slot is not enough */
+        if (probe->step == 0)
+            probe->step = (hash_int_multiplicative((int32_t) key) >> 20) | 1;
+        probe->index = (probe->index + probe->step) & probe->mask;
+        break;
+    case OPEN_ADDR_PROBE_CACHE_LINE:
+    {
+        size_t line = probe->index & ~(slots_per_line - 1);
+        if (probe->attempt % slots_per_line == 0)
+        {
+            ++ probe->step;
+            line = (line + probe->step * slots_per_line) & probe->mask;
+        }
+        probe->index = line | ((probe->index + 1) & (slots_per_line - 1));
+        break;
+    }
+    case OPEN_ADDR_PROBE_LINEAR:
+    default:
+        probe->index = (probe->index + 1) & probe->mask;
+        break;
+    }
+
+    ++ probe->attempt;
+}
+
+template <open_addr_probe Probe>
+static OpenAddrHashTableEntry* find_node(ProbedOpenAddrHashTable<Probe>* table,
                                          uint32_t key);
-static int try_rehash(OpenAddrHashTable* table);
 
+template <open_addr_probe Probe>
+static int try_rehash(ProbedOpenAddrHashTable<Probe>* table);
+
+template <open_addr_probe Probe>
+static int rehash(ProbedOpenAddrHashTable<Probe>* table, size_t size_exp,
+                  const TableHashState* new_hash);
+
+template <open_addr_probe Probe>
+static int tune(ProbedOpenAddrHashTable<Probe>* table);
+
+template <open_addr_probe Probe>
+static int insert_small(ProbedOpenAddrHashTable<Probe>* table, uint32_t key);
+
+/* Tables are constructed with allocator and are destroyed by zeroing */
+template <open_addr_probe Probe>
 __always_inline
-static size_t fibonacci_hash(uint64_t key, size_t size_exp)
+static int is_constructed(const ProbedOpenAddrHashTable<Probe>* table)
 {
-    const size_t shift = 64 - size_exp;
-    key ^= key >> shift;
-    return (fib_constant * key) >> shift;
+    return table && table->allocator.alloc;
 }
 
-void open_addr_hash_table_ctor(OpenAddrHashTable* table)
+template <open_addr_probe Probe>
+void open_addr_hash_table_ctor(ProbedOpenAddrHashTable<Probe>* table,
+                               table_hash hash,
+                               const TableAllocator* allocator)
 {
     if (!table) return;
 
-    table->data = (OpenAddrHashTableEntry*)
-                    calloc(default_size, sizeof(*table->data));
-    table->size = default_size;
-    table->size_exp = 10;
+    table->allocator = allocator ? *allocator : TABLE_DEFAULT_ALLOCATOR;
+    table->data = NULL;
+    table->small = {};
+    table->size = 0;
+    table->size_exp = 0;
     table->distinct_count = 0;
+    table->fill_factor = OPEN_ADDR_DEFAULT_FILL_FACTOR;
+    table_hash_init(&table->hash, hash);
+    table->tuner = {};
+    table->rehash_count = 0;
+
+#ifdef HASH_TABLE_STATS
+    table->stats = {};
+#endif
 }
 
-void open_addr_hash_table_dtor(OpenAddrHashTable* table)
+template <open_addr_probe Probe>
+void open_addr_hash_table_dtor(ProbedOpenAddrHashTable<Probe>* table)
 {
     if (!table) return;
-    free(table->data);
+    table_free(&table->allocator, table->data,
+               table->size * sizeof(*table->data));
     memset(table, 0, sizeof(*table));
 }
 
-int open_addr_hash_table_insert(OpenAddrHashTable* table, uint32_t key)
+template <open_addr_probe Probe>
+int open_addr_hash_table_insert(ProbedOpenAddrHashTable<Probe>* table,
+                                uint32_t key)
 {
-    if (!table || !table->data) return -1;
-    
+    if (!is_constructed(table)) return -1;
+    TRACER_OP(TRACER_EVENT_INSERT, "open_addr", table->distinct_count);
+
+    if (!table->data)
+        return insert_small(table, key);
+
     OpenAddrHashTableEntry* node = find_node(table, key);
     if (node->status == NODE_OCCUPIED)
         return -1;
@@ -58,13 +163,29 @@ int open_addr_hash_table_insert(OpenAddrHashTable* table, uint32_t key)
     node->key = key;
     node->status = NODE_OCCUPIED;
 
+    if (table_tuner_due(&table->tuner) && tune(table) < 0)
+        return -1;
+
     return try_rehash(table);
 }
 
-int open_addr_hash_table_erase(OpenAddrHashTable* table, uint32_t key)
+template <open_addr_probe Probe>
+int open_addr_hash_table_erase(ProbedOpenAddrHashTable<Probe>* table,
+                               uint32_t key)
 {
-    if (!table || !table->data) return -1;
-    
+    if (!is_constructed(table)) return -1;
+    TRACER_OP(TRACER_EVENT_ERASE, "open_addr", table->distinct_count);
+
+    if (!table->data)
+    {
+        const int index = inline_keys_find(&table->small, key);
+        if (index < 0)
+            return -1;
+
+        inline_keys_remove(&table->small, index);
+        return 0;
+    }
+
     OpenAddrHashTableEntry* node = find_node(table, key);
     if (node->status != NODE_OCCUPIED)
         return -1;
@@ -72,62 +193,358 @@ int open_addr_hash_table_erase(OpenAddrHashTable* table, uint32_t key)
     node->key = 0;
     node->status = NODE_DELETED;
 
+    if (table_tuner_due(&table->tuner))
+        return tune(table);
+
     return 0;
 }
 
-int open_addr_hash_table_contains(OpenAddrHashTable* table, uint32_t key)
+template <open_addr_probe Probe>
+int open_addr_hash_table_contains(ProbedOpenAddrHashTable<Probe>* table,
+                                  uint32_t key)
 {
-    if (!table || !table->data) return 0;
-    
+    if (!is_constructed(table)) return 0;
+    TRACER_OP(TRACER_EVENT_CONTAINS, "open_addr", table->distinct_count);
+
+    if (!table->data)
+        return inline_keys_find(&table->small, key) >= 0;
+
     OpenAddrHashTableEntry* node = find_node(table, key);
+    const int found = node->status == NODE_OCCUPIED;
 
-    return node->status == NODE_OCCUPIED;
+    /* Table stays correct if tuning fails */
+    if (table_tuner_due(&table->tuner))
+        tune(table);
+
+    return found;
 }
 
-static OpenAddrHashTableEntry* find_node(OpenAddrHashTable* table,
+template <open_addr_probe Probe>
+int open_addr_hash_table_set_fill_factor(
+                                ProbedOpenAddrHashTable<Probe>* table,
+                                double fill_factor)
+{
+    if (!is_constructed(table)) return -1;
+
+    /* At least one slot of the smallest table must stay free */
+    if (!(fill_factor > 0 && fill_factor <= max_fill_factor))
+        return -1;
+
+    table->fill_factor = fill_factor;
+
+    /* Slot array is sized for fill factor once allocated */
+    if (!table->data)
+        return 0;
+
+    while (fill_factor*(double)table->size <= (double) table->distinct_count)
+        if (try_rehash(table) < 0)
+            return -1;
+
+    return 0;
+}
+
+template <open_addr_probe Probe>
+int open_addr_hash_table_enable_tuning(ProbedOpenAddrHashTable<Probe>* table)
+{
+    if (!is_constructed(table)) return -1;
+
+    const double max_fill = Probe == OPEN_ADDR_PROBE_LINEAR
+                          ? tuned_linear_fill_factor
+                          : tuned_fill_factor;
+    table_tuner_enable(&table->tuner, table->fill_factor,
+                       table->fill_factor > max_fill ? table->fill_factor
+                                                     : max_fill);
+
+    return 0;
+}
+
+template <open_addr_probe Probe>
+int open_addr_hash_table_get_stats(
+                [[maybe_unused]] const ProbedOpenAddrHashTable<Probe>* table,
+                [[maybe_unused]] TableStats* stats)
+{
+#ifdef HASH_TABLE_STATS
+    if (!is_constructed(table) || !stats) return -1;
+
+    memset(stats, 0, sizeof(*stats));
+    table_stats_copy_counters(stats, &table->stats);
+
+    const size_t mask = table->size - 1;
+    size_t deleted = 0;
+    size_t cluster = 0;
+
+    /* Cluster wrapping around the end of table is counted as two */
+    for (size_t i = 0; i <= table->size; ++i)
+    {
+        if (i == table->size || table->data[i].status == NODE_FREE)
+        {
+            if (cluster > 0)
+                ++ stats->chain_lengths[table_stats_hist_index(cluster)];
+            cluster = 0;
+            continue;
+        }
+
+        ++ cluster;
+        if (table->data[i].status == NODE_DELETED)
+        {
+            ++ deleted;
+            continue;
+        }
+
+        /* Distance to home slot, which is the position in probe sequence
+         * for linear probing only */
+        const size_t home = table_hash_index(&table->hash, table->data[i].key,
+                                             table->size_exp);
+        const size_t displacement = (i - home) & mask;
+        if (displacement > stats->max_displacement)
+            stats->max_displacement = displacement;
+    }
+
+    stats->tombstone_ratio = table->size
+                           ? (double) deleted / (double) table->size
+                           : 0;
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+template <open_addr_probe Probe>
+static OpenAddrHashTableEntry* find_node(ProbedOpenAddrHashTable<Probe>* table,
                                          uint32_t key)
 {
-    size_t hash = fibonacci_hash(key, table->size_exp);
+    const size_t hash = table_hash_index(&table->hash, key, table->size_exp);
+    const size_t mask = table->size - 1;
 
-    size_t index = hash;
-    while (table->data[index].status != NODE_FREE
-            && table->data[index].key != key)
-        index = (index + 1) & ((1lu << table->size_exp) - 1u);
+    /* Tombstones keep zero key, so only occupied slots may match */
+    ProbeState probe = probe_start<Probe>(hash, mask);
+    while (table->data[probe.index].status != NODE_FREE
+            && (table->data[probe.index].status != NODE_OCCUPIED
+                || table->data[probe.index].key != key))
+        probe_next<Probe>(&probe, key);
 
-    if (table->data[index].status == NODE_OCCUPIED)
-        return table->data + index;
+#ifdef HASH_TABLE_STATS
+    table_stats_record_probe(&table->stats, probe.attempt);
+#endif
+    table_tuner_record(&table->tuner, probe.attempt,
+                       table->data[probe.index].status == NODE_OCCUPIED);
 
-    index = hash;
-    while (table->data[index].status == NODE_OCCUPIED)
-        index = (index + 1) & ((1lu << table->size_exp) - 1u);
+    if (table->data[probe.index].status == NODE_OCCUPIED)
+        return table->data + probe.index;
 
-    return table->data + index;
+    probe = probe_start<Probe>(hash, mask);
+    while (table->data[probe.index].status == NODE_OCCUPIED)
+        probe_next<Probe>(&probe, key);
+
+    return table->data + probe.index;
 }
 
-static int try_rehash(OpenAddrHashTable* table)
+template <open_addr_probe Probe>
+static int try_rehash(ProbedOpenAddrHashTable<Probe>* table)
 {
-    if (fill_factor*(double)table->size > (double) table->distinct_count)
+    if (table->fill_factor*(double)table->size
+            > (double) table->distinct_count)
         return 0;
 
-    OpenAddrHashTable new_table = {};
+    return rehash(table, table->size_exp + 1, &table->hash);
+}
+
+/**
+ * @brief Move occupied slots into new table of size `2^size_exp`, which
+ * uses hash function `new_hash`. Tombstones are dropped.
+ */
+template <open_addr_probe Probe>
+static int rehash(ProbedOpenAddrHashTable<Probe>* table, size_t size_exp,
+                  const TableHashState* new_hash)
+{
+#ifdef HASH_TABLE_STATS
+    const uint64_t start_ns = table_stats_now_ns();
+#endif
+    TRACER_BEGIN(trace_start_ns);
+
+    /* Tuner of new table stays disabled, so that moved keys are not
+     * recorded */
+    ProbedOpenAddrHashTable<Probe> new_table = {};
     new_table.data = (OpenAddrHashTableEntry*)
-                    calloc(table->size * 2, sizeof(*new_table.data));
+                    table_alloc(&table->allocator,
+                                (1lu << size_exp) * sizeof(*new_table.data));
     if (!new_table.data)
         return -1;
-    new_table.size = table->size * 2;
-    new_table.size_exp = table->size_exp + 1;
+    new_table.size = 1lu << size_exp;
+    new_table.size_exp = size_exp;
     new_table.distinct_count = 0;
+    new_table.fill_factor = table->fill_factor;
+    new_table.hash = *new_hash;
+    new_table.allocator = table->allocator;
 
     for (size_t i = 0; i < table->size; ++i)
         if (table->data[i].status == NODE_OCCUPIED)
             open_addr_hash_table_insert(&new_table, table->data[i].key);
 
+#ifdef HASH_TABLE_STATS
+    const TableStatsCounters stats = table->stats;
+#endif
+    const TableTuner tuner = table->tuner;
+    const size_t rehash_count = table->rehash_count;
+
     open_addr_hash_table_dtor(table);
     table->data = new_table.data;
     table->size_exp = new_table.size_exp;
     table->size = new_table.size;
     table->distinct_count = new_table.distinct_count;
+    table->fill_factor = new_table.fill_factor;
+    table->hash = new_table.hash;
+    table->allocator = new_table.allocator;
+    table->tuner = tuner;
+    table_tuner_restart(&table->tuner);
+    table->rehash_count = rehash_count + 1;
+
+#ifdef HASH_TABLE_STATS
+    table->stats = stats;
+    table_stats_record_rehash(&table->stats, start_ns);
+#endif
+
+    TRACER_END(trace_start_ns, TRACER_EVENT_REHASH, "open_addr", table->size);
 
     return 0;
 }
 
+/**
+ * @brief Insert key into small table, allocating slot array when it is full
+ */
+template <open_addr_probe Probe>
+static int insert_small(ProbedOpenAddrHashTable<Probe>* table, uint32_t key)
+{
+    if (inline_keys_find(&table->small, key) >= 0)
+        return -1;
+
+    if (table->small.count < INLINE_KEYS_CAPACITY)
+    {
+        inline_keys_add(&table->small, key);
+        return 0;
+    }
+
+    /* Table is cleared by rehash */
+    const InlineKeys small = table->small;
+
+    size_t size_exp = min_size_exp;
+    while (table->fill_factor * (double) (1lu << size_exp)
+                <= (double) (small.count + 1))
+        ++ size_exp;
+
+    if (rehash(table, size_exp, &table->hash) < 0)
+    {
+        table->small = small;
+        return -1;
+    }
+
+    for (size_t i = 0; i < small.count; ++i)
+    {
+        OpenAddrHashTableEntry* node = find_node(table, small.keys[i]);
+        node->key = small.keys[i];
+        node->status = NODE_OCCUPIED;
+        ++ table->distinct_count;
+    }
+
+    return open_addr_hash_table_insert(table, key);
+}
+
+/**
+ * @brief Get expected numbers of visited slots of successful and
+ * unsuccessful lookups of uniformly hashed keys
+ */
+template <open_addr_probe Probe>
+static void expected_probes(double load_factor, double* hit_mean,
+                            double* miss_mean)
+{
+    const double free_share = 1 - (load_factor < max_fill_factor
+                                   ? load_factor
+                                   : max_fill_factor);
+
+    switch (Probe)
+    {
+    case OPEN_ADDR_PROBE_LINEAR:
+    case OPEN_ADDR_PROBE_CACHE_LINE:
+        /* As per Donald E. Knuth "The Art of Computer Programming" vol 3
+         * ed. 2 section 6.4 */
+        *hit_mean  = (1 + 1 / free_share) / 2;
+        *miss_mean = (1 + 1 / (free_share * free_share)) / 2;
+        break;
+    case OPEN_ADDR_PROBE_TRIANGULAR:
+    case OPEN_ADDR_PROBE_DOUBLE:
+    default:
+        *hit_mean  = load_factor > 0.01 ? -log(free_share) / load_factor : 1;
+        *miss_mean = 1 / free_share;
+        break;
+    }
+}
+
+/**
+ * @brief Adjust fill factor or hash function using lookups of complete
+ * tuner window
+ */
+template <open_addr_probe Probe>
+static int tune(ProbedOpenAddrHashTable<Probe>* table)
+{
+    TableTuner* tuner = &table->tuner;
+    double hit_mean = 1;
+    double miss_mean = 1;
+    expected_probes<Probe>((double) table->distinct_count
+                                        / (double) table->size,
+                           &hit_mean, &miss_mean);
+
+    switch (table_tuner_evaluate(tuner, hit_mean, miss_mean, table->size_exp))
+    {
+    case TABLE_TUNER_FILL_MORE:
+        table->fill_factor += TABLE_TUNER_FILL_STEP;
+        if (table->fill_factor > tuner->max_fill_factor)
+            table->fill_factor = tuner->max_fill_factor;
+        return 0;
+    case TABLE_TUNER_REHASH:
+    {
+        /* Table keeps its size, unless keys do not fit default fill */
+        table->fill_factor = tuner->min_fill_factor;
+        size_t size_exp = table->size_exp;
+        while (table->fill_factor * (double) (1lu << size_exp)
+                    <= (double) table->distinct_count)
+            ++ size_exp;
+
+        TableHashState hash = {};
+        table_hash_init(&hash, table_tuner_stronger_hash(table->hash.kind));
+        return rehash(table, size_exp, &hash);
+    }
+    case TABLE_TUNER_KEEP:
+    default:
+        return 0;
+    }
+}
+
+#define INSTANTIATE_OPEN_ADDR_HASH_TABLE(probe)                             \
+    template void open_addr_hash_table_ctor(                                \
+                                    ProbedOpenAddrHashTable<probe>*,        \
+                                    table_hash, const TableAllocator*);     \
+    template void open_addr_hash_table_dtor(                                \
+                                    ProbedOpenAddrHashTable<probe>*);       \
+    template int  open_addr_hash_table_insert(                              \
+                                    ProbedOpenAddrHashTable<probe>*,        \
+                                    uint32_t);                              \
+    template int  open_addr_hash_table_erase(                               \
+                                    ProbedOpenAddrHashTable<probe>*,        \
+                                    uint32_t);                              \
+    template int  open_addr_hash_table_contains(                            \
+                                    ProbedOpenAddrHashTable<probe>*,        \
+                                    uint32_t);                              \
+    template int  open_addr_hash_table_set_fill_factor(                     \
+                                    ProbedOpenAddrHashTable<probe>*,        \
+                                    double);                                \
+    template int  open_addr_hash_table_enable_tuning(                       \
+                                    ProbedOpenAddrHashTable<probe>*);       \
+    template int  open_addr_hash_table_get_stats(                           \
+                                    const ProbedOpenAddrHashTable<probe>*,  \
+                                    TableStats*);
+
+INSTANTIATE_OPEN_ADDR_HASH_TABLE(OPEN_ADDR_PROBE_LINEAR)
+INSTANTIATE_OPEN_ADDR_HASH_TABLE(OPEN_ADDR_PROBE_TRIANGULAR)
+INSTANTIATE_OPEN_ADDR_HASH_TABLE(OPEN_ADDR_PROBE_DOUBLE)
+INSTANTIATE_OPEN_ADDR_HASH_TABLE(OPEN_ADDR_PROBE_CACHE_LINE)
@@ -15,6 +15,12 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "hashes/table_hash.h"
+#include "inline_keys.h"
+#include "table_allocator.h"
+#include "table_stats.h"
+#include "table_tuner.h"
+
 enum node_status
 {
     NODE_FREE = 0,
@@ -22,25 +28,135 @@ enum node_status
     NODE_OCCUPIED = 2
 };
 
+/**
+ * @brief Probe sequence of open addressing table
+ */
+enum open_addr_probe
+{
+    /** Slots following home slot */
+    OPEN_ADDR_PROBE_LINEAR      = 0,
+    /** Home slot plus triangular numbers, visits every slot once */
+    OPEN_ADDR_PROBE_TRIANGULAR  = 1,
+    /** Odd step taken from second hash of key */
+    OPEN_ADDR_PROBE_DOUBLE      = 2,
+    /** Slots of home cache line, then lines at triangular offsets */
+    OPEN_ADDR_PROBE_CACHE_LINE  = 3,
+};
+
+static const char* const OPEN_ADDR_PROBE_NAMES[] = {
+    "linear",
+    "triangular",
+    "double",
+    "cache_line",
+};
+static const size_t OPEN_ADDR_PROBE_COUNT =
+                sizeof(OPEN_ADDR_PROBE_NAMES) / sizeof(*OPEN_ADDR_PROBE_NAMES);
+
 struct OpenAddrHashTableEntry
 {
     uint32_t key;
     node_status status;
 };
 
-struct OpenAddrHashTable
+/**
+ * @brief Open addressing hash table. Every probe sequence listed in
+ * `open_addr_probe` is instantiated.
+ *
+ * @tparam Probe    - Probe sequence
+ */
+template <open_addr_probe Probe>
+struct ProbedOpenAddrHashTable
 {
+    /** Slot array, NULL while keys fit into `small` */
     OpenAddrHashTableEntry* data;
+    InlineKeys small;
 
     size_t size_exp;
     size_t size;
+    /** Occupied and deleted slots */
     size_t distinct_count;
+
+    /** Table is grown when this share of slots is not free */
+    double fill_factor;
+
+    TableHashState hash;
+
+    /** Adjusts fill factor and hash function if enabled */
+    TableTuner tuner;
+
+    /** Rehashes since construction, including ones at the same size */
+    size_t rehash_count;
+
+    TableAllocator allocator;
+
+#ifdef HASH_TABLE_STATS
+    TableStatsCounters stats;
+#endif
 };
 
-void open_addr_hash_table_ctor    (OpenAddrHashTable* table);
-void open_addr_hash_table_dtor    (OpenAddrHashTable* table);
-int  open_addr_hash_table_insert  (OpenAddrHashTable* table, uint32_t key);
-int  open_addr_hash_table_erase   (OpenAddrHashTable* table, uint32_t key);
-int  open_addr_hash_table_contains(OpenAddrHashTable* table, uint32_t key);
+typedef ProbedOpenAddrHashTable<OPEN_ADDR_PROBE_LINEAR> OpenAddrHashTable;
+
+static const double OPEN_ADDR_DEFAULT_FILL_FACTOR = 0.75;
+
+/**
+ * @brief Construct empty table. First `INLINE_KEYS_CAPACITY` keys are kept
+ * inside table, and slot array is allocated after that by `allocator`, or
+ * by `TABLE_DEFAULT_ALLOCATOR` if it is NULL.
+ */
+template <open_addr_probe Probe>
+void open_addr_hash_table_ctor    (ProbedOpenAddrHashTable<Probe>* table,
+                                   table_hash hash = TABLE_HASH_FIBONACCI,
+                                   const TableAllocator* allocator = NULL);
+
+template <open_addr_probe Probe>
+void open_addr_hash_table_dtor    (ProbedOpenAddrHashTable<Probe>* table);
+
+template <open_addr_probe Probe>
+int  open_addr_hash_table_insert  (ProbedOpenAddrHashTable<Probe>* table,
+                                   uint32_t key);
+
+template <open_addr_probe Probe>
+int  open_addr_hash_table_erase   (ProbedOpenAddrHashTable<Probe>* table,
+                                   uint32_t key);
+
+template <open_addr_probe Probe>
+int  open_addr_hash_table_contains(ProbedOpenAddrHashTable<Probe>* table,
+                                   uint32_t key);
+
+/**
+ * @brief Set share of non-free slots, upon reaching which table is grown
+ * (`OPEN_ADDR_DEFAULT_FILL_FACTOR` by default). Table is grown at once
+ * until it is filled below new fill factor.
+ *
+ * @return 0 upon success, -1 if fill factor is not in range (0, 0.99]
+ */
+template <open_addr_probe Probe>
+int  open_addr_hash_table_set_fill_factor(
+                                ProbedOpenAddrHashTable<Probe>* table,
+                                double fill_factor);
+
+/**
+ * @brief Enable adaptive mode. Lookups are monitored, and table is rehashed
+ * early with stronger hash function if keys are poorly distributed, or
+ * is filled further (up to 0.85 for linear probing and 0.9 for other
+ * sequences) if they are well distributed. Current fill factor is kept as
+ * minimal one.
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+template <open_addr_probe Probe>
+int  open_addr_hash_table_enable_tuning(
+                                ProbedOpenAddrHashTable<Probe>* table);
+
+/**
+ * @brief Get table statistics. Chain lengths are lengths of clusters of
+ * occupied and deleted slots.
+ *
+ * @return 0 upon success, -1 if table is invalid or statistics are disabled
+ */
+template <open_addr_probe Probe>
+int  open_addr_hash_table_get_stats(
+                                const ProbedOpenAddrHashTable<Probe>* table,
+                                TableStats* stats);
 
 #endif /* open_addr_hash_table.h */
@@ -1,4 +1,8 @@
+#ifndef __HASH_TABLE_PRESETS_HASH_DOUBLE_H
+#define __HASH_TABLE_PRESETS_HASH_DOUBLE_H
+
 #include <math.h>
+#include <stdint.h>
 
 __always_inline
 static int double_equal(double a, double b)
@@ -6,7 +10,7 @@ static int double_equal(double a, double b)
     const double eps = 1e-6;
     if (isnan(a) && isnan(b))
         return 1;
-    if (a == b) return 1; 
+    if (!isunordered(a, b) && !islessgreater(a, b)) return 1;
 
     double m = fmax(fabs(a), fabs(b));
     double diff = m < eps ? 0.0 : fabs(a - b) / m;
@@ -14,13 +18,16 @@ static int double_equal(double a, double b)
     return diff < eps;
 }
 
-#define HASH_TABLE_KEY_DOUBLE
+struct HashPresetDouble
+{
+    typedef double key_type;
+    typedef uint64_t hash_fn(key_type key);
+
+    static constexpr const char* name = "double";
 
-#define KEY_TYPE double
-#define KEY_COPY(key) key
-#define KEY_DTOR(key)
-#define KEY_EQUAL(a, b) double_equal(a, b)
+    static key_type copy(key_type key) { return key; }
+    static void     dtor([[maybe_unused]] key_type key) {}
+    static int      equal(key_type a, key_type b) { return double_equal(a, b); }
+};
 
-#ifndef HASH_FUNCTION
-#define HASH_FUNCTION(key) hash_double_reinterpret(key)
-#endif
+#endif /* hash_double.h */
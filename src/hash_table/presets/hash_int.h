@@ -1,9 +1,18 @@
-#define HASH_TABLE_KEY_INT
-#define KEY_TYPE int32_t
-#define KEY_COPY(key) key
-#define KEY_DTOR(key)
-#define KEY_EQUAL(a, b) ( (a) == (b) )
-
-#ifndef HASH_FUNCTION
-#define HASH_FUNCTION(key) hash_int_multiplicative(key)
-#endif
+#ifndef __HASH_TABLE_PRESETS_HASH_INT_H
+#define __HASH_TABLE_PRESETS_HASH_INT_H
+
+#include <stdint.h>
+
+struct HashPresetInt
+{
+    typedef int32_t key_type;
+    typedef uint64_t hash_fn(key_type key);
+
+    static constexpr const char* name = "int";
+
+    static key_type copy(key_type key) { return key; }
+    static void     dtor([[maybe_unused]] key_type key) {}
+    static int      equal(key_type a, key_type b) { return a == b; }
+};
+
+#endif /* hash_int.h */
@@ -0,0 +1,35 @@
+/**
+ * @file hash_presets.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief Key presets and hash functions available for `FixedHashTable`
+ *
+ * @version 0.1
+ * @date 2023-05-21
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_PRESETS_HASH_PRESETS_H
+#define __HASH_TABLE_PRESETS_HASH_PRESETS_H
+
+#include "hash_table/hashes/hash_functions.h"
+
+#include "hash_int.h"
+#include "hash_double.h"
+#include "hash_str.h"
+
+/**
+ * @brief Invoke `X(preset, hash_function)` for every supported combination
+ * of key preset and hash function
+ */
+#define FOR_EACH_HASH_PRESET(X)                     \
+    X(HashPresetInt,    hash_int_identity)          \
+    X(HashPresetInt,    hash_int_multiplicative)    \
+    X(HashPresetDouble, hash_double_round)          \
+    X(HashPresetDouble, hash_double_reinterpret)    \
+    X(HashPresetStr,    hash_str_length)            \
+    X(HashPresetStr,    hash_str_sum_char)          \
+    X(HashPresetStr,    hash_str_polynome)          \
+    X(HashPresetStr,    hash_str_crc64)
+
+#endif /* hash_presets.h */
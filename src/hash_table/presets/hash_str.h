@@ -1,9 +1,20 @@
-#define HASH_TABLE_KEY_STR
-#define KEY_TYPE char*
-#define KEY_COPY(key) strdup(key)
-#define KEY_DTOR(key) free(key)
-#define KEY_EQUAL(a, b) ( strcmp((a), (b)) == 0 )
-
-#ifndef HASH_FUNCTION
-#define HASH_FUNCTION(key) hash_str_polynome(key)
-#endif
+#ifndef __HASH_TABLE_PRESETS_HASH_STR_H
+#define __HASH_TABLE_PRESETS_HASH_STR_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct HashPresetStr
+{
+    typedef const char* key_type;
+    typedef uint64_t hash_fn(key_type key);
+
+    static constexpr const char* name = "str";
+
+    static key_type copy(key_type key) { return strdup(key); }
+    static void     dtor(key_type key) { free(const_cast<char*>(key)); }
+    static int      equal(key_type a, key_type b) { return strcmp(a, b) == 0; }
+};
+
+#endif /* hash_str.h */
@@ -0,0 +1,94 @@
+#include "sharded_hash_table.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Shard is selected by low bits of mixed key, while shard tables index by
+ * high bits of their hash, so both choices stay independent */
+__always_inline
+static ShardedHashTableShard* get_shard(ShardedHashTable* table, uint32_t key)
+{
+    uint64_t mixed = key;
+    mixed = (mixed ^ (mixed >> 33)) * 0xFF51AFD7ED558CCD;
+    mixed = (mixed ^ (mixed >> 33)) * 0xC4CEB9FE1A85EC53;
+    mixed ^= mixed >> 33;
+
+    return table->shards + (mixed & (table->shard_count - 1));
+}
+
+int sharded_hash_table_ctor(ShardedHashTable* table, size_t shard_exp,
+                            table_hash hash)
+{
+    if (!table || shard_exp >= 32) return -1;
+
+    const size_t shard_count = 1lu << shard_exp;
+    ShardedHashTableShard* shards = (ShardedHashTableShard*)
+                aligned_alloc(alignof(ShardedHashTableShard),
+                              shard_count * sizeof(*shards));
+    if (!shards) return -1;
+
+    for (size_t i = 0; i < shard_count; ++i)
+    {
+        pthread_mutex_init(&shards[i].lock, NULL);
+        open_addr_hash_table_ctor(&shards[i].table, hash);
+    }
+
+    table->shards = shards;
+    table->shard_exp = shard_exp;
+    table->shard_count = shard_count;
+
+    return 0;
+}
+
+void sharded_hash_table_dtor(ShardedHashTable* table)
+{
+    if (!table || !table->shards) return;
+
+    for (size_t i = 0; i < table->shard_count; ++i)
+    {
+        open_addr_hash_table_dtor(&table->shards[i].table);
+        pthread_mutex_destroy(&table->shards[i].lock);
+    }
+
+    free(table->shards);
+    memset(table, 0, sizeof(*table));
+}
+
+int sharded_hash_table_insert(ShardedHashTable* table, uint32_t key)
+{
+    if (!table || !table->shards) return -1;
+
+    ShardedHashTableShard* shard = get_shard(table, key);
+
+    pthread_mutex_lock(&shard->lock);
+    const int result = open_addr_hash_table_insert(&shard->table, key);
+    pthread_mutex_unlock(&shard->lock);
+
+    return result;
+}
+
+int sharded_hash_table_erase(ShardedHashTable* table, uint32_t key)
+{
+    if (!table || !table->shards) return -1;
+
+    ShardedHashTableShard* shard = get_shard(table, key);
+
+    pthread_mutex_lock(&shard->lock);
+    const int result = open_addr_hash_table_erase(&shard->table, key);
+    pthread_mutex_unlock(&shard->lock);
+
+    return result;
+}
+
+int sharded_hash_table_contains(ShardedHashTable* table, uint32_t key)
+{
+    if (!table || !table->shards) return 0;
+
+    ShardedHashTableShard* shard = get_shard(table, key);
+
+    pthread_mutex_lock(&shard->lock);
+    const int result = open_addr_hash_table_contains(&shard->table, key);
+    pthread_mutex_unlock(&shard->lock);
+
+    return result;
+}
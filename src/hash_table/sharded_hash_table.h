@@ -0,0 +1,50 @@
+/**
+ * @file sharded_hash_table.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief Thread-safe hash table, consisting of open addressing tables
+ * guarded by separate locks
+ *
+ * @version 0.1
+ * @date 2023-05-28
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_SHARDED_HASH_TABLE_H
+#define __HASH_TABLE_SHARDED_HASH_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "open_addr_hash_table.h"
+
+/** Shards are aligned to cache line to avoid false sharing of locks */
+struct alignas(64) ShardedHashTableShard
+{
+    pthread_mutex_t lock;
+    OpenAddrHashTable table;
+};
+
+struct ShardedHashTable
+{
+    ShardedHashTableShard* shards;
+
+    size_t shard_exp;
+    size_t shard_count;
+};
+
+/**
+ * @brief Construct table of `2^shard_exp` shards. With `shard_exp` equal
+ * to 0 every operation is serialized by single lock.
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int  sharded_hash_table_ctor    (ShardedHashTable* table, size_t shard_exp,
+                                 table_hash hash = TABLE_HASH_FIBONACCI);
+void sharded_hash_table_dtor    (ShardedHashTable* table);
+int  sharded_hash_table_insert  (ShardedHashTable* table, uint32_t key);
+int  sharded_hash_table_erase   (ShardedHashTable* table, uint32_t key);
+int  sharded_hash_table_contains(ShardedHashTable* table, uint32_t key);
+
+#endif /* sharded_hash_table.h */
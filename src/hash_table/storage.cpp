@@ -0,0 +1,139 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+
+#include "storage.h"
+
+static const size_t page_size = 4096;
+static const size_t huge_page_size = 2lu << 20;
+
+static storage_backend current_backend = STORAGE_HEAP;
+
+__always_inline
+static size_t round_up(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/* Huge pages back only arrays of at least one huge page */
+__always_inline
+static size_t mapping_size(size_t size)
+{
+    if (size == 0)
+        return page_size;
+
+    return size >= huge_page_size ? round_up(size, huge_page_size)
+                                  : round_up(size, page_size);
+}
+
+static void* map_pages(size_t size);
+
+int storage_parse_backend(const char* name, storage_backend* backend)
+{
+    for (size_t i = 0; i < STORAGE_BACKEND_COUNT; ++i)
+    {
+        if (strcasecmp(name, STORAGE_BACKEND_NAMES[i]) == 0)
+        {
+            *backend = (storage_backend) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+void storage_set_backend(storage_backend backend)
+{
+    current_backend = backend;
+}
+
+storage_backend storage_get_backend(void)
+{
+    return current_backend;
+}
+
+void* storage_alloc(size_t size)
+{
+    if (current_backend == STORAGE_HEAP)
+        return calloc(1, size);
+
+    /* Anonymous pages are zero-filled */
+    return map_pages(mapping_size(size));
+}
+
+void* storage_realloc(void* ptr, size_t old_size, size_t new_size)
+{
+    if (current_backend == STORAGE_HEAP)
+        return realloc(ptr, new_size);
+
+    const size_t old_mapping = mapping_size(old_size);
+    const size_t new_mapping = mapping_size(new_size);
+    if (old_mapping == new_mapping)
+        return ptr;
+
+    void* pages = mremap(ptr, old_mapping, new_mapping, MREMAP_MAYMOVE);
+    if (pages != MAP_FAILED)
+    {
+        /* Moved range keeps flags of the old one, which may have been too
+         * small for huge pages */
+        if (new_mapping >= huge_page_size)
+            madvise(pages, new_mapping, MADV_HUGEPAGE);
+        return pages;
+    }
+
+    /* Older kernels cannot remap hugetlb pages */
+    if (new_mapping < old_mapping || !(pages = map_pages(new_mapping)))
+        return NULL;
+
+    memcpy(pages, ptr, old_size);
+    munmap(ptr, old_mapping);
+
+    return pages;
+}
+
+void storage_free(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (current_backend == STORAGE_HEAP)
+        free(ptr);
+    else
+        munmap(ptr, mapping_size(size));
+}
+
+static void* map_pages(size_t size)
+{
+    const int prot  = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+    if (current_backend == STORAGE_HUGETLB && size >= huge_page_size)
+    {
+        void* pages = mmap(NULL, size, prot, flags | MAP_HUGETLB, -1, 0);
+        if (pages != MAP_FAILED)
+            return pages;
+    }
+
+    if (size < huge_page_size)
+    {
+        void* pages = mmap(NULL, size, prot, flags, -1, 0);
+        return pages != MAP_FAILED ? pages : NULL;
+    }
+
+    /* Transparent huge pages back only 2MB-aligned ranges, so mapping is
+     * made one huge page larger and trimmed */
+    char* raw = (char*) mmap(NULL, size + huge_page_size, prot, flags, -1, 0);
+    if (raw == MAP_FAILED)
+        return NULL;
+
+    char* pages = (char*) round_up((uintptr_t) raw, huge_page_size);
+    if (pages != raw)
+        munmap(raw, (size_t) (pages - raw));
+    munmap(pages + size, (size_t) (raw + huge_page_size - pages));
+
+    madvise(pages, size, MADV_HUGEPAGE);
+
+    return pages;
+}
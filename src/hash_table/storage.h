@@ -0,0 +1,76 @@
+/**
+ * @file storage.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Backends for large table arrays
+ *
+ * Slot arrays, bucket arrays and entry pools are allocated through this
+ * interface. Heap backend uses `calloc`. Mmap backends map anonymous memory
+ * and back arrays of 2MB and larger with huge pages, so that random probes
+ * do not miss dTLB on every access: `mmap` backend requests transparent
+ * huge pages with `MADV_HUGEPAGE`, `hugetlb` backend maps reserved huge
+ * pages with `MAP_HUGETLB` and falls back to `mmap` if there are none.
+ * Arrays are grown with `mremap`, which moves page table entries instead of
+ * copying data.
+ *
+ * @version 0.1
+ * @date 2023-05-30
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_STORAGE_H
+#define __HASH_TABLE_STORAGE_H
+
+#include <stddef.h>
+
+enum storage_backend
+{
+    STORAGE_HEAP    = 0,
+    STORAGE_MMAP    = 1,
+    STORAGE_HUGETLB = 2,
+    STORAGE_BACKEND_COUNT
+};
+
+static const char* const STORAGE_BACKEND_NAMES[STORAGE_BACKEND_COUNT] = {
+    "heap",
+    "mmap",
+    "hugetlb",
+};
+
+/**
+ * @brief Parse backend name
+ *
+ * @return 0 upon success, -1 if name is unknown
+ */
+int storage_parse_backend(const char* name, storage_backend* backend);
+
+/**
+ * @brief Select backend for all subsequent allocations. Must be called
+ * before any table is constructed, since arrays are freed by the backend
+ * which is selected at the moment.
+ */
+void storage_set_backend(storage_backend backend);
+
+storage_backend storage_get_backend(void);
+
+/**
+ * @brief Allocate zero-filled array
+ *
+ * @return Array upon success, NULL otherwise
+ */
+void* storage_alloc(size_t size);
+
+/**
+ * @brief Resize array. Contents past `old_size` are unspecified.
+ *
+ * @return Resized array upon success, NULL otherwise. Old array stays valid
+ * if resize failed.
+ */
+void* storage_realloc(void* ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief Free array of given size
+ */
+void storage_free(void* ptr, size_t size);
+
+#endif /* storage.h */
@@ -0,0 +1,173 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "storage.h"
+#include "table_allocator.h"
+
+/* Smaller blocks, e.g. chain nodes, bypass storage backend, which maps
+ * whole pages */
+static const size_t storage_min_size = 4096;
+
+/* Pooled size classes are 16 bytes to 1MB */
+static const size_t pool_min_exp = 4;
+static const size_t pool_max_exp = 20;
+static const size_t pool_class_count = pool_max_exp - pool_min_exp + 1;
+
+struct PoolBlock
+{
+    PoolBlock* next;
+};
+
+struct ThreadPool
+{
+    PoolBlock* free_lists[pool_class_count];
+
+    ThreadPool() : free_lists() {}
+    ~ThreadPool() { table_thread_pool_trim(); }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+};
+
+static thread_local ThreadPool thread_pool;
+
+static void* default_alloc  (void* context, size_t size);
+static void* default_realloc(void* context, void* ptr,
+                             size_t old_size, size_t new_size);
+static void  default_free   (void* context, void* ptr, size_t size);
+
+static void* pool_alloc  (void* context, size_t size);
+static void* pool_realloc(void* context, void* ptr,
+                          size_t old_size, size_t new_size);
+static void  pool_free   (void* context, void* ptr, size_t size);
+
+const TableAllocator TABLE_DEFAULT_ALLOCATOR = {
+    .alloc   = default_alloc,
+    .realloc = default_realloc,
+    .free    = default_free,
+    .context = NULL
+};
+
+const TableAllocator TABLE_THREAD_POOL_ALLOCATOR = {
+    .alloc   = pool_alloc,
+    .realloc = pool_realloc,
+    .free    = pool_free,
+    .context = NULL
+};
+
+/* Class of blocks too large to be pooled is `pool_class_count` */
+__always_inline
+static size_t pool_class(size_t size)
+{
+    if (size <= 1lu << pool_min_exp)
+        return 0;
+
+    const size_t exp = 64 - (size_t) __builtin_clzl(size - 1);
+    return exp <= pool_max_exp ? exp - pool_min_exp : pool_class_count;
+}
+
+void table_thread_pool_trim(void)
+{
+    for (size_t i = 0; i < pool_class_count; ++i)
+    {
+        PoolBlock* block = thread_pool.free_lists[i];
+        while (block)
+        {
+            PoolBlock* next = block->next;
+            free(block);
+            block = next;
+        }
+        thread_pool.free_lists[i] = NULL;
+    }
+}
+
+static void* default_alloc([[maybe_unused]] void* context, size_t size)
+{
+    if (size < storage_min_size)
+        return calloc(1, size);
+
+    return storage_alloc(size);
+}
+
+static void* default_realloc(void* context, void* ptr,
+                             size_t old_size, size_t new_size)
+{
+    const bool old_stored = old_size >= storage_min_size;
+    const bool new_stored = new_size >= storage_min_size;
+
+    if (old_stored && new_stored)
+        return storage_realloc(ptr, old_size, new_size);
+
+    if (!old_stored && !new_stored)
+        return realloc(ptr, new_size);
+
+    void* block = default_alloc(context, new_size);
+    if (!block)
+        return NULL;
+
+    memcpy(block, ptr, old_size < new_size ? old_size : new_size);
+    default_free(context, ptr, old_size);
+
+    return block;
+}
+
+static void default_free([[maybe_unused]] void* context, void* ptr,
+                         size_t size)
+{
+    if (size < storage_min_size)
+        free(ptr);
+    else
+        storage_free(ptr, size);
+}
+
+static void* pool_alloc([[maybe_unused]] void* context, size_t size)
+{
+    const size_t size_class = pool_class(size);
+    if (size_class == pool_class_count)
+        return calloc(1, size);
+
+    PoolBlock* block = thread_pool.free_lists[size_class];
+    if (!block)
+        return calloc(1, 1lu << (size_class + pool_min_exp));
+
+    thread_pool.free_lists[size_class] = block->next;
+    memset(block, 0, size);
+
+    return block;
+}
+
+static void* pool_realloc(void* context, void* ptr,
+                          size_t old_size, size_t new_size)
+{
+    const size_t old_class = pool_class(old_size);
+    const size_t new_class = pool_class(new_size);
+
+    if (old_class == pool_class_count && new_class == pool_class_count)
+        return realloc(ptr, new_size);
+
+    if (old_class == new_class)
+        return ptr;
+
+    void* block = pool_alloc(context, new_size);
+    if (!block)
+        return NULL;
+
+    memcpy(block, ptr, old_size < new_size ? old_size : new_size);
+    pool_free(context, ptr, old_size);
+
+    return block;
+}
+
+static void pool_free([[maybe_unused]] void* context, void* ptr, size_t size)
+{
+    const size_t size_class = pool_class(size);
+    if (size_class == pool_class_count)
+    {
+        free(ptr);
+        return;
+    }
+
+    PoolBlock* block = (PoolBlock*) ptr;
+    block->next = thread_pool.free_lists[size_class];
+    thread_pool.free_lists[size_class] = block;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file table_allocator.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Allocator descriptor accepted by table constructors
+ *
+ * Tables allocate all their arrays and nodes through the descriptor they
+ * were constructed with. Sizes are passed to every call, so that allocators
+ * need no block headers. Tables constructed without descriptor use
+ * `TABLE_DEFAULT_ALLOCATOR`, which forwards arrays of a page and larger to
+ * the storage backend (see `storage.h`), and smaller blocks, such as chain
+ * nodes, to heap. Ready allocators are the thread-local pool below and
+ * arenas from `arena.h`.
+ *
+ * @version 0.1
+ * @date 2023-05-31
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_TABLE_ALLOCATOR_H
+#define __HASH_TABLE_TABLE_ALLOCATOR_H
+
+#include <stddef.h>
+
+struct TableAllocator
+{
+    /** Allocate zero-filled block, NULL upon failure */
+    void* (*alloc)  (void* context, size_t size);
+    /** Resize block, contents past `old_size` are unspecified. Old block
+     * stays valid if resize failed. */
+    void* (*realloc)(void* context, void* ptr, size_t old_size,
+                     size_t new_size);
+    /** Free block of given size */
+    void  (*free)   (void* context, void* ptr, size_t size);
+
+    /** Passed to every call, e.g. arena or tenant account */
+    void* context;
+};
+
+/** Storage backend selected by `storage_set_backend` for blocks of a page
+ * and larger, heap for smaller ones */
+extern const TableAllocator TABLE_DEFAULT_ALLOCATOR;
+
+/**
+ * @brief Pool of freed blocks, kept separately by every thread in power of
+ * two size classes. Blocks are taken from the pool of the allocating thread
+ * and returned to the pool of the freeing one, so tables may migrate
+ * between threads. Blocks larger than 1MB are not pooled.
+ */
+extern const TableAllocator TABLE_THREAD_POOL_ALLOCATOR;
+
+/**
+ * @brief Return pooled blocks of calling thread to heap. Called
+ * automatically on thread exit.
+ */
+void table_thread_pool_trim(void);
+
+__always_inline
+static void* table_alloc(const TableAllocator* allocator, size_t size)
+{
+    return allocator->alloc(allocator->context, size);
+}
+
+__always_inline
+static void* table_realloc(const TableAllocator* allocator, void* ptr,
+                           size_t old_size, size_t new_size)
+{
+    return allocator->realloc(allocator->context, ptr, old_size, new_size);
+}
+
+__always_inline
+static void table_free(const TableAllocator* allocator, void* ptr,
+                       size_t size)
+{
+    if (ptr)
+        allocator->free(allocator->context, ptr, size);
+}
+
+#endif /* table_allocator.h */
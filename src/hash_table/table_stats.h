@@ -0,0 +1,106 @@
+/**
+ * @file table_stats.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Optional hash table telemetry
+ *
+ * Live counters are compiled in only if `HASH_TABLE_STATS` is defined
+ * (`make STATS=1`). Otherwise tables contain no counters and
+ * `*_get_stats` functions fail.
+ *
+ * @version 0.1
+ * @date 2023-05-28
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_TABLE_STATS_H
+#define __HASH_TABLE_TABLE_STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+/** Last histogram bucket counts all lengths not less than its index */
+static const size_t TABLE_STATS_HIST_SIZE = 32;
+
+/**
+ * @brief Counters updated by table operations
+ */
+struct TableStatsCounters
+{
+    /** Operations by number of inspected slots or chain nodes */
+    uint64_t probe_lengths[TABLE_STATS_HIST_SIZE];
+
+    /** Rehashes (pool growths for `FixedHashTable`) */
+    uint64_t rehash_count;
+    uint64_t rehash_ns;
+};
+
+/**
+ * @brief Snapshot of table statistics
+ */
+struct TableStats
+{
+    /** Operations by number of inspected slots or chain nodes */
+    uint64_t probe_lengths[TABLE_STATS_HIST_SIZE];
+    /** Buckets by chain length, clusters of used slots by their length
+     * for open addressing */
+    uint64_t chain_lengths[TABLE_STATS_HIST_SIZE];
+
+    /** Share of slots occupied by deleted entries */
+    double tombstone_ratio;
+
+    uint64_t rehash_count;
+    uint64_t rehash_ns;
+
+    /** Maximal distance from key home slot, or position in chain */
+    size_t max_displacement;
+};
+
+#ifdef HASH_TABLE_STATS
+
+__always_inline
+static size_t table_stats_hist_index(size_t length)
+{
+    return length < TABLE_STATS_HIST_SIZE ? length : TABLE_STATS_HIST_SIZE - 1;
+}
+
+__always_inline
+static void table_stats_record_probe(TableStatsCounters* stats, size_t length)
+{
+    ++ stats->probe_lengths[table_stats_hist_index(length)];
+}
+
+__always_inline
+static uint64_t table_stats_now_ns(void)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1'000'000'000 + (uint64_t) now.tv_nsec;
+}
+
+__always_inline
+static void table_stats_record_rehash(TableStatsCounters* stats,
+                                      uint64_t start_ns)
+{
+    ++ stats->rehash_count;
+    stats->rehash_ns += table_stats_now_ns() - start_ns;
+}
+
+/**
+ * @brief Copy live counters into snapshot
+ */
+__always_inline
+static void table_stats_copy_counters(TableStats* stats,
+                                      const TableStatsCounters* counters)
+{
+    for (size_t i = 0; i < TABLE_STATS_HIST_SIZE; ++i)
+        stats->probe_lengths[i] = counters->probe_lengths[i];
+
+    stats->rehash_count = counters->rehash_count;
+    stats->rehash_ns    = counters->rehash_ns;
+}
+
+#endif /* HASH_TABLE_STATS */
+
+#endif /* table_stats.h */
@@ -0,0 +1,184 @@
+/**
+ * @file table_tuner.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Adaptive tuning of fill factor and hash function of dynamic tables
+ *
+ * Table records number of inspected slots or chain nodes of every lookup.
+ * After every `TABLE_TUNER_WINDOW` lookups their mean is compared with the
+ * one expected for uniformly distributed keys at current load of table. If
+ * it is much larger, or if some lookup was too long, keys are poorly
+ * distributed, and table is rehashed with stronger and freshly seeded hash
+ * function and fill factor is reset. If it is close to expected, fill factor
+ * is raised, so that table grows later and takes less memory.
+ *
+ * @version 0.1
+ * @date 2023-06-03
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_TABLE_TUNER_H
+#define __HASH_TABLE_TABLE_TUNER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "hashes/table_hash.h"
+
+static const size_t TABLE_TUNER_WINDOW = 4096;
+/** Window is also complete after this many probes, so that pathological
+ * lookups are not repeated for a whole window */
+static const size_t TABLE_TUNER_WINDOW_PROBES = 64 * TABLE_TUNER_WINDOW;
+
+/** Mean probe length over this times expected one (plus one) is poor */
+static const double TABLE_TUNER_POOR_RATIO = 2.0;
+/** Mean probe length under this times expected one is good */
+static const double TABLE_TUNER_GOOD_RATIO = 1.2;
+/** Single probe longer than this times expected mean of unsuccessful lookup
+ * times base 2 logarithm of table size is poor */
+static const double TABLE_TUNER_MAX_RATIO = 4.0;
+
+static const double TABLE_TUNER_FILL_STEP = 0.05;
+
+enum table_tuner_action
+{
+    TABLE_TUNER_KEEP,
+    /** Raise fill factor */
+    TABLE_TUNER_FILL_MORE,
+    /** Rehash with stronger hash and default fill factor */
+    TABLE_TUNER_REHASH,
+};
+
+struct TableTuner
+{
+    /** Lookups are not recorded if zero */
+    int enabled;
+
+    /** Current window */
+    uint64_t probe_sum;
+    size_t probe_max;
+    size_t lookup_count;
+    size_t hit_count;
+
+    /** Fill factor is tuned between these */
+    double min_fill_factor;
+    double max_fill_factor;
+
+    /** Rehashes with new hash function */
+    size_t reseed_count;
+};
+
+/**
+ * @brief Enable tuning
+ *
+ * @param[out] tuner            - Tuner of table
+ * @param[in]  min_fill_factor  - Default fill factor of table
+ * @param[in]  max_fill_factor  - Maximal fill factor of well-hashed table
+ */
+__always_inline
+static void table_tuner_enable(TableTuner* tuner, double min_fill_factor,
+                               double max_fill_factor)
+{
+    *tuner = {};
+    tuner->enabled = 1;
+    tuner->min_fill_factor = min_fill_factor;
+    tuner->max_fill_factor = max_fill_factor;
+}
+
+__always_inline
+static void table_tuner_record(TableTuner* tuner, size_t probes, int found)
+{
+    if (!tuner->enabled)
+        return;
+
+    tuner->probe_sum += probes;
+    if (probes > tuner->probe_max)
+        tuner->probe_max = probes;
+    tuner->hit_count += (size_t) found;
+    ++ tuner->lookup_count;
+}
+
+/**
+ * @brief Drop recorded lookups. Table calls this after rehash, as lookups
+ * in old table do not describe new one.
+ */
+__always_inline
+static void table_tuner_restart(TableTuner* tuner)
+{
+    tuner->probe_sum = 0;
+    tuner->probe_max = 0;
+    tuner->lookup_count = 0;
+    tuner->hit_count = 0;
+}
+
+/**
+ * @return 1 if window is complete and table should be tuned, 0 otherwise
+ */
+__always_inline
+static int table_tuner_due(const TableTuner* tuner)
+{
+    return tuner->lookup_count >= TABLE_TUNER_WINDOW
+        || tuner->probe_sum >= TABLE_TUNER_WINDOW_PROBES;
+}
+
+/**
+ * @brief Compare lookups of complete window with expected ones and start
+ * new window
+ *
+ * @param[inout] tuner      - Tuner of table
+ * @param[in]    hit_mean   - Expected probe length of successful lookup
+ * @param[in]    miss_mean  - Expected probe length of unsuccessful lookup
+ * @param[in]    size_exp   - Base 2 logarithm of table size
+ *
+ * @return Action to be taken by table
+ */
+__always_inline
+static table_tuner_action table_tuner_evaluate(TableTuner* tuner,
+                                               double hit_mean,
+                                               double miss_mean,
+                                               size_t size_exp)
+{
+    const double lookups = (double) tuner->lookup_count;
+    const double hits = (double) tuner->hit_count;
+    const double expected = (hits * hit_mean + (lookups - hits) * miss_mean)
+                          / lookups;
+    const double mean = (double) tuner->probe_sum / lookups;
+    const double max_expected = TABLE_TUNER_MAX_RATIO * (double) size_exp
+                              * (miss_mean > 1 ? miss_mean : 1);
+    const size_t probe_max = tuner->probe_max;
+
+    table_tuner_restart(tuner);
+
+    if (mean > TABLE_TUNER_POOR_RATIO * expected + 1
+            || (double) probe_max > max_expected)
+    {
+        ++ tuner->reseed_count;
+        return TABLE_TUNER_REHASH;
+    }
+
+    if (mean < TABLE_TUNER_GOOD_RATIO * expected)
+        return TABLE_TUNER_FILL_MORE;
+
+    return TABLE_TUNER_KEEP;
+}
+
+/**
+ * @brief Get hash function to replace poorly distributing one. SipHash is
+ * replaced by itself, but with fresh seed.
+ */
+__always_inline
+static table_hash table_tuner_stronger_hash(table_hash hash)
+{
+    switch (hash)
+    {
+    case TABLE_HASH_IDENTITY:
+    case TABLE_HASH_FIBONACCI:
+        return TABLE_HASH_FIBONACCI_SEEDED;
+    case TABLE_HASH_FIBONACCI_SEEDED:
+    case TABLE_HASH_SIPHASH:
+    default:
+        return TABLE_HASH_SIPHASH;
+    }
+}
+
+#endif /* table_tuner.h */
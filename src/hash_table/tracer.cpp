@@ -0,0 +1,145 @@
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "tracer.h"
+
+struct TracerEvent
+{
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    const char* category;
+    uint64_t arg;
+    tracer_event event;
+    uint32_t thread;
+};
+
+struct Tracer
+{
+    TracerEvent* events;
+    size_t capacity;
+    size_t next;
+
+    uint64_t start_ns;
+    uint64_t slow_op_ns;
+};
+
+static Tracer tracer = {
+    .events = NULL,
+    .capacity = 0,
+    .next = 0,
+    .start_ns = 0,
+    .slow_op_ns = 0
+};
+
+static uint32_t get_thread_id(void)
+{
+    static thread_local uint32_t thread_id = 0;
+    if (!thread_id)
+        thread_id = (uint32_t) syscall(SYS_gettid);
+
+    return thread_id;
+}
+
+int tracer_start([[maybe_unused]] size_t capacity,
+                 [[maybe_unused]] uint64_t slow_op_ns)
+{
+#ifdef HASH_TABLE_TRACING
+    tracer_stop();
+
+    size_t rounded = 1;
+    while (rounded < capacity)
+        rounded <<= 1;
+
+    tracer.events = (TracerEvent*) calloc(rounded, sizeof(*tracer.events));
+    if (!tracer.events)
+        return -1;
+
+    tracer.capacity = rounded;
+    tracer.next = 0;
+    tracer.start_ns = tracer_now_ns();
+    tracer.slow_op_ns = slow_op_ns;
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+void tracer_stop(void)
+{
+    free(tracer.events);
+    tracer = {
+        .events = NULL,
+        .capacity = 0,
+        .next = 0,
+        .start_ns = 0,
+        .slow_op_ns = 0
+    };
+}
+
+int tracer_dump(FILE* output)
+{
+    if (!tracer.events || !output)
+        return -1;
+
+    const size_t first = tracer.next > tracer.capacity
+                       ? tracer.next - tracer.capacity
+                       : 0;
+    const int pid = getpid();
+
+    fputs("{\"traceEvents\":[", output);
+    for (size_t i = first; i < tracer.next; ++i)
+    {
+        const TracerEvent* event = &tracer.events[i & (tracer.capacity - 1)];
+
+        /* Timestamps are in microseconds since tracer start */
+        fprintf(output,
+                "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                "\"pid\":%d,\"tid\":%u,\"ts\":%.3lf,\"dur\":%.3lf,"
+                "\"args\":{\"%s\":%lu}}",
+                i == first ? "" : ",",
+                TRACER_EVENT_NAMES[event->event], event->category,
+                pid, event->thread,
+                (double) (event->begin_ns - tracer.start_ns) / 1e3,
+                (double) (event->end_ns - event->begin_ns) / 1e3,
+                TRACER_EVENT_ARGS[event->event], event->arg);
+    }
+    fprintf(output, "\n],\"displayTimeUnit\":\"ns\","
+                    "\"otherData\":{\"dropped_events\":%zu}}\n",
+                    first);
+
+    return ferror(output) ? -1 : 0;
+}
+
+uint64_t tracer_now_ns(void)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1'000'000'000 + (uint64_t) now.tv_nsec;
+}
+
+void tracer_record(tracer_event event, const char* category,
+                   uint64_t begin_ns, uint64_t arg)
+{
+    if (!tracer.events)
+        return;
+
+    const uint64_t end_ns = tracer_now_ns();
+    const size_t index = __atomic_fetch_add(&tracer.next, 1, __ATOMIC_RELAXED);
+
+    tracer.events[index & (tracer.capacity - 1)] = {
+        .begin_ns = begin_ns,
+        .end_ns = end_ns,
+        .category = category,
+        .arg = arg,
+        .event = event,
+        .thread = get_thread_id()
+    };
+}
+
+uint64_t tracer_slow_op_ns(void)
+{
+    return tracer.slow_op_ns;
+}
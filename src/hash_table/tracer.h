@@ -0,0 +1,147 @@
+/**
+ * @file tracer.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Ring-buffer tracer of hash table events
+ *
+ * Rehashes, pool growths and free list initialization are recorded with
+ * their begin and end time. Table operations slower than threshold are
+ * recorded as well. Only the latest events are kept, older ones are
+ * overwritten. Trace is written in Chrome trace event format and can be
+ * opened in Perfetto UI or chrome://tracing.
+ *
+ * Tables are instrumented only if `HASH_TABLE_TRACING` is defined
+ * (`make TRACING=1`). Otherwise tracer cannot be started.
+ *
+ * @version 0.1
+ * @date 2023-05-29
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __HASH_TABLE_TRACER_H
+#define __HASH_TABLE_TRACER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+enum tracer_event
+{
+    TRACER_EVENT_REHASH     = 0,
+    TRACER_EVENT_GROW       = 1,
+    TRACER_EVENT_MARK_FREE  = 2,
+    TRACER_EVENT_INSERT     = 3,
+    TRACER_EVENT_ERASE      = 4,
+    TRACER_EVENT_CONTAINS   = 5,
+    TRACER_EVENT_COUNT
+};
+
+static const char* const TRACER_EVENT_NAMES[TRACER_EVENT_COUNT] = {
+    "rehash",
+    "grow",
+    "mark_free",
+    "insert",
+    "erase",
+    "contains",
+};
+
+/** Meaning of event argument */
+static const char* const TRACER_EVENT_ARGS[TRACER_EVENT_COUNT] = {
+    "new_size",
+    "new_capacity",
+    "entries",
+    "size",
+    "size",
+    "size",
+};
+
+/**
+ * @brief Allocate event buffer and start recording. Must not be called
+ * while tables are used by other threads.
+ *
+ * @param[in] capacity      - Number of kept events, rounded up to power of 2
+ * @param[in] slow_op_ns    - Minimal recorded operation duration, operations
+ *                            are not timed if 0
+ *
+ * @return 0 upon success, -1 if allocation failed or tracing is compiled out
+ */
+int tracer_start(size_t capacity, uint64_t slow_op_ns);
+
+/**
+ * @brief Stop recording and free event buffer
+ */
+void tracer_stop(void);
+
+/**
+ * @brief Write recorded events as Chrome trace JSON. Must not be called
+ * while events are recorded.
+ *
+ * @param[in] output - Output file
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int tracer_dump(FILE* output);
+
+/**
+ * @brief Get monotonic time in nanoseconds
+ */
+uint64_t tracer_now_ns(void);
+
+/**
+ * @brief Record event which started at `begin_ns` and ends now
+ *
+ * @param[in] event     - Event type
+ * @param[in] category  - Table type, must be string literal
+ * @param[in] begin_ns  - Event start time
+ * @param[in] arg       - Event argument, see `TRACER_EVENT_ARGS`
+ */
+void tracer_record(tracer_event event, const char* category,
+                   uint64_t begin_ns, uint64_t arg);
+
+/**
+ * @brief Get minimal recorded operation duration, 0 if operations are not
+ * recorded
+ */
+uint64_t tracer_slow_op_ns(void);
+
+#ifdef HASH_TABLE_TRACING
+
+/**
+ * @brief Records enclosing operation if it took longer than threshold
+ */
+struct TracerOpScope
+{
+    tracer_event event;
+    const char* category;
+    uint64_t arg;
+    uint64_t begin_ns;
+
+    TracerOpScope(tracer_event op, const char* table_type, uint64_t size) :
+        event(op), category(table_type), arg(size),
+        begin_ns(tracer_slow_op_ns() ? tracer_now_ns() : 0)
+    {}
+
+    ~TracerOpScope()
+    {
+        if (begin_ns && tracer_now_ns() - begin_ns >= tracer_slow_op_ns())
+            tracer_record(event, category, begin_ns, arg);
+    }
+
+    TracerOpScope(const TracerOpScope&) = delete;
+    TracerOpScope& operator=(const TracerOpScope&) = delete;
+};
+
+#define TRACER_BEGIN(var)                const uint64_t var = tracer_now_ns()
+#define TRACER_END(var, event, cat, arg) tracer_record(event, cat, var, arg)
+#define TRACER_OP(event, cat, size)      TracerOpScope tracer_op_(event, cat, \
+                                                                  size)
+
+#else
+
+#define TRACER_BEGIN(var)
+#define TRACER_END(var, event, cat, arg)
+#define TRACER_OP(event, cat, size)
+
+#endif /* HASH_TABLE_TRACING */
+
+#endif /* tracer.h */
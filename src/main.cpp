@@ -1,75 +1,379 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#include "hash_table/closed_addr_hash_table.h"
-#include "hash_table/open_addr_hash_table.h"
+#include "meerkat_args/argparser.h"
 
-#if defined OPEN_ADDR
+#include "hash_table/storage.h"
+#include "hash_table/tracer.h"
+#include "workload/workload.h"
 
-typedef OpenAddrHashTable hash_table_t;
+struct PracticeConfig
+{
+    int had_error;
+    int has_repeat;
+    size_t repeat;
+    const char* table_name;
+    const char* cmd_gen_name;
+    const char* trace_path;
+    const char* corpus_path;
+    corpus_format format;
+    const char* chrome_trace_path;
+    uint64_t slow_op_ns;
+    storage_backend storage;
+    table_hash hash;
+};
 
-#define hash_table_ctor(...)     open_addr_hash_table_ctor(__VA_ARGS__)
-#define hash_table_dtor(...)     open_addr_hash_table_dtor(__VA_ARGS__)
-#define hash_table_insert(...)   open_addr_hash_table_insert(__VA_ARGS__)
-#define hash_table_erase(...)    open_addr_hash_table_erase(__VA_ARGS__)
-#define hash_table_contains(...) open_addr_hash_table_contains(__VA_ARGS__)
+/** Number of latest events kept by tracer */
+static const size_t tracer_capacity = 1lu << 20;
 
-#else /* CLOSED_ADDR */
+static int run_variant(const WorkloadVariant* variant,
+                       const PracticeConfig* config);
 
-typedef ClosedAddrHashTable hash_table_t;
+static int write_chrome_trace(const char* path);
 
-#define hash_table_ctor(...)     closed_addr_hash_table_ctor(__VA_ARGS__)
-#define hash_table_dtor(...)     closed_addr_hash_table_dtor(__VA_ARGS__)
-#define hash_table_insert(...)   closed_addr_hash_table_insert(__VA_ARGS__)
-#define hash_table_erase(...)    closed_addr_hash_table_erase(__VA_ARGS__)
-#define hash_table_contains(...) closed_addr_hash_table_contains(__VA_ARGS__)
+static int set_repeat   (const char* const* str, void* params);
+static int set_table    (const char* const* str, void* params);
+static int set_cmd_gen  (const char* const* str, void* params);
+static int set_hash     (const char* const* str, void* params);
+static int set_trace    (const char* const* str, void* params);
+static int set_corpus   (const char* const* str, void* params);
+static int set_format   (const char* const* str, void* params);
+static int set_chrome_trace(const char* const* str, void* params);
+static int set_slow_op  (const char* const* str, void* params);
+static int set_storage  (const char* const* str, void* params);
+static int list_variants(const char* const* str, void* params);
+static int get_help     (const char* const* str, void* params);
 
-#endif
+static const arg_tag PRACTICE_TAGS[] = {
+    {
+        .short_tag = 't',
+        .long_tag = "table",
+        .callback = set_table,
+        .description =
+            "Hash table type (default: closed_addr)"
+    },
+    {
+        .short_tag = 'g',
+        .long_tag = "generator",
+        .callback = set_cmd_gen,
+        .description =
+            "Command generator (default: rand_cmd)"
+    },
+    {
+        .short_tag = '\0',
+        .long_tag = "hash",
+        .callback = set_hash,
+        .description =
+            "Table hash function (default: fibonacci)"
+    },
+    {
+        .short_tag = '\0',
+        .long_tag = "trace",
+        .callback = set_trace,
+        .description =
+            "Replay commands from trace file instead of generating them"
+    },
+    {
+        .short_tag = '\0',
+        .long_tag = "corpus",
+        .callback = set_corpus,
+        .description =
+            "Insert and look up every key from corpus file"
+    },
+    {
+        .short_tag = '\0',
+        .long_tag = "corpus-format",
+        .callback = set_format,
+        .description =
+            "Corpus file format, text or binary (default: text)"
+    },
+    {
+        .short_tag = '\0',
+        .long_tag = "chrome-trace",
+        .callback = set_chrome_trace,
+        .description =
+            "Write rehash timeline to file in Chrome trace format"
+    },
+    {
+        .short_tag = '\0',
+        .long_tag = "slow-op",
+        .callback = set_slow_op,
+        .description =
+            "Trace operations slower than given number of nanoseconds"
+    },
+    {
+        .short_tag = '\0',
+        .long_tag = "storage",
+        .callback = set_storage,
+        .description =
+            "Table array storage, heap, mmap or hugetlb (default: heap)"
+    },
+    {
+        .short_tag = 'l',
+        .long_tag = "list",
+        .callback = list_variants,
+        .description =
+            "List available table types, generators and hashes and exit"
+    },
+    {
+        .short_tag = 'h',
+        .long_tag = "help",
+        .callback = get_help,
+        .description =
+            "Print help message and exit program"
+    }
+};
 
-enum command
-{
-    CMD_INSERT = 0,
-    CMD_ERASE = 1,
-    CMD_CONTAINS = 2
+static const arg_info PRACTICE_ARGS = {
+    .help_message =
+        "hash_practice [-t <TABLE>] [-g <GENERATOR>] [--hash <HASH>] "
+        "<ITERATIONS>\n"
+        "hash_practice [-t <TABLE>] [--hash <HASH>] --trace <FILE>\n"
+        "hash_practice [-t <TABLE>] [--hash <HASH>] --corpus <FILE> "
+        "[--corpus-format <FORMAT>]",
+    .name_handler = NULL,
+    .plain_handler = set_repeat,
+    .tags = PRACTICE_TAGS,
+    .tag_cnt = sizeof(PRACTICE_TAGS) / sizeof(*PRACTICE_TAGS)
 };
 
 int main(int argc, char** argv)
 {
-    if (argc < 2)
+    PracticeConfig config = {
+        .had_error = 0,
+        .has_repeat = 0,
+        .repeat = 0,
+        .table_name = "closed_addr",
+        .cmd_gen_name = "rand_cmd",
+        .trace_path = NULL,
+        .corpus_path = NULL,
+        .format = CORPUS_FORMAT_TEXT,
+        .chrome_trace_path = NULL,
+        .slow_op_ns = 0,
+        .storage = STORAGE_HEAP,
+        .hash = TABLE_HASH_FIBONACCI
+    };
+
+    if (parse_args(argc, argv, &PRACTICE_ARGS, &config) < 0
+            || config.had_error)
+        return 1;
+
+    if (!config.has_repeat && !config.trace_path && !config.corpus_path)
     {
         fputs("Iterations not specified\n", stderr);
         return 1;
     }
-    char* end = NULL;
-    size_t repeat = strtoul(argv[1], &end, 10);
-    if (!end || *end != '\0')
+
+    const WorkloadVariant* variant =
+                workload_find(config.table_name, config.cmd_gen_name);
+    if (!variant)
     {
-        fputs("Invalid number of iterations\n", stderr);
+        fprintf(stderr, "Unknown table type '%s' or generator '%s'\n",
+                        config.table_name, config.cmd_gen_name);
         return 1;
     }
 
-    srand(0);
-    hash_table_t table = {};
-    hash_table_ctor(&table);
+    storage_set_backend(config.storage);
+
+    if (config.chrome_trace_path
+            && tracer_start(tracer_capacity, config.slow_op_ns) < 0)
+    {
+        fputs("Failed to start tracer, build with TRACING=1\n", stderr);
+        return 1;
+    }
+
+    int status = run_variant(variant, &config);
+
+    if (config.chrome_trace_path)
+    {
+        status |= write_chrome_trace(config.chrome_trace_path);
+        tracer_stop();
+    }
+
+    return status;
+}
 
-    for (size_t i = 0; i < repeat; ++i)
+static int run_variant(const WorkloadVariant* variant,
+                       const PracticeConfig* config)
+{
+    if (config->corpus_path)
     {
-#ifdef RAND_CMD
-        command cmd = (command) (rand() % 3);
-#else
-        int tmp = rand() % 4;
-        command cmd = tmp < 3 ? (command) tmp : CMD_INSERT;
-#endif
+        Corpus corpus = {};
+        if (corpus_open(config->corpus_path, config->format, &corpus) < 0)
+        {
+            fprintf(stderr, "Failed to open corpus file '%s'\n",
+                            config->corpus_path);
+            return 1;
+        }
 
-        switch (cmd)
+        const int status = variant->load_corpus(&corpus, config->hash,
+                                                NULL);
+        corpus_close(&corpus);
+
+        if (status < 0)
         {
-        case CMD_INSERT:   hash_table_insert  (&table, (uint32_t)rand()); break;
-        case CMD_ERASE:    hash_table_erase   (&table, (uint32_t)rand()); break;
-        case CMD_CONTAINS: hash_table_contains(&table, (uint32_t)rand()); break;
-        default:
-            break;
+            fprintf(stderr, "Invalid key in corpus file '%s'\n",
+                            config->corpus_path);
+            return 1;
         }
+
+        return 0;
+    }
+
+    if (!config->trace_path)
+    {
+        variant->run(config->repeat, config->hash);
+        return 0;
+    }
+
+    Trace trace = {};
+    if (trace_map(config->trace_path, &trace) < 0)
+    {
+        fprintf(stderr, "Failed to map trace file '%s'\n", config->trace_path);
+        return 1;
+    }
+
+    variant->replay(&trace, config->hash);
+    trace_unmap(&trace);
+
+    return 0;
+}
+
+static int write_chrome_trace(const char* path)
+{
+    FILE* output = fopen(path, "w");
+    if (!output || tracer_dump(output) < 0)
+    {
+        fprintf(stderr, "Failed to write trace file '%s'\n", path);
+        if (output) fclose(output);
+        return 1;
     }
 
-    hash_table_dtor(&table);
+    fclose(output);
+    return 0;
+}
+
+static int set_repeat(const char* const* str, void* params)
+{
+    PracticeConfig* config = (PracticeConfig*) params;
+
+    char* end = NULL;
+    config->repeat = strtoul(*str, &end, 10);
+    if (config->has_repeat || !end || *end != '\0')
+    {
+        fputs("Invalid number of iterations\n", stderr);
+        config->had_error = 1;
+        return -1;
+    }
+
+    config->has_repeat = 1;
+    return 1;
+}
+
+static int set_table(const char* const* str, void* params)
+{
+    ((PracticeConfig*) params)->table_name = *str;
+    return 1;
+}
+
+static int set_cmd_gen(const char* const* str, void* params)
+{
+    ((PracticeConfig*) params)->cmd_gen_name = *str;
+    return 1;
+}
+
+static int set_hash(const char* const* str, void* params)
+{
+    PracticeConfig* config = (PracticeConfig*) params;
+
+    if (workload_parse_hash(*str, &config->hash) < 0)
+    {
+        fprintf(stderr, "Unknown hash function '%s'\n", *str);
+        config->had_error = 1;
+        return -1;
+    }
+
+    return 1;
+}
+
+static int set_trace(const char* const* str, void* params)
+{
+    ((PracticeConfig*) params)->trace_path = *str;
+    return 1;
+}
+
+static int set_corpus(const char* const* str, void* params)
+{
+    ((PracticeConfig*) params)->corpus_path = *str;
+    return 1;
+}
+
+static int set_format(const char* const* str, void* params)
+{
+    PracticeConfig* config = (PracticeConfig*) params;
+
+    if (corpus_parse_format(*str, &config->format) < 0)
+    {
+        fprintf(stderr, "Unknown corpus format '%s'\n", *str);
+        config->had_error = 1;
+        return -1;
+    }
+
+    return 1;
+}
+
+static int set_storage(const char* const* str, void* params)
+{
+    PracticeConfig* config = (PracticeConfig*) params;
+
+    if (storage_parse_backend(*str, &config->storage) < 0)
+    {
+        fprintf(stderr, "Unknown storage backend '%s'\n", *str);
+        config->had_error = 1;
+        return -1;
+    }
+
+    return 1;
+}
+
+static int set_chrome_trace(const char* const* str, void* params)
+{
+    ((PracticeConfig*) params)->chrome_trace_path = *str;
+    return 1;
+}
+
+static int set_slow_op(const char* const* str, void* params)
+{
+    PracticeConfig* config = (PracticeConfig*) params;
+
+    char* end = NULL;
+    config->slow_op_ns = strtoul(*str, &end, 10);
+    if (!end || *end != '\0' || config->slow_op_ns == 0)
+    {
+        fputs("Invalid slow operation threshold\n", stderr);
+        config->had_error = 1;
+        return -1;
+    }
+
+    return 1;
+}
+
+__attribute__((noreturn))
+static int list_variants([[maybe_unused]] const char* const* str,
+                         [[maybe_unused]] void* params)
+{
+    for (size_t i = 0; i < WORKLOAD_VARIANT_COUNT; ++i)
+        printf("%s %s\n", WORKLOAD_VARIANTS[i].table_name,
+                          COMMAND_GEN_NAMES[WORKLOAD_VARIANTS[i].cmd_gen]);
+    for (size_t i = 0; i < TABLE_HASH_COUNT; ++i)
+        printf("--hash %s\n", TABLE_HASH_NAMES[i]);
+    exit(0);
+}
+
+__attribute__((noreturn))
+static int get_help([[maybe_unused]] const char* const* str,
+                    [[maybe_unused]] void* params)
+{
+    print_help(&PRACTICE_ARGS);
+    exit(0);
 }
@@ -0,0 +1,172 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "baselines.h"
+
+static const size_t sorted_vector_default_capacity = 1024;
+
+void std_set_ctor(StdSetTable* table)
+{
+    if (!table) return;
+    table->set = new std::unordered_set<uint32_t>();
+}
+
+void std_set_dtor(StdSetTable* table)
+{
+    if (!table) return;
+    delete table->set;
+    table->set = NULL;
+}
+
+int std_set_insert(StdSetTable* table, uint32_t key)
+{
+    if (!table || !table->set) return -1;
+    return table->set->insert(key).second ? 0 : -1;
+}
+
+int std_set_erase(StdSetTable* table, uint32_t key)
+{
+    if (!table || !table->set) return -1;
+    return table->set->erase(key) ? 0 : -1;
+}
+
+int std_set_contains(const StdSetTable* table, uint32_t key)
+{
+    if (!table || !table->set) return 0;
+    return table->set->count(key) != 0;
+}
+
+/* Index of first element not less than key */
+static size_t lower_bound(const SortedVectorTable* table, uint32_t key)
+{
+    size_t left = 0, right = table->size;
+    while (left < right)
+    {
+        const size_t mid = left + (right - left) / 2;
+        if (table->data[mid] < key)
+            left = mid + 1;
+        else
+            right = mid;
+    }
+
+    return left;
+}
+
+void sorted_vector_ctor(SortedVectorTable* table)
+{
+    if (!table) return;
+
+    table->data = (uint32_t*) calloc(sorted_vector_default_capacity,
+                                     sizeof(*table->data));
+    table->size = 0;
+    table->capacity = table->data ? sorted_vector_default_capacity : 0;
+}
+
+void sorted_vector_dtor(SortedVectorTable* table)
+{
+    if (!table) return;
+    free(table->data);
+    memset(table, 0, sizeof(*table));
+}
+
+int sorted_vector_insert(SortedVectorTable* table, uint32_t key)
+{
+    if (!table || !table->data) return -1;
+
+    const size_t index = lower_bound(table, key);
+    if (index < table->size && table->data[index] == key)
+        return -1;
+
+    if (table->size == table->capacity)
+    {
+        uint32_t* data = (uint32_t*) realloc(table->data,
+                                    2 * table->capacity * sizeof(*data));
+        if (!data) return -1;
+
+        table->data = data;
+        table->capacity *= 2;
+    }
+
+    memmove(table->data + index + 1, table->data + index,
+            (table->size - index) * sizeof(*table->data));
+    table->data[index] = key;
+    ++table->size;
+
+    return 0;
+}
+
+int sorted_vector_erase(SortedVectorTable* table, uint32_t key)
+{
+    if (!table || !table->data) return -1;
+
+    const size_t index = lower_bound(table, key);
+    if (index == table->size || table->data[index] != key)
+        return -1;
+
+    memmove(table->data + index, table->data + index + 1,
+            (table->size - index - 1) * sizeof(*table->data));
+    --table->size;
+
+    return 0;
+}
+
+int sorted_vector_contains(const SortedVectorTable* table, uint32_t key)
+{
+    if (!table || !table->data) return 0;
+
+    const size_t index = lower_bound(table, key);
+    return index < table->size && table->data[index] == key;
+}
+
+void dense_bitset_ctor(DenseBitsetTable* table)
+{
+    if (!table) return;
+
+    /* Large calloc is served by fresh zero pages, so untouched part of
+     * bitset costs no memory */
+    table->words = (uint64_t*) calloc(DENSE_BITSET_BITS / 64,
+                                      sizeof(*table->words));
+    table->distinct_count = 0;
+}
+
+void dense_bitset_dtor(DenseBitsetTable* table)
+{
+    if (!table) return;
+    free(table->words);
+    memset(table, 0, sizeof(*table));
+}
+
+int dense_bitset_insert(DenseBitsetTable* table, uint32_t key)
+{
+    if (!table || !table->words) return -1;
+
+    uint64_t* word = &table->words[key / 64];
+    const uint64_t mask = 1lu << (key % 64);
+    if (*word & mask)
+        return -1;
+
+    *word |= mask;
+    ++table->distinct_count;
+    return 0;
+}
+
+int dense_bitset_erase(DenseBitsetTable* table, uint32_t key)
+{
+    if (!table || !table->words) return -1;
+
+    uint64_t* word = &table->words[key / 64];
+    const uint64_t mask = 1lu << (key % 64);
+    if (!(*word & mask))
+        return -1;
+
+    *word &= ~mask;
+    --table->distinct_count;
+    return 0;
+}
+
+int dense_bitset_contains(const DenseBitsetTable* table, uint32_t key)
+{
+    if (!table || !table->words) return 0;
+
+    return (int) ((table->words[key / 64] >> (key % 64)) & 1);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file baselines.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief Reference set implementations to compare hash tables against
+ *
+ * @version 0.1
+ * @date 2023-05-29
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __WORKLOAD_BASELINES_H
+#define __WORKLOAD_BASELINES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <unordered_set>
+
+/** Standard library hash set with default identity hash of integers */
+struct StdSetTable
+{
+    std::unordered_set<uint32_t>* set;
+};
+
+void std_set_ctor    (StdSetTable* table);
+void std_set_dtor    (StdSetTable* table);
+int  std_set_insert  (StdSetTable* table, uint32_t key);
+int  std_set_erase   (StdSetTable* table, uint32_t key);
+int  std_set_contains(const StdSetTable* table, uint32_t key);
+
+/** Sorted array with binary search. Insertion and erase are linear. */
+struct SortedVectorTable
+{
+    uint32_t* data;
+    size_t size;
+    size_t capacity;
+};
+
+void sorted_vector_ctor    (SortedVectorTable* table);
+void sorted_vector_dtor    (SortedVectorTable* table);
+int  sorted_vector_insert  (SortedVectorTable* table, uint32_t key);
+int  sorted_vector_erase   (SortedVectorTable* table, uint32_t key);
+int  sorted_vector_contains(const SortedVectorTable* table, uint32_t key);
+
+/**
+ * Bit per every possible key. 512 MiB are reserved, but only pages with
+ * present keys are touched.
+ */
+struct DenseBitsetTable
+{
+    uint64_t* words;
+    size_t distinct_count;
+};
+
+static const size_t DENSE_BITSET_BITS = 1lu << 32;
+
+void dense_bitset_ctor    (DenseBitsetTable* table);
+void dense_bitset_dtor    (DenseBitsetTable* table);
+int  dense_bitset_insert  (DenseBitsetTable* table, uint32_t key);
+int  dense_bitset_erase   (DenseBitsetTable* table, uint32_t key);
+int  dense_bitset_contains(const DenseBitsetTable* table, uint32_t key);
+
+#endif /* baselines.h */
@@ -0,0 +1,288 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "corpus.h"
+
+static int map_window(Corpus* corpus, size_t offset);
+
+static int parse_key(const char* line, int32_t*  key);
+static int parse_key(const char* line, uint32_t* key);
+static int parse_key(const char* line, double*   key);
+
+template <typename Key>
+static int next_number(Corpus* corpus, Key* key);
+
+__always_inline
+static size_t align_to_page(size_t offset)
+{
+    const size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    return offset & ~(page_size - 1);
+}
+
+int corpus_open(const char* path, corpus_format format, Corpus* corpus)
+{
+    if (!path || !corpus || format >= CORPUS_FORMAT_COUNT)
+        return -1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat info = {};
+    if (fstat(fd, &info) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    *corpus = {
+        .fd = fd,
+        .format = format,
+        .file_size = (size_t) info.st_size,
+        .window = NULL,
+        .window_offset = 0,
+        .window_size = 0,
+        .position = 0,
+        .last_line = NULL
+    };
+
+    if (corpus->file_size > 0 && map_window(corpus, 0) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return 0;
+}
+
+void corpus_close(Corpus* corpus)
+{
+    if (!corpus || corpus->fd < 0) return;
+
+    if (corpus->window)
+        munmap(corpus->window, corpus->window_size);
+
+    free(corpus->last_line);
+    close(corpus->fd);
+
+    memset(corpus, 0, sizeof(*corpus));
+    corpus->fd = -1;
+}
+
+int corpus_rewind(Corpus* corpus)
+{
+    if (corpus->file_size == 0)
+        return 0;
+
+    /* Text windows are modified in place, so they are always remapped */
+    if (map_window(corpus, 0) < 0)
+        return -1;
+
+    corpus->position = 0;
+    return 0;
+}
+
+int corpus_next_line(Corpus* corpus, const char** line)
+{
+    if (corpus->format != CORPUS_FORMAT_TEXT)
+        return -1;
+
+    for (;;)
+    {
+        char* start = corpus->window + corpus->position;
+        const size_t remaining = corpus->window_size - corpus->position;
+
+        char* end = remaining > 0 ? (char*) memchr(start, '\n', remaining)
+                                  : NULL;
+        if (end)
+        {
+            *end = '\0';
+            if (end > start && end[-1] == '\r')
+                end[-1] = '\0';
+
+            corpus->position += (size_t) (end - start) + 1;
+            *line = start;
+            return 1;
+        }
+
+        const size_t offset = corpus_get_offset(corpus);
+        if (corpus->window_offset + corpus->window_size == corpus->file_size)
+        {
+            if (remaining == 0)
+                return 0;
+
+            /* There may be no space for terminating zero in mapping */
+            free(corpus->last_line);
+            corpus->last_line = strndup(start, remaining);
+            if (!corpus->last_line)
+                return -1;
+
+            corpus->position = corpus->window_size;
+            *line = corpus->last_line;
+            return 1;
+        }
+
+        /* Line does not fit into window */
+        if (align_to_page(offset) == corpus->window_offset)
+            return -1;
+
+        if (map_window(corpus, align_to_page(offset)) < 0)
+            return -1;
+        corpus->position = offset - corpus->window_offset;
+    }
+}
+
+int corpus_next_record(Corpus* corpus, size_t width, const void** record)
+{
+    if (corpus->format != CORPUS_FORMAT_BINARY)
+        return -1;
+
+    for (;;)
+    {
+        if (corpus->position + width <= corpus->window_size)
+        {
+            *record = corpus->window + corpus->position;
+            corpus->position += width;
+            return 1;
+        }
+
+        /* Partial record at the end of file is an error */
+        const size_t offset = corpus_get_offset(corpus);
+        if (corpus->window_offset + corpus->window_size == corpus->file_size)
+            return offset == corpus->file_size ? 0 : -1;
+
+        if (align_to_page(offset) == corpus->window_offset)
+            return -1;
+
+        if (map_window(corpus, align_to_page(offset)) < 0)
+            return -1;
+        corpus->position = offset - corpus->window_offset;
+    }
+}
+
+int corpus_next(Corpus* corpus, const char** key)
+{
+    return corpus_next_line(corpus, key);
+}
+
+int corpus_next(Corpus* corpus, int32_t* key)
+{
+    return next_number(corpus, key);
+}
+
+int corpus_next(Corpus* corpus, uint32_t* key)
+{
+    return next_number(corpus, key);
+}
+
+int corpus_next(Corpus* corpus, double* key)
+{
+    return next_number(corpus, key);
+}
+
+int corpus_parse_format(const char* name, corpus_format* format)
+{
+    for (size_t i = 0; i < CORPUS_FORMAT_COUNT; ++i)
+    {
+        if (strcasecmp(CORPUS_FORMAT_NAMES[i], name) == 0)
+        {
+            *format = (corpus_format) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+static int map_window(Corpus* corpus, size_t offset)
+{
+    if (corpus->window)
+        munmap(corpus->window, corpus->window_size);
+
+    const size_t size = corpus->file_size - offset < CORPUS_WINDOW_SIZE
+                      ? corpus->file_size - offset
+                      : CORPUS_WINDOW_SIZE;
+    const int protection = corpus->format == CORPUS_FORMAT_TEXT
+                         ? PROT_READ | PROT_WRITE
+                         : PROT_READ;
+
+    void* window = mmap(NULL, size, protection, MAP_PRIVATE,
+                        corpus->fd, (off_t) offset);
+    if (window == MAP_FAILED)
+    {
+        corpus->window = NULL;
+        corpus->window_size = 0;
+        return -1;
+    }
+
+    madvise(window, size, MADV_SEQUENTIAL);
+
+    corpus->window = (char*) window;
+    corpus->window_offset = offset;
+    corpus->window_size = size;
+
+    return 0;
+}
+
+template <typename Key>
+static int next_number(Corpus* corpus, Key* key)
+{
+    if (corpus->format == CORPUS_FORMAT_BINARY)
+    {
+        const void* record = NULL;
+        const int status = corpus_next_record(corpus, sizeof(*key), &record);
+        if (status > 0)
+            memcpy(key, record, sizeof(*key));
+        return status;
+    }
+
+    const char* line = NULL;
+    const int status = corpus_next_line(corpus, &line);
+    if (status <= 0)
+        return status;
+
+    return parse_key(line, key) < 0 ? -1 : 1;
+}
+
+static int parse_key(const char* line, int32_t* key)
+{
+    char* end = NULL;
+    errno = 0;
+    const long value = strtol(line, &end, 10);
+    if (end == line || *end != '\0' || errno != 0
+            || value < INT32_MIN || value > INT32_MAX)
+        return -1;
+
+    *key = (int32_t) value;
+    return 0;
+}
+
+static int parse_key(const char* line, uint32_t* key)
+{
+    char* end = NULL;
+    errno = 0;
+    const unsigned long value = strtoul(line, &end, 10);
+    if (end == line || *end != '\0' || errno != 0 || value > UINT32_MAX)
+        return -1;
+
+    *key = (uint32_t) value;
+    return 0;
+}
+
+static int parse_key(const char* line, double* key)
+{
+    char* end = NULL;
+    errno = 0;
+    const double value = strtod(line, &end);
+    if (end == line || *end != '\0' || errno != 0)
+        return -1;
+
+    *key = value;
+    return 0;
+}
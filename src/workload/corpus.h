@@ -0,0 +1,134 @@
+/**
+ * @file corpus.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Streaming key corpus files
+ *
+ * Text corpus contains one key per line. Binary corpus is an array of
+ * fixed-width keys in native byte order, width is defined by key type.
+ * Corpus is mapped in windows of `CORPUS_WINDOW_SIZE` bytes, so files
+ * larger than memory can be processed. Text windows are mapped privately
+ * and line breaks are replaced with terminating zeros in place.
+ *
+ * @version 0.1
+ * @date 2023-05-28
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __WORKLOAD_CORPUS_H
+#define __WORKLOAD_CORPUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+enum corpus_format
+{
+    /** Newline-delimited keys, numbers are parsed with `strto*` */
+    CORPUS_FORMAT_TEXT   = 0,
+    /** Raw fixed-width keys */
+    CORPUS_FORMAT_BINARY = 1,
+    CORPUS_FORMAT_COUNT
+};
+
+static const char* const CORPUS_FORMAT_NAMES[CORPUS_FORMAT_COUNT] = {
+    "text",
+    "binary",
+};
+
+static const size_t CORPUS_WINDOW_SIZE = 64lu << 20;
+
+struct Corpus
+{
+    int fd;
+    corpus_format format;
+    size_t file_size;
+
+    char* window;
+    /** Offset of window in file, multiple of page size */
+    size_t window_offset;
+    size_t window_size;
+    /** Read position relative to window */
+    size_t position;
+
+    /** Copy of last line, if it is not terminated by line break */
+    char* last_line;
+};
+
+/**
+ * @brief Open corpus file
+ *
+ * @param[in]  path     - Corpus file path
+ * @param[in]  format   - Corpus file format
+ * @param[out] corpus   - Opened corpus
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int corpus_open(const char* path, corpus_format format, Corpus* corpus);
+
+/**
+ * @brief Close corpus file
+ *
+ * @param[inout] corpus - Opened corpus
+ */
+void corpus_close(Corpus* corpus);
+
+/**
+ * @brief Restart reading from the beginning of corpus
+ *
+ * @param[inout] corpus - Opened corpus
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int corpus_rewind(Corpus* corpus);
+
+/**
+ * @brief Get number of bytes consumed so far
+ */
+__always_inline
+static size_t corpus_get_offset(const Corpus* corpus)
+{
+    return corpus->window_offset + corpus->position;
+}
+
+/**
+ * @brief Read next line of text corpus. Line is valid until next read.
+ *
+ * @param[inout] corpus - Opened corpus
+ * @param[out]   line   - Zero-terminated line without line break
+ *
+ * @return 1 if line was read, 0 at end of corpus, -1 upon error
+ */
+int corpus_next_line(Corpus* corpus, const char** line);
+
+/**
+ * @brief Read next record of binary corpus. Record is valid until next
+ * read and is not necessarily aligned.
+ *
+ * @param[inout] corpus - Opened corpus
+ * @param[in]    width  - Record size in bytes
+ * @param[out]   record - Record start
+ *
+ * @return 1 if record was read, 0 at end of corpus, -1 upon error
+ */
+int corpus_next_record(Corpus* corpus, size_t width, const void** record);
+
+/**
+ * @brief Read next key of corresponding type from text or binary corpus.
+ * String keys are supported by text corpora only.
+ *
+ * @return 1 if key was read, 0 at end of corpus, -1 upon error
+ */
+int corpus_next(Corpus* corpus, const char** key);
+int corpus_next(Corpus* corpus, int32_t*     key);
+int corpus_next(Corpus* corpus, uint32_t*    key);
+int corpus_next(Corpus* corpus, double*      key);
+
+/**
+ * @brief Parse corpus format name
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int corpus_parse_format(const char* name, corpus_format* format);
+
+#endif /* corpus.h */
@@ -0,0 +1,61 @@
+#include "latency.h"
+
+static const size_t sub_count = 1lu << LATENCY_SUB_BITS;
+static const size_t half_sub_count = sub_count / 2;
+
+__always_inline
+static size_t get_bucket(uint64_t value)
+{
+    if (value < sub_count)
+        return value;
+
+    const size_t msb   = 63 - (size_t) __builtin_clzl(value);
+    const size_t shift = msb - LATENCY_SUB_BITS + 1;
+
+    /* Top LATENCY_SUB_BITS bits of value are in [half_sub_count, sub_count) */
+    return shift * half_sub_count + (value >> shift);
+}
+
+__always_inline
+static uint64_t get_bucket_max(size_t bucket)
+{
+    if (bucket < sub_count)
+        return bucket;
+
+    const size_t shift = bucket / half_sub_count - 1;
+    const uint64_t top = bucket % half_sub_count + half_sub_count;
+
+    return ((top + 1) << shift) - 1;
+}
+
+void latency_histogram_record(LatencyHistogram* histogram, uint64_t value)
+{
+    ++ histogram->counts[get_bucket(value)];
+    ++ histogram->total;
+    if (value > histogram->max)
+        histogram->max = value;
+}
+
+uint64_t latency_histogram_percentile(const LatencyHistogram* histogram,
+                                      double percentile)
+{
+    if (histogram->total == 0)
+        return 0;
+
+    uint64_t target = (uint64_t) (percentile * (double) histogram->total);
+    if (target >= histogram->total)
+        target = histogram->total - 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LATENCY_BUCKET_COUNT; ++i)
+    {
+        seen += histogram->counts[i];
+        if (seen > target)
+        {
+            const uint64_t bucket_max = get_bucket_max(i);
+            return bucket_max < histogram->max ? bucket_max : histogram->max;
+        }
+    }
+
+    return histogram->max;
+}
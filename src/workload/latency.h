@@ -0,0 +1,79 @@
+/**
+ * @file latency.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief Log-linear latency histograms of individual table operations
+ *
+ * @version 0.1
+ * @date 2023-05-23
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __WORKLOAD_LATENCY_H
+#define __WORKLOAD_LATENCY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <x86intrin.h>
+
+/* Every power of two is split into 2^(LATENCY_SUB_BITS - 1) buckets,
+ * giving relative error below 1/16 */
+static const size_t LATENCY_SUB_BITS = 5;
+static const size_t LATENCY_BUCKET_COUNT =
+                (64 - LATENCY_SUB_BITS + 2) << (LATENCY_SUB_BITS - 1);
+
+/**
+ * @brief HDR-style histogram of values in timestamp counter ticks
+ */
+struct LatencyHistogram
+{
+    uint64_t counts[LATENCY_BUCKET_COUNT];
+    uint64_t total;
+    uint64_t max;
+};
+
+/**
+ * @brief Latencies of workload commands
+ */
+struct LatencyRecorder
+{
+    LatencyHistogram insert;
+    LatencyHistogram erase;
+    LatencyHistogram contains;
+
+    /** Commands which rehashed or grew table, including same-size rehashes
+     * of adaptive tables, also counted in histogram of their command */
+    LatencyHistogram rehash;
+};
+
+/**
+ * @brief Add value to histogram
+ *
+ * @param[inout] histogram  - Histogram
+ * @param[in]    value      - Recorded value
+ */
+void latency_histogram_record(LatencyHistogram* histogram, uint64_t value);
+
+/**
+ * @brief Get value below which given fraction of recorded values lies.
+ * Result is the highest value in the corresponding bucket.
+ *
+ * @param[in] histogram     - Histogram
+ * @param[in] percentile    - Fraction of values in range [0, 1]
+ *
+ * @return Percentile value, 0 for empty histogram
+ */
+uint64_t latency_histogram_percentile(const LatencyHistogram* histogram,
+                                      double percentile);
+
+/**
+ * @brief Read timestamp counter after preceding instructions completed
+ */
+__always_inline
+static uint64_t latency_now(void)
+{
+    unsigned aux = 0;
+    return __rdtscp(&aux);
+}
+
+#endif /* latency.h */
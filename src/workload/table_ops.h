@@ -0,0 +1,330 @@
+/**
+ * @file table_ops.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief Uniform static interface over dynamic hash tables, used to
+ * instantiate workloads for every table type
+ *
+ * @version 0.1
+ * @date 2023-05-21
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __WORKLOAD_TABLE_OPS_H
+#define __WORKLOAD_TABLE_OPS_H
+
+#include "hash_table/open_addr_hash_table.h"
+#include "hash_table/closed_addr_hash_table.h"
+#include "hash_table/fixed_hash_table.h"
+#include "hash_table/hopscotch_hash_table.h"
+#include "hash_table/hybrid_set.h"
+
+#include "baselines.h"
+
+template <open_addr_probe Probe>
+struct ProbedOpenAddrOps
+{
+    typedef ProbedOpenAddrHashTable<Probe> table_t;
+
+    static void ctor(table_t* table, table_hash hash)
+                        { open_addr_hash_table_ctor(table, hash); }
+    static void ctor(table_t* table, table_hash hash,
+                     const TableAllocator* allocator)
+                        { open_addr_hash_table_ctor(table, hash, allocator); }
+    static void dtor(table_t* table)
+                        { open_addr_hash_table_dtor(table); }
+    static int  insert  (table_t* table, uint32_t key)
+                        { return open_addr_hash_table_insert(table, key); }
+    static int  erase   (table_t* table, uint32_t key)
+                        { return open_addr_hash_table_erase(table, key); }
+    static int  contains(table_t* table, uint32_t key)
+                        { return open_addr_hash_table_contains(table, key); }
+    static size_t capacity(const table_t* table) { return table->size; }
+    static size_t rehash_count(const table_t* table)
+                        { return table->rehash_count; }
+    /** Bytes of table storage, excluding allocator overhead */
+    static size_t footprint(const table_t* table)
+                        { return table->size * sizeof(*table->data); }
+};
+
+struct OpenAddrOps : ProbedOpenAddrOps<OPEN_ADDR_PROBE_LINEAR>
+{
+    static constexpr const char* name = "open_addr";
+    static constexpr const char* test_name = "open_addr_hash_table";
+};
+
+struct OpenAddrTriangularOps : ProbedOpenAddrOps<OPEN_ADDR_PROBE_TRIANGULAR>
+{
+    static constexpr const char* name = "open_addr_triangular";
+    static constexpr const char* test_name =
+                                    "open_addr_triangular_hash_table";
+};
+
+struct OpenAddrDoubleOps : ProbedOpenAddrOps<OPEN_ADDR_PROBE_DOUBLE>
+{
+    static constexpr const char* name = "open_addr_double";
+    static constexpr const char* test_name = "open_addr_double_hash_table";
+};
+
+struct OpenAddrCacheLineOps : ProbedOpenAddrOps<OPEN_ADDR_PROBE_CACHE_LINE>
+{
+    static constexpr const char* name = "open_addr_cache_line";
+    static constexpr const char* test_name =
+                                    "open_addr_cache_line_hash_table";
+};
+
+struct OpenAddrAdaptiveOps : OpenAddrOps
+{
+    static constexpr const char* name = "open_addr_adaptive";
+    static constexpr const char* test_name = "open_addr_adaptive_hash_table";
+
+    static void ctor(table_t* table, table_hash hash)
+                        { open_addr_hash_table_ctor(table, hash);
+                          open_addr_hash_table_enable_tuning(table); }
+    static void ctor(table_t* table, table_hash hash,
+                     const TableAllocator* allocator)
+                        { open_addr_hash_table_ctor(table, hash, allocator);
+                          open_addr_hash_table_enable_tuning(table); }
+};
+
+struct HopscotchOps
+{
+    typedef HopscotchHashTable table_t;
+
+    static constexpr const char* name = "hopscotch";
+    static constexpr const char* test_name = "hopscotch_hash_table";
+
+    static void ctor(table_t* table, table_hash hash)
+                        { hopscotch_hash_table_ctor(table, hash); }
+    static void ctor(table_t* table, table_hash hash,
+                     const TableAllocator* allocator)
+                        { hopscotch_hash_table_ctor(table, hash, allocator); }
+    static void dtor(table_t* table)
+                        { hopscotch_hash_table_dtor(table); }
+    static int  insert  (table_t* table, uint32_t key)
+                        { return hopscotch_hash_table_insert(table, key); }
+    static int  erase   (table_t* table, uint32_t key)
+                        { return hopscotch_hash_table_erase(table, key); }
+    static int  contains(table_t* table, uint32_t key)
+                        { return hopscotch_hash_table_contains(table, key); }
+    static size_t capacity(const table_t* table) { return table->size; }
+    static size_t rehash_count(const table_t* table)
+                        { return table->rehash_count; }
+    /** Bytes of table storage, excluding allocator overhead */
+    static size_t footprint(const table_t* table)
+                        { return table->size * sizeof(*table->data)
+                               + table->size / 8; }
+};
+
+struct ClosedAddrOps
+{
+    typedef ClosedAddrHashTable table_t;
+
+    static constexpr const char* name = "closed_addr";
+    static constexpr const char* test_name = "closed_addr_hash_table";
+
+    static void ctor(table_t* table, table_hash hash)
+                        { closed_addr_hash_table_ctor(table, hash); }
+    static void ctor(table_t* table, table_hash hash,
+                     const TableAllocator* allocator)
+                        { closed_addr_hash_table_ctor(table, hash,
+                                                      allocator); }
+    static void dtor(table_t* table)
+                        { closed_addr_hash_table_dtor(table); }
+    static int  insert  (table_t* table, uint32_t key)
+                        { return closed_addr_hash_table_insert(table, key); }
+    static int  erase   (table_t* table, uint32_t key)
+                        { return closed_addr_hash_table_erase(table, key); }
+    static int  contains(table_t* table, uint32_t key)
+                        { return closed_addr_hash_table_contains(table, key); }
+    static size_t capacity(const table_t* table) { return table->bucket_count; }
+    static size_t rehash_count(const table_t* table)
+                        { return table->rehash_count; }
+    /** Bytes of table storage, excluding allocator overhead */
+    static size_t footprint(const table_t* table)
+                        { return (table->bucket_count + table->distinct_count)
+                                                * sizeof(*table->buckets); }
+};
+
+struct ClosedAddrBloomOps : ClosedAddrOps
+{
+    static constexpr const char* name = "closed_addr_bloom";
+    static constexpr const char* test_name = "closed_addr_bloom_hash_table";
+
+    static void ctor(table_t* table, table_hash hash)
+                        { closed_addr_hash_table_ctor(table, hash);
+                          closed_addr_hash_table_enable_filter(table); }
+    static size_t footprint(const table_t* table)
+                        { return ClosedAddrOps::footprint(table)
+                               + (table->filter.blocks
+                                    ? sizeof(*table->filter.blocks)
+                                            << table->filter.block_exp
+                                    : 0); }
+};
+
+struct ClosedAddrAdaptiveOps : ClosedAddrOps
+{
+    static constexpr const char* name = "closed_addr_adaptive";
+    static constexpr const char* test_name =
+                                    "closed_addr_adaptive_hash_table";
+
+    static void ctor(table_t* table, table_hash hash)
+                        { closed_addr_hash_table_ctor(table, hash);
+                          closed_addr_hash_table_enable_tuning(table); }
+    static void ctor(table_t* table, table_hash hash,
+                     const TableAllocator* allocator)
+                        { closed_addr_hash_table_ctor(table, hash,
+                                                      allocator);
+                          closed_addr_hash_table_enable_tuning(table); }
+};
+
+struct HybridSetOps
+{
+    typedef HybridSet table_t;
+
+    static constexpr const char* name = "hybrid";
+    static constexpr const char* test_name = "hybrid_set";
+
+    static void ctor(table_t* table, table_hash hash)
+                        { hybrid_set_ctor(table, hash); }
+    static void ctor(table_t* table, table_hash hash,
+                     const TableAllocator* allocator)
+                        { hybrid_set_ctor(table, hash, allocator); }
+    static void dtor(table_t* table)
+                        { hybrid_set_dtor(table); }
+    static int  insert  (table_t* table, uint32_t key)
+                        { return hybrid_set_insert(table, key); }
+    static int  erase   (table_t* table, uint32_t key)
+                        { return hybrid_set_erase(table, key); }
+    static int  contains(table_t* table, uint32_t key)
+                        { return hybrid_set_contains(table, key); }
+    /** Slots of hash table, or keys representable by chunks */
+    static size_t capacity(const table_t* table)
+                        { return table->mode == HYBRID_SET_HASH
+                               ? table->table.size
+                               : table->chunk_count << 16; }
+    static size_t rehash_count(const table_t* table)
+                        { return table->rehash_count
+                               + (table->mode == HYBRID_SET_HASH
+                                    ? table->table.rehash_count
+                                    : 0); }
+    /** Bytes of table storage, excluding allocator overhead */
+    static size_t footprint(const table_t* table)
+                        { return hybrid_set_footprint(table); }
+};
+
+/**
+ * Table hash is ignored, as hash function is a template parameter. Bucket
+ * count is not changed by insertion, so default one is chosen to keep chains
+ * short for largest tables.
+ */
+template <HashPresetInt::hash_fn* Hash>
+struct FixedOps
+{
+    typedef FixedHashTable<HashPresetInt, Hash> table_t;
+
+    static constexpr const char* name = "fixed";
+    static constexpr const char* test_name = "fixed_hash_table";
+
+    static const size_t default_bucket_count = 1lu << 16;
+
+    static void ctor(table_t* table, [[maybe_unused]] table_hash hash)
+                        { fixed_hash_table_ctor(table, default_bucket_count); }
+    static void ctor(table_t* table, [[maybe_unused]] table_hash hash,
+                     size_t bucket_count)
+                        { fixed_hash_table_ctor(table, bucket_count); }
+    static void dtor(table_t* table)
+                        { fixed_hash_table_dtor(table); }
+    static int  insert  (table_t* table, uint32_t key)
+                        { return fixed_hash_table_add_key(table,
+                                                          (int32_t) key); }
+    static int  contains(table_t* table, uint32_t key)
+                        { return fixed_hash_table_has_key(table,
+                                                          (int32_t) key); }
+    static size_t capacity(const table_t* table) { return table->capacity; }
+    /** Bytes of table storage, excluding allocator overhead */
+    static size_t footprint(const table_t* table)
+                        { return table->capacity * sizeof(*table->buckets); }
+};
+
+/* Baselines ignore table hash and count no rehashes, their growth is seen
+ * as change of capacity */
+
+struct StdSetOps
+{
+    typedef StdSetTable table_t;
+
+    static constexpr const char* name = "std_set";
+    static constexpr const char* test_name = "std_unordered_set";
+
+    static void ctor(table_t* table, [[maybe_unused]] table_hash hash)
+                        { std_set_ctor(table); }
+    static void dtor(table_t* table)
+                        { std_set_dtor(table); }
+    static int  insert  (table_t* table, uint32_t key)
+                        { return std_set_insert(table, key); }
+    static int  erase   (table_t* table, uint32_t key)
+                        { return std_set_erase(table, key); }
+    static int  contains(table_t* table, uint32_t key)
+                        { return std_set_contains(table, key); }
+    static size_t capacity(const table_t* table)
+                        { return table->set->bucket_count(); }
+    static size_t rehash_count([[maybe_unused]] const table_t* table)
+                        { return 0; }
+    /** Estimate for libstdc++: bucket array and one node per key */
+    static size_t footprint(const table_t* table)
+                        { return table->set->bucket_count() * sizeof(void*)
+                               + table->set->size() * 2 * sizeof(void*); }
+};
+
+struct SortedVectorOps
+{
+    typedef SortedVectorTable table_t;
+
+    static constexpr const char* name = "sorted_vector";
+    static constexpr const char* test_name = "sorted_vector";
+
+    static void ctor(table_t* table, [[maybe_unused]] table_hash hash)
+                        { sorted_vector_ctor(table); }
+    static void dtor(table_t* table)
+                        { sorted_vector_dtor(table); }
+    static int  insert  (table_t* table, uint32_t key)
+                        { return sorted_vector_insert(table, key); }
+    static int  erase   (table_t* table, uint32_t key)
+                        { return sorted_vector_erase(table, key); }
+    static int  contains(table_t* table, uint32_t key)
+                        { return sorted_vector_contains(table, key); }
+    static size_t capacity(const table_t* table) { return table->capacity; }
+    static size_t rehash_count([[maybe_unused]] const table_t* table)
+                        { return 0; }
+    static size_t footprint(const table_t* table)
+                        { return table->capacity * sizeof(*table->data); }
+};
+
+struct DenseBitsetOps
+{
+    typedef DenseBitsetTable table_t;
+
+    static constexpr const char* name = "bitset";
+    static constexpr const char* test_name = "dense_bitset";
+
+    static void ctor(table_t* table, [[maybe_unused]] table_hash hash)
+                        { dense_bitset_ctor(table); }
+    static void dtor(table_t* table)
+                        { dense_bitset_dtor(table); }
+    static int  insert  (table_t* table, uint32_t key)
+                        { return dense_bitset_insert(table, key); }
+    static int  erase   (table_t* table, uint32_t key)
+                        { return dense_bitset_erase(table, key); }
+    static int  contains(table_t* table, uint32_t key)
+                        { return dense_bitset_contains(table, key); }
+    static size_t capacity([[maybe_unused]] const table_t* table)
+                        { return DENSE_BITSET_BITS; }
+    static size_t rehash_count([[maybe_unused]] const table_t* table)
+                        { return 0; }
+    /** Reserved size, touched part may be much smaller */
+    static size_t footprint([[maybe_unused]] const table_t* table)
+                        { return DENSE_BITSET_BITS / 8; }
+};
+
+#endif /* table_ops.h */
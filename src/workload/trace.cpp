@@ -0,0 +1,317 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload.h"
+#include "trace.h"
+
+static const char trace_magic[8] = { 'H', 'T', 'T', 'R', 'A', 'C', 'E', '\0' };
+static const uint32_t trace_version = 1;
+
+struct Rng
+{
+    uint64_t state;
+};
+
+/* SplitMix64, see Steele et al. "Fast splittable pseudorandom number
+ * generators" */
+__always_inline
+static uint64_t rng_next(Rng* rng)
+{
+    uint64_t z = (rng->state += 0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+}
+
+__always_inline
+static double rng_uniform(Rng* rng)
+{
+    return (double) (rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+/* Zipfian generator as per Gray et al. "Quickly generating billion-record
+ * synthetic databases", as used in YCSB */
+struct Zipf
+{
+    uint64_t items;
+    double theta;
+    double alpha;
+    double zetan;
+    double eta;
+};
+
+/* Generalized harmonic number H(n, theta). Sum is exact for first 2^20
+ * terms, the rest is approximated with Euler-Maclaurin formula */
+static double zeta(uint64_t n, double theta)
+{
+    const uint64_t exact_terms = 1ull << 20;
+
+    double sum = 0;
+    for (uint64_t i = 1; i <= n && i <= exact_terms; ++i)
+        sum += 1.0 / pow((double) i, theta);
+
+    if (n <= exact_terms)
+        return sum;
+
+    const double a = (double) exact_terms;
+    const double b = (double) n;
+    const double f_a = pow(a, -theta);
+    const double f_b = pow(b, -theta);
+
+    sum += (pow(b, 1.0 - theta) - pow(a, 1.0 - theta)) / (1.0 - theta);
+    sum += (f_b - f_a) / 2;
+    sum += theta * (f_a / a - f_b / b) / 12;
+
+    return sum;
+}
+
+static void zipf_ctor(Zipf* zipf, uint64_t items, double theta)
+{
+    const double zetan = zeta(items, theta);
+
+    const double zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+
+    zipf->items = items;
+    zipf->theta = theta;
+    zipf->alpha = 1.0 / (1.0 - theta);
+    zipf->zetan = zetan;
+    zipf->eta   = (1.0 - pow(2.0 / (double) items, 1.0 - theta))
+                / (1.0 - zeta2 / zetan);
+}
+
+static uint64_t zipf_next(const Zipf* zipf, Rng* rng)
+{
+    const double u  = rng_uniform(rng);
+    const double uz = u * zipf->zetan;
+
+    if (uz < 1.0) return 0;
+    if (uz < 1.0 + pow(0.5, zipf->theta)) return 1;
+
+    const uint64_t rank = (uint64_t) ((double) zipf->items
+                    * pow(zipf->eta * u - zipf->eta + 1.0, zipf->alpha));
+    return rank < zipf->items ? rank : zipf->items - 1;
+}
+
+struct KeyGenerator
+{
+    const TraceSpec* spec;
+    Rng rng;
+    Zipf zipf;
+    uint64_t inserted;
+};
+
+static uint32_t next_key(KeyGenerator* gen, command cmd)
+{
+    const uint64_t range = gen->spec->key_range;
+
+    switch (gen->spec->keys)
+    {
+    case TRACE_KEYS_ZIPF:
+        /* Multiplication by odd constant is a bijection modulo 2^32 */
+        return (uint32_t) (zipf_next(&gen->zipf, &gen->rng) * 0x9E3779B1u);
+
+    case TRACE_KEYS_SEQUENTIAL:
+        if (cmd == CMD_INSERT)
+            return (uint32_t) gen->inserted++;
+        return (uint32_t) (rng_next(&gen->rng) % (gen->inserted + 1));
+
+    case TRACE_KEYS_HOTSET:
+    {
+        const uint64_t hot_range = range / 100 + 1;
+        if (rng_next(&gen->rng) % 10 != 0)
+            return (uint32_t) (rng_next(&gen->rng) % hot_range);
+        return (uint32_t) (rng_next(&gen->rng) % range);
+    }
+
+    case TRACE_KEYS_UNIFORM:
+    case TRACE_KEYS_COUNT:
+    default:
+        return (uint32_t) (rng_next(&gen->rng) % range);
+    }
+}
+
+__always_inline
+static command next_command(Rng* rng, trace_mix mix)
+{
+    const unsigned roll = (unsigned) (rng_next(rng) % 100);
+    if (roll < TRACE_MIX_PERCENTS[mix][0])
+        return CMD_INSERT;
+    if (roll < TRACE_MIX_PERCENTS[mix][0] + TRACE_MIX_PERCENTS[mix][1])
+        return CMD_ERASE;
+    return CMD_CONTAINS;
+}
+
+__always_inline
+static size_t get_keys_offset(uint64_t count)
+{
+    const size_t unaligned = sizeof(TraceHeader) + count;
+    return (unaligned + 7) & ~(size_t) 7;
+}
+
+int trace_generate(const char* path, const TraceSpec* spec)
+{
+    if (!path || !spec || spec->key_range == 0
+            || spec->keys >= TRACE_KEYS_COUNT || spec->mix >= TRACE_MIX_COUNT)
+        return -1;
+
+    uint8_t*  commands = NULL;
+    uint32_t* keys     = NULL;
+    FILE*     output   = NULL;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_TRUE(
+            commands = (uint8_t*)  calloc(spec->count + 8, sizeof(*commands)));
+        ASSERT_TRUE(
+            keys     = (uint32_t*) calloc(spec->count, sizeof(*keys)));
+        ASSERT_TRUE(
+            output   = fopen(path, "wb"));
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        free(commands);
+        free(keys);
+        return -1;
+    }
+    SAFE_BLOCK_END
+
+    KeyGenerator gen = {
+        .spec = spec,
+        .rng = { .state = spec->seed },
+        .zipf = {},
+        .inserted = 0
+    };
+    if (spec->keys == TRACE_KEYS_ZIPF)
+        zipf_ctor(&gen.zipf, spec->key_range, 0.99);
+
+    for (uint64_t i = 0; i < spec->count; ++i)
+    {
+        const command cmd = next_command(&gen.rng, spec->mix);
+        commands[i] = (uint8_t) cmd;
+        keys[i] = next_key(&gen, cmd);
+    }
+
+    TraceHeader header = {
+        .magic = {},
+        .version = trace_version,
+        .keys = spec->keys,
+        .mix = spec->mix,
+        .reserved = 0,
+        .count = spec->count,
+        .key_range = spec->key_range,
+        .seed = spec->seed
+    };
+    memcpy(header.magic, trace_magic, sizeof(trace_magic));
+
+    const size_t padding = get_keys_offset(spec->count)
+                         - sizeof(header) - spec->count;
+
+    int status = 0;
+    if (fwrite(&header, sizeof(header), 1, output) != 1
+     || fwrite(commands, 1, spec->count + padding, output)
+                                            != spec->count + padding
+     || fwrite(keys, sizeof(*keys), spec->count, output) != spec->count)
+        status = -1;
+
+    if (fclose(output) != 0)
+        status = -1;
+
+    free(commands);
+    free(keys);
+
+    return status;
+}
+
+int trace_map(const char* path, Trace* trace)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat info = {};
+    if (fstat(fd, &info) < 0 || (size_t) info.st_size < sizeof(TraceHeader))
+    {
+        close(fd);
+        return -1;
+    }
+
+    const size_t size = (size_t) info.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE,
+                         fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+        return -1;
+
+    const TraceHeader* header = (const TraceHeader*) mapping;
+    if (memcmp(header->magic, trace_magic, sizeof(trace_magic)) != 0
+            || header->version != trace_version
+            /* Bound count first, so that offset arithmetic cannot overflow */
+            || header->count > (size - sizeof(TraceHeader))
+                                        / (1 + sizeof(uint32_t))
+            || get_keys_offset(header->count)
+                    + header->count * sizeof(uint32_t) > size)
+    {
+        munmap(mapping, size);
+        return -1;
+    }
+
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    const uint8_t* bytes = (const uint8_t*) mapping;
+
+    trace->header = header;
+    trace->commands = bytes + sizeof(TraceHeader);
+    trace->keys = (const uint32_t*) (const void*)
+                            (bytes + get_keys_offset(header->count));
+    trace->count = header->count;
+    trace->mapping = mapping;
+    trace->mapping_size = size;
+
+    return 0;
+}
+
+void trace_unmap(Trace* trace)
+{
+    if (!trace || !trace->mapping) return;
+
+    munmap(trace->mapping, trace->mapping_size);
+    memset(trace, 0, sizeof(*trace));
+}
+
+int trace_parse_keys(const char* name, trace_keys* keys)
+{
+    for (size_t i = 0; i < TRACE_KEYS_COUNT; ++i)
+    {
+        if (strcasecmp(TRACE_KEYS_NAMES[i], name) == 0)
+        {
+            *keys = (trace_keys) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int trace_parse_mix(const char* name, trace_mix* mix)
+{
+    for (size_t i = 0; i < TRACE_MIX_COUNT; ++i)
+    {
+        if (strcasecmp(TRACE_MIX_NAMES[i], name) == 0)
+        {
+            *mix = (trace_mix) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
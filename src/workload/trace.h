@@ -0,0 +1,137 @@
+/**
+ * @file trace.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Pre-generated binary command traces
+ *
+ * Trace file consists of `TraceHeader`, `count` command bytes, padding to
+ * 8 bytes and `count` 32-bit keys, all in native byte order.
+ *
+ * @version 0.1
+ * @date 2023-05-25
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __WORKLOAD_TRACE_H
+#define __WORKLOAD_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum trace_keys
+{
+    /** Uniform keys in [0, key_range) */
+    TRACE_KEYS_UNIFORM      = 0,
+    /** Zipfian keys with exponent 0.99, hot keys scattered over key range */
+    TRACE_KEYS_ZIPF         = 1,
+    /** Inserted keys are consecutive, other commands use inserted ones */
+    TRACE_KEYS_SEQUENTIAL   = 2,
+    /** 90% of commands use hot 1% of key range */
+    TRACE_KEYS_HOTSET       = 3,
+    TRACE_KEYS_COUNT
+};
+
+static const char* const TRACE_KEYS_NAMES[TRACE_KEYS_COUNT] = {
+    "uniform",
+    "zipf",
+    "sequential",
+    "hotset",
+};
+
+enum trace_mix
+{
+    /** Insert, erase and lookup with equal probability */
+    TRACE_MIX_BALANCED      = 0,
+    /** 50% insert, 25% erase, 25% lookup */
+    TRACE_MIX_WEIGHTED      = 1,
+    /** 5% insert, 5% erase, 90% lookup */
+    TRACE_MIX_READ_HEAVY    = 2,
+    /** 30% insert, 50% erase, 20% lookup */
+    TRACE_MIX_DELETE_HEAVY  = 3,
+    TRACE_MIX_COUNT
+};
+
+static const char* const TRACE_MIX_NAMES[TRACE_MIX_COUNT] = {
+    "balanced",
+    "weighted",
+    "read_heavy",
+    "delete_heavy",
+};
+
+/** Probabilities of insert and erase in percent, rest are lookups */
+static const unsigned TRACE_MIX_PERCENTS[TRACE_MIX_COUNT][2] = {
+    { 33, 33 }, /* TRACE_MIX_BALANCED     */
+    { 50, 25 }, /* TRACE_MIX_WEIGHTED     */
+    {  5,  5 }, /* TRACE_MIX_READ_HEAVY   */
+    { 30, 50 }, /* TRACE_MIX_DELETE_HEAVY */
+};
+
+struct TraceSpec
+{
+    trace_keys keys;
+    trace_mix mix;
+    uint64_t count;
+    uint64_t key_range;
+    uint64_t seed;
+};
+
+struct TraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t keys;
+    uint32_t mix;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t key_range;
+    uint64_t seed;
+};
+
+struct Trace
+{
+    const TraceHeader* header;
+    /** Values of `command` */
+    const uint8_t* commands;
+    const uint32_t* keys;
+    size_t count;
+
+    void* mapping;
+    size_t mapping_size;
+};
+
+/**
+ * @brief Generate trace and write it to file
+ *
+ * @param[in] path  - Output file path
+ * @param[in] spec  - Trace parameters
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int trace_generate(const char* path, const TraceSpec* spec);
+
+/**
+ * @brief Map trace file into memory. Pages are populated in advance.
+ *
+ * @param[in]  path     - Trace file path
+ * @param[out] trace    - Mapped trace
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int trace_map(const char* path, Trace* trace);
+
+/**
+ * @brief Unmap trace file
+ *
+ * @param[inout] trace  - Mapped trace
+ */
+void trace_unmap(Trace* trace);
+
+/**
+ * @brief Parse key distribution or command mix name
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int trace_parse_keys(const char* name, trace_keys* keys);
+int trace_parse_mix (const char* name, trace_mix* mix);
+
+#endif /* trace.h */
@@ -0,0 +1,212 @@
+#include <stdlib.h>
+#include <strings.h>
+
+#include "table_ops.h"
+#include "workload.h"
+
+template <command_gen Gen>
+__always_inline
+static command next_command(void)
+{
+    if constexpr (Gen == CMD_GEN_RAND)
+        return (command) (rand() % 3);
+
+    int tmp = rand() % 4;
+    return tmp < 3 ? (command) tmp : CMD_INSERT;
+}
+
+template <typename Ops, command_gen Gen, bool Record>
+__always_inline
+static void run_commands(size_t repeat, table_hash hash,
+                         [[maybe_unused]] LatencyRecorder* recorder)
+{
+    srand(0);
+    typename Ops::table_t table = {};
+    Ops::ctor(&table, hash);
+
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        const command cmd = next_command<Gen>();
+        const uint32_t key = (uint32_t)rand();
+
+        [[maybe_unused]] uint64_t start = 0;
+        [[maybe_unused]] size_t capacity = 0;
+        [[maybe_unused]] size_t rehash_count = 0;
+        if constexpr (Record)
+        {
+            capacity = Ops::capacity(&table);
+            rehash_count = Ops::rehash_count(&table);
+            start = latency_now();
+        }
+
+        switch (cmd)
+        {
+        case CMD_INSERT:   Ops::insert  (&table, key); break;
+        case CMD_ERASE:    Ops::erase   (&table, key); break;
+        case CMD_CONTAINS: Ops::contains(&table, key); break;
+        default:
+            break;
+        }
+
+        if constexpr (Record)
+        {
+            const uint64_t elapsed = latency_now() - start;
+            switch (cmd)
+            {
+            case CMD_INSERT:
+                latency_histogram_record(&recorder->insert, elapsed);
+                break;
+            case CMD_ERASE:
+                latency_histogram_record(&recorder->erase, elapsed);
+                break;
+            case CMD_CONTAINS:
+                latency_histogram_record(&recorder->contains, elapsed);
+                break;
+            default:
+                break;
+            }
+
+            /* Adaptive tables may rehash at the same size on any command */
+            if (Ops::rehash_count(&table) != rehash_count
+                    || Ops::capacity(&table) != capacity)
+                latency_histogram_record(&recorder->rehash, elapsed);
+        }
+    }
+
+    Ops::dtor(&table);
+}
+
+template <typename Ops, command_gen Gen>
+static void run_workload(size_t repeat, table_hash hash)
+{
+    run_commands<Ops, Gen, false>(repeat, hash, NULL);
+}
+
+template <typename Ops, command_gen Gen>
+static void run_workload_recorded(size_t repeat, table_hash hash,
+                                  LatencyRecorder* recorder)
+{
+    run_commands<Ops, Gen, true>(repeat, hash, recorder);
+}
+
+template <typename Ops>
+static void replay_trace(const Trace* trace, table_hash hash)
+{
+    typename Ops::table_t table = {};
+    Ops::ctor(&table, hash);
+
+    const uint8_t*  commands = trace->commands;
+    const uint32_t* keys     = trace->keys;
+    const size_t    count    = trace->count;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        switch ((command) commands[i])
+        {
+        case CMD_INSERT:   Ops::insert  (&table, keys[i]); break;
+        case CMD_ERASE:    Ops::erase   (&table, keys[i]); break;
+        case CMD_CONTAINS: Ops::contains(&table, keys[i]); break;
+        default:
+            break;
+        }
+    }
+
+    Ops::dtor(&table);
+}
+
+template <typename Ops>
+static int load_corpus(Corpus* corpus, table_hash hash, size_t* key_count)
+{
+    typename Ops::table_t table = {};
+    Ops::ctor(&table, hash);
+
+    uint32_t key = 0;
+    size_t count = 0;
+    int status = 0;
+
+    while ((status = corpus_next(corpus, &key)) > 0)
+    {
+        Ops::insert(&table, key);
+        ++ count;
+    }
+
+    if (status == 0)
+        status = corpus_rewind(corpus);
+
+    if (status == 0)
+        while ((status = corpus_next(corpus, &key)) > 0)
+            Ops::contains(&table, key);
+
+    Ops::dtor(&table);
+
+    if (key_count)
+        *key_count = count;
+
+    return status < 0 ? -1 : 0;
+}
+
+#define WORKLOAD_VARIANT(ops, gen)                                          \
+    { ops::name, ops::test_name, gen, run_workload<ops, gen>,              \
+                                      run_workload_recorded<ops, gen>,     \
+                                      replay_trace<ops>,                   \
+                                      load_corpus<ops> }
+
+const WorkloadVariant WORKLOAD_VARIANTS[] = {
+    WORKLOAD_VARIANT(OpenAddrOps,           CMD_GEN_RAND),
+    WORKLOAD_VARIANT(OpenAddrOps,           CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(OpenAddrTriangularOps, CMD_GEN_RAND),
+    WORKLOAD_VARIANT(OpenAddrTriangularOps, CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(OpenAddrDoubleOps,     CMD_GEN_RAND),
+    WORKLOAD_VARIANT(OpenAddrDoubleOps,     CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(OpenAddrCacheLineOps,  CMD_GEN_RAND),
+    WORKLOAD_VARIANT(OpenAddrCacheLineOps,  CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(OpenAddrAdaptiveOps,   CMD_GEN_RAND),
+    WORKLOAD_VARIANT(OpenAddrAdaptiveOps,   CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(HopscotchOps,          CMD_GEN_RAND),
+    WORKLOAD_VARIANT(HopscotchOps,          CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(ClosedAddrOps,         CMD_GEN_RAND),
+    WORKLOAD_VARIANT(ClosedAddrOps,         CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(ClosedAddrBloomOps,    CMD_GEN_RAND),
+    WORKLOAD_VARIANT(ClosedAddrBloomOps,    CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(ClosedAddrAdaptiveOps, CMD_GEN_RAND),
+    WORKLOAD_VARIANT(ClosedAddrAdaptiveOps, CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(HybridSetOps,          CMD_GEN_RAND),
+    WORKLOAD_VARIANT(HybridSetOps,          CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(StdSetOps,             CMD_GEN_RAND),
+    WORKLOAD_VARIANT(StdSetOps,             CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(SortedVectorOps,       CMD_GEN_RAND),
+    WORKLOAD_VARIANT(SortedVectorOps,       CMD_GEN_WEIGHTED),
+    WORKLOAD_VARIANT(DenseBitsetOps,        CMD_GEN_RAND),
+    WORKLOAD_VARIANT(DenseBitsetOps,        CMD_GEN_WEIGHTED),
+};
+
+const size_t WORKLOAD_VARIANT_COUNT =
+                    sizeof(WORKLOAD_VARIANTS) / sizeof(*WORKLOAD_VARIANTS);
+
+const WorkloadVariant* workload_find(const char* table_name,
+                                     const char* cmd_gen_name)
+{
+    for (size_t i = 0; i < WORKLOAD_VARIANT_COUNT; ++i)
+    {
+        const WorkloadVariant* variant = &WORKLOAD_VARIANTS[i];
+        if (strcasecmp(variant->table_name, table_name) == 0
+         && strcasecmp(COMMAND_GEN_NAMES[variant->cmd_gen], cmd_gen_name) == 0)
+            return variant;
+    }
+
+    return NULL;
+}
+
+int workload_parse_hash(const char* name, table_hash* hash)
+{
+    for (size_t i = 0; i < TABLE_HASH_COUNT; ++i)
+    {
+        if (strcasecmp(TABLE_HASH_NAMES[i], name) == 0)
+        {
+            *hash = (table_hash) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file workload.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief Random command workloads over dynamic hash tables
+ *
+ * @version 0.1
+ * @date 2023-05-21
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __WORKLOAD_WORKLOAD_H
+#define __WORKLOAD_WORKLOAD_H
+
+#include <stddef.h>
+
+#include "hash_table/hashes/table_hash.h"
+
+#include "corpus.h"
+#include "latency.h"
+#include "trace.h"
+
+enum command
+{
+    CMD_INSERT = 0,
+    CMD_ERASE = 1,
+    CMD_CONTAINS = 2
+};
+
+enum command_gen
+{
+    /** Insert, erase and lookup with equal probability */
+    CMD_GEN_RAND = 0,
+    /** Insertion with probability 50%, erase and lookup 25% each */
+    CMD_GEN_WEIGHTED = 1,
+};
+
+static const char* const COMMAND_GEN_NAMES[] = {
+    "rand_cmd",
+    "weighted_cmd",
+};
+
+/**
+ * @brief Run `repeat` random commands against new table
+ *
+ * @param[in] repeat    - Number of commands
+ * @param[in] hash      - Hash function used by table
+ */
+typedef void workload_fn(size_t repeat, table_hash hash);
+
+/**
+ * @brief Run `repeat` random commands against new table, recording
+ * latency of every command
+ *
+ * @param[in]    repeat     - Number of commands
+ * @param[in]    hash       - Hash function used by table
+ * @param[inout] recorder   - Latency histograms
+ */
+typedef void workload_recorded_fn(size_t repeat, table_hash hash,
+                                  LatencyRecorder* recorder);
+
+/**
+ * @brief Replay pre-generated trace against new table
+ *
+ * @param[in] trace     - Mapped trace
+ * @param[in] hash      - Hash function used by table
+ */
+typedef void workload_replay_fn(const Trace* trace, table_hash hash);
+
+/**
+ * @brief Insert every key of corpus into new table, then look every key up
+ *
+ * @param[inout] corpus     - Opened corpus of unsigned 32-bit keys
+ * @param[in]    hash       - Hash function used by table
+ * @param[out]   key_count  - Number of keys in corpus (may be NULL)
+ *
+ * @return 0 upon success, -1 if corpus could not be read
+ */
+typedef int workload_corpus_fn(Corpus* corpus, table_hash hash,
+                               size_t* key_count);
+
+struct WorkloadVariant
+{
+    const char* table_name;
+    const char* test_name;
+    command_gen cmd_gen;
+    workload_fn* run;
+    workload_recorded_fn* run_recorded;
+    /** Does not depend on command generator */
+    workload_replay_fn* replay;
+    /** Does not depend on command generator */
+    workload_corpus_fn* load_corpus;
+};
+
+/** Every combination of table type and command generator */
+extern const WorkloadVariant WORKLOAD_VARIANTS[];
+extern const size_t WORKLOAD_VARIANT_COUNT;
+
+/**
+ * @brief Find workload by table type and command generator names
+ *
+ * @param[in] table_name    - Table type name (e.g. "open_addr")
+ * @param[in] cmd_gen_name  - Command generator name (e.g. "rand_cmd")
+ *
+ * @return Found workload, NULL if no such combination exists
+ */
+const WorkloadVariant* workload_find(const char* table_name,
+                                     const char* cmd_gen_name);
+
+/**
+ * @brief Parse table hash function name
+ *
+ * @param[in]  name - Hash function name (e.g. "siphash13")
+ * @param[out] hash - Parsed hash function
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int workload_parse_hash(const char* name, table_hash* hash);
+
+#endif /* workload.h */
@@ -3,6 +3,22 @@
 #include "test_utils/config.h"
 #include "test_cases/histogram.h"
 #include "test_cases/benchmark.h"
+#include "test_cases/adversarial.h"
+#include "test_cases/latency.h"
+#include "test_cases/counters.h"
+#include "test_cases/trace.h"
+#include "test_cases/working_set.h"
+#include "test_cases/memory.h"
+#include "test_cases/scaling.h"
+#include "test_cases/compare.h"
+#include "test_cases/batch_lookup.h"
+#include "test_cases/filter.h"
+#include "test_cases/allocators.h"
+#include "test_cases/extendible.h"
+#include "test_cases/probing.h"
+#include "test_cases/adaptive.h"
+#include "test_cases/hybrid.h"
+#include "test_cases/stats.h"
 
 int main(int argc, char** argv)
 {
@@ -15,6 +31,8 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    storage_set_backend(config.storage);
+
     argc -= parsed - 1;
     argv += parsed - 1;
 
@@ -22,8 +40,46 @@ int main(int argc, char** argv)
     {
     case TEST_HISTOGRAM:
         return run_test_histogram(argc, argv, &config);
+    case TEST_HISTOGRAM_SWEEP:
+        return run_test_histogram_sweep(argc, argv, &config);
+    case TEST_CORPUS_HISTOGRAM:
+        return run_test_corpus_histogram(argc, argv, &config);
+    case TEST_CORPUS_BENCHMARK:
+        return run_test_corpus_benchmark(argc, argv, &config);
+    case TEST_BATCH_LOOKUP:
+        return run_test_batch_lookup(argc, argv, &config);
+    case TEST_FILTER:
+        return run_test_filter(argc, argv, &config);
+    case TEST_ALLOCATORS:
+        return run_test_allocators(argc, argv, &config);
+    case TEST_EXTENDIBLE:
+        return run_test_extendible(argc, argv, &config);
+    case TEST_PROBING:
+        return run_test_probing(argc, argv, &config);
+    case TEST_ADAPTIVE:
+        return run_test_adaptive(argc, argv, &config);
+    case TEST_HYBRID:
+        return run_test_hybrid(argc, argv, &config);
+    case TEST_STATS:
+        return run_test_stats(argc, argv, &config);
     case TEST_BENCHMARK_FULL:
         return run_test_benchmark(argc, argv, &config);
+    case TEST_ADVERSARIAL:
+        return run_test_adversarial(argc, argv, &config);
+    case TEST_LATENCY:
+        return run_test_latency(argc, argv, &config);
+    case TEST_COUNTERS:
+        return run_test_counters(argc, argv, &config);
+    case TEST_TRACE:
+        return run_test_trace(argc, argv, &config);
+    case TEST_WORKING_SET:
+        return run_test_working_set(argc, argv, &config);
+    case TEST_MEMORY:
+        return run_test_memory(argc, argv, &config);
+    case TEST_SCALING:
+        return run_test_scaling(argc, argv, &config);
+    case TEST_COMPARE:
+        return run_test_compare(argc, argv, &config);
     case TEST_NONE:
     default:
         fprintf(stderr, "Invalid test case\n");
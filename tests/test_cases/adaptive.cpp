@@ -0,0 +1,200 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload/table_ops.h"
+#include "workload/workload.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/display.h"
+#include "test_utils/keys.h"
+
+#include "adaptive.h"
+
+static const size_t max_key_count = 1lu << 22;
+
+/* Strided keys with identity hash share `size / key_stride` buckets */
+static const uint32_t key_stride = 1024;
+
+static const table_hash tested_hashes[] = {
+    TABLE_HASH_FIBONACCI,
+    TABLE_HASH_IDENTITY,
+};
+static const size_t tested_hash_count =
+                            sizeof(tested_hashes) / sizeof(*tested_hashes);
+
+struct AdaptiveOptions
+{
+    size_t key_count;
+    size_t lookup_count;
+};
+
+typedef int adaptive_fn(FILE* output, const AdaptiveOptions* options,
+                        const KeyLookups* keys, key_set set,
+                        table_hash hash);
+
+template <typename Ops>
+static int run_adaptive(FILE* output, const AdaptiveOptions* options,
+                        const KeyLookups* keys, key_set set,
+                        table_hash hash);
+
+static adaptive_fn* const adaptive_runs[] = {
+    run_adaptive<OpenAddrOps>,
+    run_adaptive<OpenAddrAdaptiveOps>,
+    run_adaptive<ClosedAddrOps>,
+    run_adaptive<ClosedAddrAdaptiveOps>,
+};
+static const size_t adaptive_run_count =
+                            sizeof(adaptive_runs) / sizeof(*adaptive_runs);
+
+int run_test_adaptive(int argc, const char* const* argv,
+                      const TestConfig* config)
+{
+    FILE *output = NULL;
+    AdaptiveOptions options = {
+        .key_count = 1'000'000,
+        .lookup_count = 1'000'000
+    };
+    KeyLookups keys = {};
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 3, action_result,
+            "Expected at most number of keys and number of lookups");
+        if (argc > 1)
+            ASSERT_MESSAGE(options.key_count = strtoul(argv[1], NULL, 10),
+                           action_result > 0 && action_result <= max_key_count,
+                           "Number of keys must be in range [1, 4194304]");
+        if (argc > 2)
+            ASSERT_MESSAGE(options.lookup_count = strtoul(argv[2], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of lookups");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+
+        ASSERT_MESSAGE(
+            keys.hits = (uint32_t*) calloc(options.lookup_count,
+                                           sizeof(*keys.hits)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ASSERT_MESSAGE(
+            keys.misses = (uint32_t*) calloc(options.lookup_count,
+                                             sizeof(*keys.misses)),
+            action_result != NULL,
+            "Failed to allocate memory");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        free(keys.hits);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    if (!config->append_to_file)
+        fputs("name,hash,key_set,keys,capacity,bytes_per_key,insert_ns,"
+              "hit_ns,miss_ns,reseeds,final_hash\n", output);
+
+    const size_t total = KEY_SET_COUNT * tested_hash_count * adaptive_run_count;
+    size_t done = 0;
+    double last_ms = NAN;
+    int status = 0;
+
+    for (size_t set_index = 0; set_index < KEY_SET_COUNT; ++set_index)
+    {
+        const key_set set = (key_set) set_index;
+        generate_lookups(&keys, set, options.key_count, options.lookup_count,
+                         key_stride);
+
+        for (size_t i = 0; i < tested_hash_count && status == 0; ++i)
+        {
+            for (size_t j = 0; j < adaptive_run_count && status == 0; ++j)
+            {
+                progress_bar(done++, total, last_ms);
+                const uint64_t start_ns = bench_time_ns();
+
+                status = adaptive_runs[j](output, &options, &keys, set,
+                                          tested_hashes[i]);
+
+                last_ms = (double) (bench_time_ns() - start_ns) / 1e6;
+            }
+        }
+    }
+
+    progress_bar(total, total, NAN);
+    putchar('\n');
+
+    if (status != 0)
+        fputs("Error: Lookup results differ from inserted keys\n", stderr);
+
+    free(keys.hits);
+    free(keys.misses);
+    if (output != stdout)
+        fclose(output);
+
+    return status != 0;
+}
+
+/**
+ * @brief Insert all keys of set, then measure lookups of present and
+ * absent keys. Tuning happens during both phases.
+ */
+template <typename Ops>
+static int run_adaptive(FILE* output, const AdaptiveOptions* options,
+                        const KeyLookups* keys, key_set set,
+                        table_hash hash)
+{
+    const double lookup_count = (double) options->lookup_count;
+
+    typename Ops::table_t table = {};
+    Ops::ctor(&table, hash);
+
+    const uint64_t insert_start = bench_time_ns();
+    for (size_t i = 0; i < options->key_count; ++i)
+        Ops::insert(&table, get_key(set, i, key_stride));
+    const double insert_ns = (double) (bench_time_ns() - insert_start);
+
+    size_t found = 0;
+    const uint64_t hit_start = bench_time_ns();
+    for (size_t i = 0; i < options->lookup_count; ++i)
+        found += (size_t) Ops::contains(&table, keys->hits[i]);
+    const double hit_ns = (double) (bench_time_ns() - hit_start);
+
+    const uint64_t miss_start = bench_time_ns();
+    for (size_t i = 0; i < options->lookup_count; ++i)
+        found -= (size_t) Ops::contains(&table, keys->misses[i]);
+    const double miss_ns = (double) (bench_time_ns() - miss_start);
+
+    if (found != options->lookup_count)
+    {
+        Ops::dtor(&table);
+        return -1;
+    }
+
+    /* name,hash,key_set,keys,capacity,bytes_per_key,insert_ns,hit_ns,
+     * miss_ns,reseeds,final_hash */
+    fprintf(output, "%s,%s,%s,%zu,%zu,%.2lf,%.1lf,%.1lf,%.1lf,%zu,%s\n",
+                    Ops::test_name, TABLE_HASH_NAMES[hash],
+                    KEY_SET_NAMES[set], options->key_count,
+                    Ops::capacity(&table),
+                    (double) Ops::footprint(&table)
+                                        / (double) options->key_count,
+                    insert_ns / (double) options->key_count,
+                    hit_ns / lookup_count, miss_ns / lookup_count,
+                    table.tuner.reseed_count,
+                    TABLE_HASH_NAMES[table.hash.kind]);
+    fflush(output);
+
+    Ops::dtor(&table);
+    return 0;
+}
@@ -0,0 +1,31 @@
+/**
+ * @file adaptive.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-06-03
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_ADAPTIVE_H
+#define __TESTS_TEST_CASES_ADAPTIVE_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Compare open and closed addressing tables with and without adaptive
+ * mode on random, sequential and strided keys hashed by Fibonacci and
+ * identity hash. Test options are number of keys and number of lookups.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_adaptive(int argc, const char* const* argv,
+                      const TestConfig* config);
+
+#endif /* adaptive.h */
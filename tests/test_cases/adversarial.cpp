@@ -0,0 +1,146 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload/table_ops.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/display.h"
+
+#include "adversarial.h"
+
+static const size_t key_count = 10'000;
+static const size_t repeat = 5;
+
+/* Crafted keys share top `crafted_bits` bits of unseeded Fibonacci hash, so
+ * they collide in tables of up to `2^crafted_bits` slots and fill the first
+ * `2^-crafted_bits` part of larger ones */
+static const size_t crafted_bits = 12;
+
+static void generate_random_keys(uint32_t* keys, size_t count);
+static void generate_crafted_keys(uint32_t* keys, size_t count);
+
+template <typename Ops>
+static double measure_ns_per_op(table_hash hash, const uint32_t* keys,
+                                size_t count);
+
+template <typename Ops>
+static void run_table(FILE* output, const uint32_t* random_keys,
+                      const uint32_t* crafted_keys, size_t* done);
+
+int run_test_adversarial([[maybe_unused]] int argc,
+                         [[maybe_unused]] const char* const* argv,
+                         const TestConfig* config)
+{
+    FILE *output = NULL;
+    uint32_t *random_keys = NULL, *crafted_keys = NULL;
+
+    SAFE_BLOCK_START
+    {
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+
+        ASSERT_MESSAGE(
+            random_keys = (uint32_t*) calloc(key_count, sizeof(*random_keys)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ASSERT_MESSAGE(
+            crafted_keys = (uint32_t*) calloc(key_count, sizeof(*crafted_keys)),
+            action_result != NULL,
+            "Failed to allocate memory");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        free(random_keys);
+        if (output && output != stdout)
+            fclose(output);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    srand(0);
+    generate_random_keys(random_keys, key_count);
+    generate_crafted_keys(crafted_keys, key_count);
+
+    size_t done = 0;
+    run_table<OpenAddrOps>  (output, random_keys, crafted_keys, &done);
+    run_table<ClosedAddrOps>(output, random_keys, crafted_keys, &done);
+    putchar('\n');
+
+    free(random_keys);
+    free(crafted_keys);
+    if (output != stdout)
+        fclose(output);
+
+    return 0;
+}
+
+static void generate_random_keys(uint32_t* keys, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        keys[i] = (uint32_t) rand();
+}
+
+static void generate_crafted_keys(uint32_t* keys, size_t count)
+{
+    size_t found = 0;
+    for (uint32_t candidate = 1; found < count && candidate != 0; ++candidate)
+        if (fibonacci_hash(candidate, crafted_bits) == 0)
+            keys[found++] = candidate;
+}
+
+template <typename Ops>
+static void run_table(FILE* output, const uint32_t* random_keys,
+                      const uint32_t* crafted_keys, size_t* done)
+{
+    const size_t total = 2 * 2 * TABLE_HASH_COUNT;
+
+    for (size_t i = 0; i < TABLE_HASH_COUNT; ++i)
+    {
+        const table_hash hash = (table_hash) i;
+
+        progress_bar((*done)++, total, NAN);
+        fprintf(output, "%s,%s,random,%.3lf\n",
+                Ops::test_name, TABLE_HASH_NAMES[hash],
+                measure_ns_per_op<Ops>(hash, random_keys, key_count));
+
+        progress_bar((*done)++, total, NAN);
+        fprintf(output, "%s,%s,adversarial,%.3lf\n",
+                Ops::test_name, TABLE_HASH_NAMES[hash],
+                measure_ns_per_op<Ops>(hash, crafted_keys, key_count));
+    }
+    progress_bar(*done, total, NAN);
+}
+
+template <typename Ops>
+static double measure_ns_per_op(table_hash hash, const uint32_t* keys,
+                                size_t count)
+{
+    double total_ns = 0;
+    for (size_t iter = 0; iter < repeat; ++iter)
+    {
+        typename Ops::table_t table = {};
+        Ops::ctor(&table, hash);
+
+        const uint64_t start = bench_time_ns();
+        for (size_t i = 0; i < count; ++i)
+            Ops::insert(&table, keys[i]);
+        for (size_t i = 0; i < count; ++i)
+            Ops::contains(&table, keys[i]);
+        total_ns += (double) (bench_time_ns() - start);
+
+        Ops::dtor(&table);
+    }
+
+    return total_ns / (double) (repeat * 2 * count);
+}
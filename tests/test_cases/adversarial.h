@@ -0,0 +1,30 @@
+/**
+ * @file adversarial.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-20
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_ADVERSARIAL_H
+#define __TESTS_TEST_CASES_ADVERSARIAL_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Compare lookup latency of table hash functions on random keys
+ * and on keys crafted to collide under unseeded Fibonacci hashing
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_adversarial(int argc, const char* const* argv,
+                         const TestConfig* config);
+
+#endif /* adversarial.h */
@@ -0,0 +1,230 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "hash_table/arena.h"
+#include "hash_table/table_allocator.h"
+#include "workload/table_ops.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/display.h"
+#include "test_utils/keys.h"
+
+#include "allocators.h"
+
+enum allocator_kind
+{
+    ALLOCATOR_DEFAULT       = 0,
+    ALLOCATOR_THREAD_POOL   = 1,
+    ALLOCATOR_ARENA         = 2,
+    ALLOCATOR_NUMA_ARENA    = 3,
+    ALLOCATOR_KIND_COUNT
+};
+
+static const char* const allocator_names[ALLOCATOR_KIND_COUNT] = {
+    "default",
+    "thread_pool",
+    "arena",
+    "numa_arena",
+};
+
+struct SetContext
+{
+    /** NULL for default allocator */
+    const TableAllocator* allocator;
+    /** Arena, which is reset instead of destroying table, may be NULL */
+    Arena* arena;
+
+    size_t key_count;
+    /** Number of runs, which found wrong number of present keys */
+    size_t failed_runs;
+    /** Arena bytes used by table before reset */
+    size_t arena_bytes;
+};
+
+typedef void set_fn(void* context);
+
+struct SetVariant
+{
+    const char* table_name;
+    const char* test_name;
+    set_fn* run;
+};
+
+template <typename Ops>
+static void run_set(void* context);
+
+static const SetVariant set_variants[] = {
+    { OpenAddrOps::name,   OpenAddrOps::test_name,   run_set<OpenAddrOps>   },
+    { HopscotchOps::name,  HopscotchOps::test_name,  run_set<HopscotchOps>  },
+    { ClosedAddrOps::name, ClosedAddrOps::test_name, run_set<ClosedAddrOps> },
+};
+static const size_t set_variant_count =
+                        sizeof(set_variants) / sizeof(*set_variants);
+
+static const SetVariant* find_variant(const char* table_name);
+
+int run_test_allocators(int argc, const char* const* argv,
+                        const TestConfig* config)
+{
+    FILE *output = NULL;
+    const SetVariant* variant = NULL;
+    size_t key_count = 64;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 3, action_result,
+            "Expected at most table type and number of keys");
+        ASSERT_MESSAGE(
+            variant = find_variant(argc > 1 ? argv[1] : "closed_addr"),
+            action_result != NULL,
+            "Unknown table type");
+        if (argc > 2)
+            ASSERT_MESSAGE(key_count = strtoul(argv[2], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of keys");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    const BenchOptions options = BENCH_DEFAULT_OPTIONS;
+
+    double last_ms = NAN;
+    int status = 0;
+
+    fputs("name,allocator,keys,ns_per_table,ci95_ns_per_table,"
+          "arena_bytes_per_table\n", output);
+
+    for (size_t kind = 0; kind < ALLOCATOR_KIND_COUNT; ++kind)
+    {
+        progress_bar(kind, ALLOCATOR_KIND_COUNT, last_ms);
+        const uint64_t start_ns = bench_time_ns();
+
+        Arena arena = {};
+        TableAllocator allocator = {};
+        SetContext context = {
+            .allocator = NULL,
+            .arena = NULL,
+            .key_count = key_count,
+            .failed_runs = 0,
+            .arena_bytes = 0
+        };
+
+        switch ((allocator_kind) kind)
+        {
+        case ALLOCATOR_DEFAULT:
+            break;
+        case ALLOCATOR_THREAD_POOL:
+            context.allocator = &TABLE_THREAD_POOL_ALLOCATOR;
+            break;
+        case ALLOCATOR_ARENA:
+        case ALLOCATOR_NUMA_ARENA:
+            if (kind == ALLOCATOR_ARENA)
+                arena_ctor(&arena);
+            else
+                arena_ctor_numa_local(&arena);
+            allocator = arena_allocator(&arena);
+            context.allocator = &allocator;
+            context.arena = &arena;
+            break;
+        case ALLOCATOR_KIND_COUNT:
+        default:
+            break;
+        }
+
+        BenchResult result = {};
+        status = bench_measure(variant->run, &context, &options, &result);
+
+        arena_dtor(&arena);
+        if (status < 0)
+            break;
+        if (context.failed_runs != 0)
+        {
+            status = 1;
+            break;
+        }
+
+        /* name,allocator,keys,ns_per_table,ci95_ns_per_table,
+         * arena_bytes_per_table */
+        fprintf(output, "%s,%s,%zu,%.1lf,%.1lf,%zu\n",
+                        variant->test_name, allocator_names[kind],
+                        key_count, result.mean_ns, result.ci95_ns,
+                        context.arena_bytes);
+        fflush(output);
+
+        last_ms = (double) (bench_time_ns() - start_ns) / 1e6;
+    }
+
+    progress_bar(ALLOCATOR_KIND_COUNT, ALLOCATOR_KIND_COUNT, NAN);
+    putchar('\n');
+
+    table_thread_pool_trim();
+
+    if (status < 0)
+        fputs("Error: Failed to run benchmark\n", stderr);
+    else if (status > 0)
+        fputs("Error: Lookup results differ from inserted keys\n", stderr);
+
+    if (output != stdout)
+        fclose(output);
+
+    return status != 0;
+}
+
+/**
+ * @brief Create table, fill it, look up present and absent keys and drop
+ * table, as done for temporary per-request sets
+ */
+template <typename Ops>
+static void run_set(void* context)
+{
+    SetContext* set = (SetContext*) context;
+
+    typename Ops::table_t table = {};
+    Ops::ctor(&table, TABLE_HASH_FIBONACCI, set->allocator);
+
+    for (size_t i = 0; i < set->key_count; ++i)
+        Ops::insert(&table, get_key(i));
+
+    /* Every other looked up index is present, up to `key_count` */
+    size_t found = 0;
+    for (size_t i = 0; i < set->key_count; ++i)
+        found += (size_t) Ops::contains(&table, get_key(2 * i));
+    if (found != (set->key_count + 1) / 2)
+        ++ set->failed_runs;
+
+    /* All blocks of table are freed at once */
+    if (set->arena)
+    {
+        set->arena_bytes = set->arena->allocated;
+        arena_reset(set->arena);
+    }
+    else
+        Ops::dtor(&table);
+}
+
+static const SetVariant* find_variant(const char* table_name)
+{
+    for (size_t i = 0; i < set_variant_count; ++i)
+        if (strcasecmp(set_variants[i].table_name, table_name) == 0)
+            return &set_variants[i];
+
+    return NULL;
+}
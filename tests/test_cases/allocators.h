@@ -0,0 +1,30 @@
+/**
+ * @file allocators.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-31
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_ALLOCATORS_H
+#define __TESTS_TEST_CASES_ALLOCATORS_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Measure lifecycle of small temporary tables with every allocator.
+ * Test options are table type and number of keys per table.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_allocators(int argc, const char* const* argv,
+                        const TestConfig* config);
+
+#endif /* allocators.h */
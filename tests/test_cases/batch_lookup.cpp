@@ -0,0 +1,203 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "hash_table/closed_addr_hash_table.h"
+#include "workload/table_ops.h"
+#include "workload/workload.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/display.h"
+#include "test_utils/keys.h"
+
+#include "batch_lookup.h"
+
+static const size_t min_key_count = 1lu << 12;
+static const size_t key_count_step = 4;
+
+struct LookupContext
+{
+    ClosedAddrHashTable* table;
+    const uint32_t* keys;
+    uint8_t* serial_results;
+    uint8_t* batched_results;
+    size_t count;
+};
+
+static void run_serial(void* context);
+static void run_batched(void* context);
+
+int run_test_batch_lookup(int argc, const char* const* argv,
+                          const TestConfig* config)
+{
+    FILE *output = NULL;
+    table_hash hash = TABLE_HASH_FIBONACCI;
+    size_t max_keys = 1lu << 22;
+    size_t lookup_count = 1'000'000;
+
+    uint32_t* keys = NULL;
+    uint8_t* serial_results = NULL;
+    uint8_t* batched_results = NULL;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 4, action_result,
+            "Expected at most hash, maximal number of keys and "
+            "number of lookups");
+        if (argc > 1)
+            ASSERT_ZERO_MESSAGE(workload_parse_hash(argv[1], &hash),
+                                "Unknown hash function");
+        if (argc > 2)
+            ASSERT_MESSAGE(max_keys = strtoul(argv[2], NULL, 10),
+                           action_result >= min_key_count
+                        && action_result <= 1lu << 31,
+                           "Invalid maximal number of keys");
+        if (argc > 3)
+            ASSERT_MESSAGE(lookup_count = strtoul(argv[3], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of lookups");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+
+        ASSERT_MESSAGE(
+            keys = (uint32_t*) calloc(lookup_count, sizeof(*keys)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ASSERT_MESSAGE(
+            serial_results = (uint8_t*) calloc(lookup_count,
+                                               sizeof(*serial_results)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ASSERT_MESSAGE(
+            batched_results = (uint8_t*) calloc(lookup_count,
+                                                sizeof(*batched_results)),
+            action_result != NULL,
+            "Failed to allocate memory");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        free(keys);
+        free(serial_results);
+        free(batched_results);
+        if (output && output != stdout)
+            fclose(output);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    if (!config->append_to_file)
+        fputs("keys,bytes,serial_ns_per_op,batched_ns_per_op,speedup\n",
+              output);
+
+    const BenchOptions options = BENCH_DEFAULT_OPTIONS;
+    const double ops = (double) lookup_count;
+
+    size_t step_count = 0;
+    for (size_t n = min_key_count; n <= max_keys; n *= key_count_step)
+        ++ step_count;
+
+    ClosedAddrHashTable table = {};
+    closed_addr_hash_table_ctor(&table, hash);
+
+    size_t inserted = 0;
+    size_t step = 0;
+    double last_ms = NAN;
+    int status = 0;
+
+    for (size_t key_count = min_key_count; key_count <= max_keys;
+            key_count *= key_count_step, ++step)
+    {
+        progress_bar(step, step_count, last_ms);
+        const uint64_t start_ns = bench_time_ns();
+
+        for (; inserted < key_count; ++inserted)
+            closed_addr_hash_table_insert(&table, get_key(inserted));
+
+        /* Half of lookups hit, keys are spread over the whole table */
+        srand(0);
+        for (size_t i = 0; i < lookup_count; ++i)
+        {
+            const size_t index = (size_t) rand() % key_count;
+            keys[i] = get_key(i % 2 == 0 ? index : key_count + index);
+        }
+
+        LookupContext context = {
+            .table = &table,
+            .keys = keys,
+            .serial_results = serial_results,
+            .batched_results = batched_results,
+            .count = lookup_count
+        };
+
+        BenchResult serial = {};
+        BenchResult batched = {};
+        if (bench_measure(run_serial,  &context, &options, &serial)  < 0
+         || bench_measure(run_batched, &context, &options, &batched) < 0)
+        {
+            status = -1;
+            break;
+        }
+        if (memcmp(serial_results, batched_results, lookup_count) != 0)
+        {
+            status = 1;
+            break;
+        }
+
+        /* keys,bytes,serial_ns_per_op,batched_ns_per_op,speedup */
+        fprintf(output, "%zu,%zu,%.3lf,%.3lf,%.3lf\n",
+                        key_count, ClosedAddrOps::footprint(&table),
+                        serial.mean_ns / ops, batched.mean_ns / ops,
+                        serial.mean_ns / batched.mean_ns);
+        fflush(output);
+
+        last_ms = (double) (bench_time_ns() - start_ns) / 1e6;
+    }
+
+    progress_bar(step_count, step_count, NAN);
+    putchar('\n');
+
+    if (status < 0)
+        fputs("Error: Failed to run benchmark\n", stderr);
+    else if (status > 0)
+        fputs("Error: Lookup results differ between serial "
+              "and batched lookups\n", stderr);
+
+    closed_addr_hash_table_dtor(&table);
+    free(keys);
+    free(serial_results);
+    free(batched_results);
+    if (output != stdout)
+        fclose(output);
+
+    return status != 0;
+}
+
+static void run_serial(void* context)
+{
+    LookupContext* lookup = (LookupContext*) context;
+
+    for (size_t i = 0; i < lookup->count; ++i)
+        lookup->serial_results[i] = (uint8_t)
+            closed_addr_hash_table_contains(lookup->table, lookup->keys[i]);
+}
+
+static void run_batched(void* context)
+{
+    LookupContext* lookup = (LookupContext*) context;
+
+    closed_addr_hash_table_contains_batch(lookup->table, lookup->keys,
+                                          lookup->count,
+                                          lookup->batched_results);
+}
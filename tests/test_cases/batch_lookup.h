@@ -0,0 +1,31 @@
+/**
+ * @file batch_lookup.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-29
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_BATCH_LOOKUP_H
+#define __TESTS_TEST_CASES_BATCH_LOOKUP_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Compare serial and batched lookups in closed addressing table for
+ * increasing number of keys. Test options are table hash, maximal number
+ * of keys and number of lookups.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_batch_lookup(int argc, const char* const* argv,
+                          const TestConfig* config);
+
+#endif /* batch_lookup.h */
@@ -1,43 +1,62 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <sys/wait.h>
-#include <sys/resource.h>
-#include <fcntl.h>
-#include <unistd.h>
 
 #include "meerkat_assert/asserts.h"
 
-#include "test_utils/math.h"
+#include "workload/workload.h"
+
+#include "test_utils/bench.h"
 #include "test_utils/display.h"
+#include "test_utils/memory.h"
 
 #include "benchmark.h"
 
-#ifdef OPEN_ADDR
-#define TEST_NAME "open_addr_hash_table"
-#else
-#define TEST_NAME "closed_addr_hash_table"
-#endif
+struct WorkloadContext
+{
+    const WorkloadVariant* variant;
+    size_t repeat;
+    table_hash hash;
+};
 
-struct ExecTime
+struct CorpusContext
 {
-    double user_ms;
-    double sys_ms;
+    const WorkloadVariant* variant;
+    Corpus corpus;
+    table_hash hash;
+
+    size_t key_count;
+    int status;
 };
 
+struct MemoryResult
+{
+    AllocStats allocs;
+    size_t peak_rss_kb;
+};
 
 static int fill_data(size_t start_size, size_t end_size, size_t step_size,
-                     double* sys_time, double* user_time);
+                     const WorkloadVariant* variant, table_hash hash,
+                     BenchResult* results, MemoryResult* memory);
+
+static void run_workload(void* context);
+
+static void run_corpus(void* context);
+
+static void print_samples(FILE* output, const WorkloadVariant* variant,
+                          size_t start_size, size_t step_size,
+                          size_t point_count, const BenchResult* results);
 
-static int get_execution_time(int argc, char** argv, ExecTime* exec_time);
+static void print_summary(FILE* output, const WorkloadVariant* variant,
+                          size_t start_size, size_t step_size,
+                          size_t point_count, const BenchResult* results,
+                          const MemoryResult* memory);
 
-static void run_child(int argc, char** argv);
+static void measure_memory(WorkloadContext* context,
+                           MemoryResult* memory);
 
 
-int run_test_benchmark([[maybe_unused]] int argc,
-                       [[maybe_unused]] const char* const* argv,
+int run_test_benchmark(int argc, const char* const* argv,
                        const TestConfig* config)
 {
     const size_t start_size = 10'000;
@@ -46,10 +65,24 @@ int run_test_benchmark([[maybe_unused]] int argc,
     const size_t repeat_count = (end_size - start_size) / step_size + 1;
 
     FILE *output = NULL;
-    double *sys_time = NULL, *user_time = NULL;
+    BenchResult* results = NULL;
+    MemoryResult* memory = NULL;
+    const WorkloadVariant* variant = NULL;
+    table_hash hash = TABLE_HASH_FIBONACCI;
 
     SAFE_BLOCK_START
     {
+        ASSERT_MESSAGE(argc <= 4, action_result,
+                       "Expected at most table type, generator and hash");
+        ASSERT_MESSAGE(
+            variant = workload_find(argc > 1 ? argv[1] : "closed_addr",
+                                    argc > 2 ? argv[2] : "rand_cmd"),
+            action_result != NULL,
+            "Unknown table type or command generator");
+        if (argc > 3)
+            ASSERT_ZERO_MESSAGE(workload_parse_hash(argv[3], &hash),
+                                "Unknown hash function");
+
         if (config->filename)
         {
             ASSERT_MESSAGE(
@@ -61,146 +94,219 @@ int run_test_benchmark([[maybe_unused]] int argc,
         else output = stdout;
 
         ASSERT_MESSAGE(
-            sys_time = (double*) calloc(repeat_count, sizeof(*sys_time)),
+            results = (BenchResult*) calloc(repeat_count, sizeof(*results)),
             action_result != NULL,
             "Failed to allocate memory");
         ASSERT_MESSAGE(
-            user_time = (double*) calloc(repeat_count, sizeof(*user_time)),
+            memory = (MemoryResult*) calloc(repeat_count, sizeof(*memory)),
             action_result != NULL,
             "Failed to allocate memory");
 
         ASSERT_ZERO_MESSAGE(
-            fill_data(start_size, end_size, step_size,
-                      sys_time, user_time),
+            fill_data(start_size, end_size, step_size, variant, hash,
+                      results, memory),
             "Failed to run benchmark");
     }
     SAFE_BLOCK_HANDLE_ERRORS
     {
         fprintf(stderr, "Error: %s\n", assertion_info.message);
+        free(results);
+        free(memory);
         return 1;
     }
     SAFE_BLOCK_END
 
-    for (size_t iter = 0, i = start_size; i <= end_size; ++iter, i += step_size)
-        fprintf(output, TEST_NAME",%zu,%.3lf\n", i, sys_time[iter]
-                                                    + user_time[iter]);
-
     putchar('\n');
-    free(sys_time);
-    free(user_time);
+
+    if (config->write_samples)
+        print_samples(output, variant, start_size, step_size, repeat_count,
+                      results);
+    else
+        print_summary(output, variant, start_size, step_size, repeat_count,
+                      results, memory);
+
+    free(results);
+    free(memory);
+    if (output != stdout)
+        fclose(output);
 
     return 0;
 }
 
-static int fill_data(size_t start_size, size_t end_size, size_t step_size,
-                     double* sys_time, double* user_time)
+int run_test_corpus_benchmark(int argc, const char* const* argv,
+                              const TestConfig* config)
 {
-    const size_t data_size = (end_size - start_size) / step_size + 1;
+    FILE *output = NULL;
+    corpus_format format = CORPUS_FORMAT_TEXT;
+    BenchResult result = {};
+    const BenchOptions options = BENCH_DEFAULT_OPTIONS;
+
+    CorpusContext context = {
+        .variant = NULL,
+        .corpus = {},
+        .hash = TABLE_HASH_FIBONACCI,
+        .key_count = 0,
+        .status = 0
+    };
+    context.corpus.fd = -1;
 
-    double last_ms = NAN;
-    const size_t repeat = 5;
-    char test_size[32] = "";
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc >= 3 && argc <= 5, action_result,
+            "Expected corpus file, format, table type and hash");
+        ASSERT_ZERO_MESSAGE(corpus_parse_format(argv[2], &format),
+                            "Unknown corpus format");
+        ASSERT_MESSAGE(
+            context.variant = workload_find(argc > 3 ? argv[3] : "closed_addr",
+                                            "rand_cmd"),
+            action_result != NULL,
+            "Unknown table type");
+        if (argc > 4)
+            ASSERT_ZERO_MESSAGE(workload_parse_hash(argv[4], &context.hash),
+                                "Unknown hash function");
 
-    char argc = 2;
-    const char* argv[] = { "./build/bin/hash_practice",
-                           test_size,
-                           NULL };
+        ASSERT_ZERO_MESSAGE(corpus_open(argv[1], format, &context.corpus),
+                            "Failed to open corpus file");
 
-    for (size_t i = start_size, iter = 0; i <= end_size; ++iter, i += step_size)
-    {
-        double sum_sys = 0, sum_user = 0;
-        for (size_t j = 0; j < repeat; j++)
+        if (config->filename)
         {
-            sprintf(test_size, "%zu", i);
-            progress_bar(iter*repeat + j, data_size * repeat, last_ms);
-
-            ExecTime exec_time = {};
-            if (get_execution_time(
-                        argc, const_cast<char**>(argv), &exec_time) < 0)
-                return -1;
-            
-            sum_sys  += exec_time.sys_ms;
-            sum_user += exec_time.user_ms;
-
-            last_ms = exec_time.sys_ms + exec_time.user_ms;
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
         }
+        else output = stdout;
 
-        sys_time[iter]  = sum_sys  / repeat;
-        user_time[iter] = sum_user / repeat;
+        ASSERT_ZERO_MESSAGE(
+            bench_measure(run_corpus, &context, &options, &result),
+            "Failed to run benchmark");
+        ASSERT_ZERO_MESSAGE(context.status, "Invalid key in corpus file");
     }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        corpus_close(&context.corpus);
+        return 1;
+    }
+    SAFE_BLOCK_END
 
-    progress_bar(data_size * repeat, data_size*repeat, NAN);
+    /* name,keys,ms,ns_per_op,stddev_ns_per_op,ci95_ns_per_op,cycles_per_op,
+     * every key is inserted and looked up once */
+    const double ops = 2.0 * (double) context.key_count;
+    fprintf(output, "%s,%zu,%.3lf,%.3lf,%.3lf,%.3lf,%.2lf\n",
+                    context.variant->table_name, context.key_count,
+                    result.mean_ns / 1e6, result.mean_ns / ops,
+                    result.stddev_ns / ops, result.ci95_ns / ops,
+                    result.mean_cycles / ops);
 
-    return 0;
-}
+    corpus_close(&context.corpus);
+    if (output != stdout)
+        fclose(output);
 
-__always_inline
-static double get_utime(rusage* usage)
-{
-    return (double) usage->ru_utime.tv_sec * 1000.0
-         + (double) usage->ru_utime.tv_usec / 1000.0;
+    return 0;
 }
 
-__always_inline
-static double get_stime(rusage* usage)
+static int fill_data(size_t start_size, size_t end_size, size_t step_size,
+                     const WorkloadVariant* variant, table_hash hash,
+                     BenchResult* results, MemoryResult* memory)
 {
-    return (double) usage->ru_stime.tv_sec * 1000.0
-         + (double) usage->ru_stime.tv_usec / 1000.0;
-}
+    const size_t data_size = (end_size - start_size) / step_size + 1;
+    const BenchOptions options = BENCH_DEFAULT_OPTIONS;
 
-static int get_execution_time([[maybe_unused]]int argc, char** argv,
-                                              ExecTime* exec_time)
-{
-    pid_t child = fork();
+    double last_ms = NAN;
 
-    if (child < 0)
+    for (size_t i = start_size, iter = 0; i <= end_size; ++iter, i += step_size)
     {
-        perror("Failed to spawn proccess");
-        return -1;
-    }
+        progress_bar(iter, data_size, last_ms);
 
-    if (child == 0)
-        run_child(argc, argv);
+        WorkloadContext context = {
+            .variant = variant,
+            .repeat = i,
+            .hash = hash
+        };
 
-    rusage usage = {};
-    double sum_sys = 0, sum_user = 0;
+        const uint64_t start_ns = bench_time_ns();
+        if (bench_measure(run_workload, &context, &options, &results[iter]) < 0)
+            return -1;
 
-    getrusage(RUSAGE_CHILDREN, &usage);
-    sum_user = get_utime(&usage);
-    sum_sys  = get_stime(&usage);
-    
-    int status = 0;
-    if (waitpid(child, &status, 0) < 0)
-    {
-        perror("Failed to wait for child");
-        return -1;
-    }
+        /* Separate run, so that counting does not affect timing */
+        measure_memory(&context, &memory[iter]);
 
-    getrusage(RUSAGE_CHILDREN, &usage);
+        last_ms = (double) (bench_time_ns() - start_ns) / 1e6;
+    }
 
-    exec_time->user_ms = get_utime(&usage) - sum_user;
-    exec_time->sys_ms  = get_stime(&usage) - sum_sys;
+    progress_bar(data_size, data_size, NAN);
 
     return 0;
 }
 
-__attribute__((noreturn))
-static void run_child([[maybe_unused]]int argc, char** argv)
+static void run_workload(void* context)
+{
+    const WorkloadContext* workload = (const WorkloadContext*) context;
+    workload->variant->run(workload->repeat, workload->hash);
+}
+
+static void run_corpus(void* context)
+{
+    CorpusContext* corpus = (CorpusContext*) context;
+
+    if (corpus_rewind(&corpus->corpus) < 0
+     || corpus->variant->load_corpus(&corpus->corpus, corpus->hash,
+                                     &corpus->key_count) < 0)
+        corpus->status = -1;
+}
+
+static void measure_memory(WorkloadContext* context,
+                           MemoryResult* memory)
 {
-    int dev_null = open("/dev/null", O_WRONLY);
+    memory_reset_peak_rss();
+    memory_hook_reset();
+    memory_hook_enable(1);
 
-    if (dev_null < 0)   // On Windows
-        dev_null = open("nul", O_WRONLY);
+    run_workload(context);
 
-    // Redirect output to /dev/null or nul
-    dup2(dev_null, STDOUT_FILENO);
+    memory_hook_enable(0);
+    memory_hook_get_stats(&memory->allocs);
+    memory->peak_rss_kb = memory_get_peak_rss_kb();
+}
 
-    if (execvp(argv[0], argv) < 0)
+/* name,size,ms for every timed sample */
+static void print_samples(FILE* output, const WorkloadVariant* variant,
+                          size_t start_size, size_t step_size,
+                          size_t point_count, const BenchResult* results)
+{
+    for (size_t iter = 0; iter < point_count; ++iter)
     {
-        perror("Failed to start program");
-        exit(1);
+        const size_t size = start_size + iter * step_size;
+        for (size_t j = 0; j < results[iter].samples
+                            && j < BENCH_MAX_SAMPLES; ++j)
+            fprintf(output, "%s,%zu,%.3lf\n", variant->test_name, size,
+                            results[iter].sample_ns[j] / 1e6);
     }
+}
 
-    /* Unreachable */
-    exit(0);
+/* name,size,ms,ns_per_op,stddev_ns_per_op,ci95_ns_per_op,cycles_per_op,
+ * allocs_per_op,alloc_bytes_per_op,peak_rss_kb */
+static void print_summary(FILE* output, const WorkloadVariant* variant,
+                          size_t start_size, size_t step_size,
+                          size_t point_count, const BenchResult* results,
+                          const MemoryResult* memory)
+{
+    for (size_t iter = 0; iter < point_count; ++iter)
+    {
+        const size_t size = start_size + iter * step_size;
+        const BenchResult* res = &results[iter];
+        const AllocStats* allocs = &memory[iter].allocs;
+        const double ops = (double) size;
+        fprintf(output, "%s,%zu,%.3lf,%.3lf,%.3lf,%.3lf,%.2lf,"
+                        "%.4lf,%.2lf,%zu\n",
+                        variant->test_name, size, res->mean_ns / 1e6,
+                        res->mean_ns / ops, res->stddev_ns / ops,
+                        res->ci95_ns / ops, res->mean_cycles / ops,
+                        (double) (allocs->malloc_calls + allocs->calloc_calls
+                                + allocs->realloc_calls) / ops,
+                        (double) allocs->allocated_bytes / ops,
+                        memory[iter].peak_rss_kb);
+    }
 }
@@ -15,7 +15,8 @@
 #include "test_utils/config.h"
 
 /**
- * @brief Run benchmark on specified program
+ * @brief Benchmark table workload in-process for increasing number of
+ * commands. Test options are table type, command generator and table hash.
  *
  * @param[in] argc	    - Argument vector length
  * @param[in] argv	    - Argument vector
@@ -26,4 +27,17 @@
 int run_test_benchmark(int argc, const char* const* argv,
                        const TestConfig* config);
 
+/**
+ * @brief Benchmark insertion and lookup of every key from corpus file.
+ * Test options are corpus file, corpus format, table type and table hash.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_corpus_benchmark(int argc, const char* const* argv,
+                              const TestConfig* config);
+
 #endif /* benchmark.h */
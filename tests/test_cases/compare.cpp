@@ -0,0 +1,344 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "test_utils/math.h"
+
+#include "compare.h"
+
+static const size_t max_name_length = 63;
+/* Normal approximation of Mann-Whitney U test needs at least 8 values in
+ * each sample, points with fewer samples are reported as unknown */
+static const size_t min_point_samples = 8;
+static const size_t min_series_points = 2;
+
+enum verdict
+{
+    VERDICT_OK          = 0,
+    VERDICT_REGRESSION  = 1,
+    VERDICT_IMPROVEMENT = 2,
+    /** Not enough samples for test */
+    VERDICT_UNKNOWN     = 3,
+};
+
+static const char* const verdict_names[] = {
+    "ok",
+    "regression",
+    "improvement",
+    "unknown",
+};
+
+struct ResultPoint
+{
+    char name[max_name_length + 1];
+    size_t size;
+
+    double* samples;
+    size_t sample_count;
+    size_t sample_capacity;
+};
+
+struct ResultSet
+{
+    ResultPoint* points;
+    size_t point_count;
+    size_t point_capacity;
+};
+
+struct CompareOptions
+{
+    /** Minimal relative change to be reported */
+    double threshold;
+    double alpha;
+};
+
+static int load_results(const char* filename, ResultSet* results);
+
+static void result_set_dtor(ResultSet* results);
+
+static ResultPoint* find_point(const ResultSet* results,
+                               const char* name, size_t size);
+
+static verdict compare_point(FILE* output, const CompareOptions* options,
+                             ResultPoint* baseline, ResultPoint* candidate,
+                             double* log_ratio);
+
+static verdict compare_series(FILE* output, const CompareOptions* options,
+                              const char* name, const double* log_ratios,
+                              size_t count);
+
+int run_test_compare(int argc, const char* const* argv,
+                     const TestConfig* config)
+{
+    FILE *output = NULL;
+    ResultSet baseline = {}, candidate = {};
+    double* log_ratios = NULL;
+    CompareOptions options = {
+        .threshold = 0.05,
+        .alpha = 0.01
+    };
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc >= 3 && argc <= 5, action_result,
+            "Expected baseline and candidate files, threshold and "
+            "significance level");
+        if (argc > 3)
+            ASSERT_MESSAGE(options.threshold = strtod(argv[3], NULL) / 100,
+                           action_result >= 0,
+                           "Invalid threshold");
+        if (argc > 4)
+            ASSERT_MESSAGE(options.alpha = strtod(argv[4], NULL),
+                           action_result > 0 && action_result < 0.5,
+                           "Significance level must be in range (0, 0.5)");
+
+        ASSERT_ZERO_MESSAGE(load_results(argv[1], &baseline),
+                            "Failed to load baseline results");
+        ASSERT_ZERO_MESSAGE(load_results(argv[2], &candidate),
+                            "Failed to load candidate results");
+
+        ASSERT_MESSAGE(
+            log_ratios = (double*) calloc(baseline.point_count + 1,
+                                          sizeof(*log_ratios)),
+            action_result != NULL,
+            "Failed to allocate memory");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        result_set_dtor(&baseline);
+        result_set_dtor(&candidate);
+        free(log_ratios);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    fputs("name,size,baseline_ms,candidate_ms,change_percent,"
+          "ci_low_percent,ci_high_percent,p_value,verdict\n", output);
+
+    size_t regressions = 0, aligned = 0;
+
+    /* Points of one series are consecutive in benchmark output */
+    size_t series_start = 0;
+    size_t ratio_count = 0;
+    for (size_t i = 0; i < baseline.point_count; ++i)
+    {
+        ResultPoint* base = &baseline.points[i];
+        ResultPoint* cand = find_point(&candidate, base->name, base->size);
+        if (cand)
+        {
+            ++aligned;
+            if (compare_point(output, &options, base, cand,
+                              &log_ratios[ratio_count++])
+                    == VERDICT_REGRESSION)
+                ++regressions;
+        }
+
+        const int series_end = i + 1 == baseline.point_count
+                            || strcmp(baseline.points[i + 1].name,
+                                      baseline.points[series_start].name) != 0;
+        if (series_end)
+        {
+            if (ratio_count > 0
+                    && compare_series(output, &options,
+                                      baseline.points[series_start].name,
+                                      log_ratios, ratio_count)
+                            == VERDICT_REGRESSION)
+                ++regressions;
+
+            series_start = i + 1;
+            ratio_count = 0;
+        }
+    }
+
+    if (aligned == 0)
+        fprintf(stderr, "Warning: no common data points\n");
+    if (regressions > 0)
+        fprintf(stderr, "Found %zu regressions above %.1lf%%\n",
+                        regressions, options.threshold * 100);
+
+    result_set_dtor(&baseline);
+    result_set_dtor(&candidate);
+    free(log_ratios);
+    if (output != stdout)
+        fclose(output);
+
+    return regressions > 0 ? 2 : 0;
+}
+
+static int add_sample(ResultSet* results, const char* name, size_t size,
+                      double sample);
+
+static int load_results(const char* filename, ResultSet* results)
+{
+    FILE* input = fopen(filename, "r");
+    if (!input)
+        return -1;
+
+    char line[1024] = "";
+    int status = 0;
+    while (status == 0 && fgets(line, sizeof(line), input))
+    {
+        char name[max_name_length + 1] = "";
+        size_t size = 0;
+        double ms = NAN;
+
+        /* Headers and malformed lines are skipped */
+        if (sscanf(line, "%63[^,],%zu,%lf", name, &size, &ms) != 3)
+            continue;
+
+        status = add_sample(results, name, size, ms);
+    }
+
+    fclose(input);
+    return status == 0 && results->point_count > 0 ? 0 : -1;
+}
+
+static int add_sample(ResultSet* results, const char* name, size_t size,
+                      double sample)
+{
+    ResultPoint* point = find_point(results, name, size);
+
+    if (!point)
+    {
+        if (results->point_count == results->point_capacity)
+        {
+            const size_t capacity = results->point_capacity
+                                  ? 2 * results->point_capacity : 64;
+            ResultPoint* points = (ResultPoint*) realloc(results->points,
+                                            capacity * sizeof(*points));
+            if (!points)
+                return -1;
+
+            results->points = points;
+            results->point_capacity = capacity;
+        }
+
+        point = &results->points[results->point_count++];
+        memset(point, 0, sizeof(*point));
+        snprintf(point->name, sizeof(point->name), "%s", name);
+        point->size = size;
+    }
+
+    if (point->sample_count == point->sample_capacity)
+    {
+        const size_t capacity = point->sample_capacity
+                              ? 2 * point->sample_capacity : 8;
+        double* samples = (double*) realloc(point->samples,
+                                            capacity * sizeof(*samples));
+        if (!samples)
+            return -1;
+
+        point->samples = samples;
+        point->sample_capacity = capacity;
+    }
+
+    point->samples[point->sample_count++] = sample;
+    return 0;
+}
+
+static void result_set_dtor(ResultSet* results)
+{
+    for (size_t i = 0; i < results->point_count; ++i)
+        free(results->points[i].samples);
+
+    free(results->points);
+    memset(results, 0, sizeof(*results));
+}
+
+static ResultPoint* find_point(const ResultSet* results,
+                               const char* name, size_t size)
+{
+    /* Last added point is the most likely match */
+    for (size_t i = results->point_count; i > 0; --i)
+    {
+        ResultPoint* point = &results->points[i - 1];
+        if (point->size == size && strcmp(point->name, name) == 0)
+            return point;
+    }
+
+    return NULL;
+}
+
+static verdict get_verdict(const CompareOptions* options, double change,
+                           int slower, int faster)
+{
+    if (slower && change > options->threshold)
+        return VERDICT_REGRESSION;
+    if (faster && change < -options->threshold)
+        return VERDICT_IMPROVEMENT;
+    return VERDICT_OK;
+}
+
+static verdict compare_point(FILE* output, const CompareOptions* options,
+                             ResultPoint* baseline, ResultPoint* candidate,
+                             double* log_ratio)
+{
+    const double base_median = get_median(baseline->samples,
+                                          baseline->sample_count);
+    const double cand_median = get_median(candidate->samples,
+                                          candidate->sample_count);
+    const double change = cand_median / base_median - 1;
+    *log_ratio = log(cand_median / base_median);
+
+    verdict result = VERDICT_UNKNOWN;
+    double p_value = NAN;
+
+    if (baseline->sample_count  >= min_point_samples
+     && candidate->sample_count >= min_point_samples)
+    {
+        const double p_slower = get_mann_whitney_p(
+                                    baseline->samples,  baseline->sample_count,
+                                    candidate->samples, candidate->sample_count);
+        const double p_faster = get_mann_whitney_p(
+                                    candidate->samples, candidate->sample_count,
+                                    baseline->samples,  baseline->sample_count);
+
+        p_value = fmin(p_slower, p_faster);
+        result = get_verdict(options, change, p_slower < options->alpha,
+                                              p_faster < options->alpha);
+    }
+
+    fprintf(output, "%s,%zu,%.3lf,%.3lf,%.2lf,nan,nan,%.3lg,%s\n",
+                    baseline->name, baseline->size, base_median, cand_median,
+                    change * 100, p_value, verdict_names[result]);
+
+    return result;
+}
+
+static verdict compare_series(FILE* output, const CompareOptions* options,
+                              const char* name, const double* log_ratios,
+                              size_t count)
+{
+    const double mean = get_mean(log_ratios, count);
+    double low = NAN, high = NAN;
+    if (get_bootstrap_interval(log_ratios, count, options->alpha,
+                               &low, &high) < 0)
+        return VERDICT_UNKNOWN;
+
+    const double change = exp(mean) - 1;
+    const verdict result = count < min_series_points
+                         ? VERDICT_UNKNOWN
+                         : get_verdict(options, change,
+                                       exp(low) - 1 > options->threshold,
+                                       exp(high) - 1 < -options->threshold);
+
+    fprintf(output, "%s,all,nan,nan,%.2lf,%.2lf,%.2lf,nan,%s\n",
+                    name, change * 100, (exp(low) - 1) * 100,
+                    (exp(high) - 1) * 100, verdict_names[result]);
+
+    return result;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file compare.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-29
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_COMPARE_H
+#define __TESTS_TEST_CASES_COMPARE_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Compare two benchmark result files in `name,size,ms` format
+ * (extra columns are ignored, repeated rows are treated as samples).
+ * Points with repeats are compared with Mann-Whitney U test, every series
+ * is compared with bootstrap interval of mean log-ratio over its points.
+ * Test options are baseline file, candidate file, regression threshold in
+ * percent (5 by default) and significance level (0.01 by default).
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return 0 if no regressions found, 2 if there are regressions, 1 on error
+ */
+int run_test_compare(int argc, const char* const* argv,
+                     const TestConfig* config);
+
+#endif /* compare.h */
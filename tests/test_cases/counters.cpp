@@ -0,0 +1,122 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload/workload.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/display.h"
+#include "test_utils/perf_counters.h"
+
+#include "counters.h"
+
+struct WorkloadContext
+{
+    const WorkloadVariant* variant;
+    size_t repeat;
+    table_hash hash;
+};
+
+static void run_workload(void* context);
+
+int run_test_counters(int argc, const char* const* argv,
+                      const TestConfig* config)
+{
+    FILE *output = NULL;
+    table_hash hash = TABLE_HASH_FIBONACCI;
+    size_t repeat = 100'000;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 3, action_result,
+                       "Expected at most hash and command count");
+        if (argc > 1)
+            ASSERT_ZERO_MESSAGE(workload_parse_hash(argv[1], &hash),
+                                "Unknown hash function");
+        if (argc > 2)
+            ASSERT_MESSAGE(repeat = strtoul(argv[2], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of commands");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    PerfCounters counters = {};
+    if (perf_counters_open(&counters) == 0)
+        fprintf(stderr, "Warning: hardware counters unavailable, "
+                        "reporting time only\n");
+
+    BenchOptions options = BENCH_DEFAULT_OPTIONS;
+    options.counters = &counters;
+
+    BenchResult* results = (BenchResult*)
+                        calloc(WORKLOAD_VARIANT_COUNT, sizeof(*results));
+    if (!results)
+    {
+        fprintf(stderr, "Error: Failed to allocate memory\n");
+        perf_counters_close(&counters);
+        return 1;
+    }
+
+    for (size_t i = 0; i < WORKLOAD_VARIANT_COUNT; ++i)
+    {
+        progress_bar(i, WORKLOAD_VARIANT_COUNT, NAN);
+
+        WorkloadContext context = {
+            .variant = &WORKLOAD_VARIANTS[i],
+            .repeat = repeat,
+            .hash = hash
+        };
+        bench_measure(run_workload, &context, &options, &results[i]);
+    }
+    progress_bar(WORKLOAD_VARIANT_COUNT, WORKLOAD_VARIANT_COUNT, NAN);
+    putchar('\n');
+
+    fputs("name,generator,ns", output);
+    for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i)
+        fprintf(output, ",%s", PERF_COUNTER_NAMES[i]);
+    fputc('\n', output);
+
+    /* All values are per command */
+    for (size_t i = 0; i < WORKLOAD_VARIANT_COUNT; ++i)
+    {
+        const WorkloadVariant* variant = &WORKLOAD_VARIANTS[i];
+        const double ops = (double) repeat;
+
+        fprintf(output, "%s,%s,%.3lf", variant->test_name,
+                        COMMAND_GEN_NAMES[variant->cmd_gen],
+                        results[i].mean_ns / ops);
+        for (size_t j = 0; j < PERF_COUNTER_COUNT; ++j)
+            fprintf(output, ",%.4lf", results[i].counters[j] / ops);
+        fputc('\n', output);
+    }
+
+    free(results);
+    perf_counters_close(&counters);
+    if (output != stdout)
+        fclose(output);
+
+    return 0;
+}
+
+static void run_workload(void* context)
+{
+    const WorkloadContext* workload = (const WorkloadContext*) context;
+    workload->variant->run(workload->repeat, workload->hash);
+}
@@ -0,0 +1,31 @@
+/**
+ * @file counters.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-24
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_COUNTERS_H
+#define __TESTS_TEST_CASES_COUNTERS_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Collect hardware performance counters per command for every table
+ * type and command generator. Test options are table hash and number of
+ * commands.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_counters(int argc, const char* const* argv,
+                      const TestConfig* config);
+
+#endif /* counters.h */
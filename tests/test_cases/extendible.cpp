@@ -0,0 +1,255 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "hash_table/extendible_hash_table.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/keys.h"
+
+#include "extendible.h"
+
+/**
+ * @brief Pool counters before phase
+ */
+struct PhaseStart
+{
+    uint64_t time_ns;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t writes;
+};
+
+static PhaseStart start_phase(const ExtendibleHashTable* table);
+
+static void print_phase(FILE* output, const char* phase,
+                        const ExtendibleHashTable* table,
+                        const PhaseStart* start, size_t ops,
+                        size_t key_count, size_t pool_pages);
+
+static size_t run_lookups(ExtendibleHashTable* table, size_t key_count,
+                          size_t lookup_count, size_t* expected);
+
+static char* get_directory_path(const char* path);
+static int  table_exists(const char* path);
+static void remove_table(const char* path);
+
+int run_test_extendible(int argc, const char* const* argv,
+                        const TestConfig* config)
+{
+    FILE *output = NULL;
+    const char* path = NULL;
+    size_t key_count = 1'000'000;
+    size_t pool_pages = EXTENDIBLE_DEFAULT_POOL_PAGES;
+    size_t lookup_count = 1'000'000;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc >= 2 && argc <= 5, action_result,
+            "Expected data file, number of keys, pool pages "
+            "and number of lookups");
+        path = argv[1];
+        /* Files are removed after the run, so existing ones are kept */
+        ASSERT_MESSAGE(table_exists(path), action_result == 0,
+                       "Data file or its directory already exists");
+        if (argc > 2)
+            ASSERT_MESSAGE(key_count = strtoul(argv[2], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of keys");
+        if (argc > 3)
+            ASSERT_MESSAGE(pool_pages = strtoul(argv[3], NULL, 10),
+                           action_result >= 2,
+                           "Invalid number of pool pages");
+        if (argc > 4)
+            ASSERT_MESSAGE(lookup_count = strtoul(argv[4], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of lookups");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    ExtendibleHashTable table = {};
+    PhaseStart start = {};
+    size_t expected = 0;
+    size_t found = 0;
+    int opened = 0;
+    int status = 0;
+
+    fputs("phase,keys,pool_pages,ops,ns_per_op,pool_hit_rate,"
+          "page_writes,file_pages\n", output);
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_ZERO_MESSAGE(
+            extendible_hash_table_ctor(&table, path, pool_pages),
+            "Failed to create table");
+        opened = 1;
+
+        start = start_phase(&table);
+        size_t failed = 0;
+        for (size_t i = 0; i < key_count; ++i)
+            failed += extendible_hash_table_insert(&table, get_key_64(i)) != 0;
+        ASSERT_MESSAGE(failed, action_result == 0, "Failed to insert keys");
+        ASSERT_ZERO_MESSAGE(extendible_hash_table_flush(&table),
+                            "Failed to write table");
+        print_phase(output, "insert", &table, &start, key_count,
+                    key_count, pool_pages);
+
+        start = start_phase(&table);
+        found = run_lookups(&table, key_count, lookup_count, &expected);
+        print_phase(output, "lookup", &table, &start, lookup_count,
+                    key_count, pool_pages);
+        ASSERT_MESSAGE(found, action_result == expected,
+                       "Lookup results differ from inserted keys");
+
+        opened = 0;
+        ASSERT_ZERO_MESSAGE(extendible_hash_table_dtor(&table),
+                            "Failed to write table");
+
+        /* Pool of reopened table is cold */
+        ASSERT_ZERO_MESSAGE(
+            extendible_hash_table_ctor(&table, path, pool_pages),
+            "Failed to reopen table");
+        opened = 1;
+        ASSERT_MESSAGE(table.distinct_count, action_result == key_count,
+                       "Reopened table has wrong number of keys");
+
+        start = start_phase(&table);
+        found = run_lookups(&table, key_count, lookup_count, &expected);
+        print_phase(output, "reopen_lookup", &table, &start, lookup_count,
+                    key_count, pool_pages);
+        ASSERT_MESSAGE(found, action_result == expected,
+                       "Reopened table lost keys");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        status = 1;
+    }
+    SAFE_BLOCK_END
+
+    if (opened)
+        extendible_hash_table_dtor(&table);
+    remove_table(path);
+
+    if (output != stdout)
+        fclose(output);
+
+    return status;
+}
+
+static PhaseStart start_phase(const ExtendibleHashTable* table)
+{
+    return {
+        .time_ns = bench_time_ns(),
+        .hits    = table->pool.hits,
+        .misses  = table->pool.misses,
+        .writes  = table->pool.writes
+    };
+}
+
+static void print_phase(FILE* output, const char* phase,
+                        const ExtendibleHashTable* table,
+                        const PhaseStart* start, size_t ops,
+                        size_t key_count, size_t pool_pages)
+{
+    const double elapsed_ns = (double) (bench_time_ns() - start->time_ns);
+    const uint64_t hits = table->pool.hits - start->hits;
+    const uint64_t accesses = hits + table->pool.misses - start->misses;
+
+    /* phase,keys,pool_pages,ops,ns_per_op,pool_hit_rate,page_writes,
+     * file_pages */
+    fprintf(output, "%s,%zu,%zu,%zu,%.1lf,%.4lf,%lu,%lu\n",
+                    phase, key_count, pool_pages, ops,
+                    elapsed_ns / (double) ops,
+                    accesses ? (double) hits / (double) accesses : 0.0,
+                    table->pool.writes - start->writes,
+                    table->page_count);
+    fflush(output);
+}
+
+/**
+ * @brief Look up random keys, half of which are present
+ *
+ * @return Number of found keys
+ */
+static size_t run_lookups(ExtendibleHashTable* table, size_t key_count,
+                          size_t lookup_count, size_t* expected)
+{
+    size_t found = 0;
+    *expected = 0;
+
+    srand(0);
+    for (size_t i = 0; i < lookup_count; ++i)
+    {
+        const size_t index = (size_t) rand() % key_count;
+        const bool hit = rand() % 2 == 0;
+
+        *expected += hit;
+        found += (size_t) extendible_hash_table_contains(
+                        table, get_key_64(hit ? index : key_count + index));
+    }
+
+    return found;
+}
+
+/**
+ * @return Path of directory file of table, which must be freed, or NULL
+ */
+static char* get_directory_path(const char* path)
+{
+    const size_t path_length = strlen(path);
+    char* directory_path = (char*) calloc(path_length + sizeof(".dir"), 1);
+    if (!directory_path)
+        return NULL;
+
+    memcpy(directory_path, path, path_length);
+    memcpy(directory_path + path_length, ".dir", sizeof(".dir"));
+
+    return directory_path;
+}
+
+/**
+ * @return 1 if data or directory file exists, 0 if neither does, -1 upon
+ * failure
+ */
+static int table_exists(const char* path)
+{
+    char* directory_path = get_directory_path(path);
+    if (!directory_path)
+        return -1;
+
+    const int exists = access(path, F_OK) == 0
+                    || access(directory_path, F_OK) == 0;
+    free(directory_path);
+
+    return exists;
+}
+
+static void remove_table(const char* path)
+{
+    char* directory_path = get_directory_path(path);
+    if (!directory_path)
+        return;
+
+    unlink(path);
+    unlink(directory_path);
+    free(directory_path);
+}
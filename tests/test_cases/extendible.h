@@ -0,0 +1,32 @@
+/**
+ * @file extendible.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-06-01
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_EXTENDIBLE_H
+#define __TESTS_TEST_CASES_EXTENDIBLE_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Fill file-backed extendible hash table, look keys up, reopen it and
+ * look keys up again. Test options are data file path, number of keys,
+ * buffer pool pages and number of lookups. Data file and its directory
+ * must not exist, they are created by the test and removed after it.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_extendible(int argc, const char* const* argv,
+                        const TestConfig* config);
+
+#endif /* extendible.h */
@@ -0,0 +1,188 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "hash_table/closed_addr_hash_table.h"
+#include "workload/table_ops.h"
+#include "workload/workload.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/display.h"
+#include "test_utils/keys.h"
+
+#include "filter.h"
+
+static const size_t hit_percent_step = 10;
+
+struct LookupContext
+{
+    ClosedAddrHashTable* table;
+    const uint32_t* keys;
+    size_t count;
+    size_t found;
+};
+
+static void run_lookups(void* context);
+
+int run_test_filter(int argc, const char* const* argv,
+                    const TestConfig* config)
+{
+    FILE *output = NULL;
+    table_hash hash = TABLE_HASH_FIBONACCI;
+    size_t key_count = 1lu << 20;
+    size_t lookup_count = 1'000'000;
+
+    uint32_t* keys = NULL;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 4, action_result,
+            "Expected at most hash, number of keys and number of lookups");
+        if (argc > 1)
+            ASSERT_ZERO_MESSAGE(workload_parse_hash(argv[1], &hash),
+                                "Unknown hash function");
+        if (argc > 2)
+            ASSERT_MESSAGE(key_count = strtoul(argv[2], NULL, 10),
+                           action_result > 0 && action_result <= 1lu << 31,
+                           "Invalid number of keys");
+        if (argc > 3)
+            ASSERT_MESSAGE(lookup_count = strtoul(argv[3], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of lookups");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+
+        ASSERT_MESSAGE(
+            keys = (uint32_t*) calloc(lookup_count, sizeof(*keys)),
+            action_result != NULL,
+            "Failed to allocate memory");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        free(keys);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    const BenchOptions options = BENCH_DEFAULT_OPTIONS;
+    const double ops = (double) lookup_count;
+    const size_t step_count = 100 / hit_percent_step + 1;
+
+    ClosedAddrHashTable plain = {};
+    ClosedAddrHashTable filtered = {};
+    ClosedAddrOps::ctor(&plain, hash);
+    ClosedAddrBloomOps::ctor(&filtered, hash);
+
+    for (size_t i = 0; i < key_count; ++i)
+    {
+        ClosedAddrOps::insert(&plain, get_key(i));
+        ClosedAddrBloomOps::insert(&filtered, get_key(i));
+    }
+
+    double last_ms = NAN;
+    int status = 0;
+
+    for (size_t step = 0; step < step_count; ++step)
+    {
+        progress_bar(step, step_count, last_ms);
+        const uint64_t start_ns = bench_time_ns();
+        const size_t hit_percent = step * hit_percent_step;
+
+        /* Missing keys come from indices past inserted ones */
+        srand(0);
+        for (size_t i = 0; i < lookup_count; ++i)
+        {
+            const size_t index = (size_t) rand() % key_count;
+            const bool hit = (size_t) rand() % 100 < hit_percent;
+            keys[i] = get_key(hit ? index : key_count + index);
+        }
+
+        /* Share of misses which pass the filter */
+        size_t misses = 0;
+        size_t false_positives = 0;
+        for (size_t i = 0; i < lookup_count; ++i)
+        {
+            if (closed_addr_hash_table_contains(&plain, keys[i]))
+                continue;
+
+            ++ misses;
+            false_positives += (size_t)
+                bloom_filter_may_contain(&filtered.filter, keys[i]);
+        }
+
+        LookupContext plain_context = {
+            .table = &plain,
+            .keys = keys,
+            .count = lookup_count,
+            .found = 0
+        };
+        LookupContext filtered_context = {
+            .table = &filtered,
+            .keys = keys,
+            .count = lookup_count,
+            .found = 0
+        };
+
+        BenchResult plain_result = {};
+        BenchResult filtered_result = {};
+        if (bench_measure(run_lookups, &plain_context,
+                          &options, &plain_result) < 0
+         || bench_measure(run_lookups, &filtered_context,
+                          &options, &filtered_result) < 0)
+        {
+            status = 1;
+            break;
+        }
+
+        /* hit_percent,false_positive_rate,plain_ns_per_op,
+         * filtered_ns_per_op,speedup */
+        fprintf(output, "%zu,%.5lf,%.3lf,%.3lf,%.3lf\n",
+                        hit_percent,
+                        misses ? (double) false_positives / (double) misses
+                               : 0.0,
+                        plain_result.mean_ns / ops,
+                        filtered_result.mean_ns / ops,
+                        plain_result.mean_ns / filtered_result.mean_ns);
+        fflush(output);
+
+        last_ms = (double) (bench_time_ns() - start_ns) / 1e6;
+    }
+
+    progress_bar(step_count, step_count, NAN);
+    putchar('\n');
+
+    if (status != 0)
+        fputs("Error: Failed to run benchmark\n", stderr);
+
+    ClosedAddrOps::dtor(&plain);
+    ClosedAddrBloomOps::dtor(&filtered);
+    free(keys);
+    if (output != stdout)
+        fclose(output);
+
+    return status;
+}
+
+static void run_lookups(void* context)
+{
+    LookupContext* lookup = (LookupContext*) context;
+
+    size_t found = 0;
+    for (size_t i = 0; i < lookup->count; ++i)
+        found += (size_t) closed_addr_hash_table_contains(lookup->table,
+                                                          lookup->keys[i]);
+
+    /* Keeps lookups from being optimized out */
+    lookup->found = found;
+}
@@ -0,0 +1,31 @@
+/**
+ * @file filter.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-30
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_FILTER_H
+#define __TESTS_TEST_CASES_FILTER_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Compare lookups in closed addressing table with and without Bloom
+ * filter for increasing share of present keys. Test options are table hash,
+ * number of keys and number of lookups.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_filter(int argc, const char* const* argv,
+                    const TestConfig* config);
+
+#endif /* filter.h */
@@ -1,42 +1,186 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #include "meerkat_assert/asserts.h"
 
 #include "hash_table/fixed_hash_table.h"
+#include "workload/corpus.h"
 
 #include "test_utils/display.h"
 
 #include "histogram.h"
 
+enum key_dist
+{
+    /** Random keys (random length strings) */
+    KEY_DIST_UNIFORM    = 0,
+    /** Consecutive integers (their decimal representations for strings) */
+    KEY_DIST_SEQUENTIAL = 1,
+    /** Multiples of 1024 for integers, multiples of 1/1024 for floating-point
+     * numbers and random strings of equal length */
+    KEY_DIST_STRUCTURED = 2,
+    KEY_DIST_COUNT
+};
+
+static const char* const key_dist_names[KEY_DIST_COUNT] = {
+    "uniform",
+    "sequential",
+    "structured",
+};
+
+/* Keys are counted in batches to keep workers from contending on counter */
+static const size_t progress_step = 4096;
+static const unsigned progress_period_ms = 100;
+
+struct HistogramVariant;
+
+struct HistogramJob
+{
+    const HistogramVariant* variant;
+    size_t bucket_count;
+
+    /** Keys are read from corpus file if path is not NULL */
+    const char* corpus_path;
+    corpus_format format;
+
+    /** Number of generated keys, corpus size in bytes for corpus */
+    size_t key_count;
+    key_dist dist;
+    unsigned seed;
+
+    size_t* bucket_sizes;
+    int status;
+};
+
+/**
+ * @brief Fill fixed hash table and get sizes of its buckets
+ *
+ * @param[inout] job        - Histogram parameters and bucket sizes
+ * @param[inout] progress   - Number of inserted keys (consumed bytes for
+ *                            corpus), shared by threads
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+typedef int histogram_fn(HistogramJob* job, size_t* progress);
+
+struct HistogramVariant
+{
+    const char* hash_name;
+    histogram_fn* run;
+};
+
+template <typename Preset, typename Preset::hash_fn* Hash>
+static int build_histogram(HistogramJob* job, size_t* progress);
+
+#define HISTOGRAM_VARIANT(preset, hash) { #hash, build_histogram<preset, hash> },
+
+static const HistogramVariant histogram_variants[] = {
+    FOR_EACH_HASH_PRESET(HISTOGRAM_VARIANT)
+};
+static const size_t histogram_variant_count =
+                    sizeof(histogram_variants) / sizeof(*histogram_variants);
+
+#undef HISTOGRAM_VARIANT
+
+/* Prime, decimal and power of two bucket counts, to which weak hashes
+ * react differently */
+static const size_t sweep_bucket_counts[] = { 97, 1000, 1024, 4099 };
+static const size_t sweep_bucket_count_count =
+                    sizeof(sweep_bucket_counts) / sizeof(*sweep_bucket_counts);
+static const size_t sweep_keys_per_bucket = 32;
+
+struct HistogramQueue
+{
+    HistogramJob* jobs;
+    size_t job_count;
+
+    size_t next_job;
+    size_t done_jobs;
+    size_t done_keys;
+};
+
+static const HistogramVariant* find_variant(const char* hash_name);
 
-void fill_table(FixedHashTable* table, size_t data_size);
+static int run_jobs(HistogramJob* jobs, size_t job_count,
+                    size_t thread_count);
 
-static void dump_contents(FILE* output, const FixedHashTable* table);
-static size_t get_bucket_size(const FixedHashTableEntry* head);
+static void* run_worker(void* queue);
 
-#define STR(x) __BASIC_STR(x)
-#define __BASIC_STR(x) #x
+static void free_jobs(HistogramJob* jobs, size_t job_count);
 
-int run_test_histogram([[maybe_unused]] int argc,
-                       [[maybe_unused]] const char* const* argv,
+template <typename Preset, typename Preset::hash_fn* Hash>
+static int fill_table_corpus(FixedHashTable<Preset, Hash>* table,
+                             const char* path, corpus_format format,
+                             size_t* progress);
+
+template <typename Entry>
+static size_t get_bucket_size(const Entry* head);
+
+template <HashPresetInt::hash_fn* Hash>
+static void fill_table(FixedHashTable<HashPresetInt, Hash>* table,
+                       size_t data_size, key_dist dist, unsigned* seed,
+                       size_t* progress);
+
+template <HashPresetDouble::hash_fn* Hash>
+static void fill_table(FixedHashTable<HashPresetDouble, Hash>* table,
+                       size_t data_size, key_dist dist, unsigned* seed,
+                       size_t* progress);
+
+template <HashPresetStr::hash_fn* Hash>
+static void fill_table(FixedHashTable<HashPresetStr, Hash>* table,
+                       size_t data_size, key_dist dist, unsigned* seed,
+                       size_t* progress);
+
+__always_inline
+static void report_progress(size_t done, size_t* progress)
+{
+    if (done % progress_step == progress_step - 1)
+        __atomic_fetch_add(progress, progress_step, __ATOMIC_RELAXED);
+}
+
+static size_t get_thread_count(void)
+{
+    const long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpu_count > 0 ? (size_t) cpu_count : 1;
+}
+
+static FILE* open_output(const TestConfig* config)
+{
+    if (!config->filename)
+        return stdout;
+
+    return fopen(config->filename, config->append_to_file ? "a" : "w");
+}
+
+int run_test_histogram(int argc, const char* const* argv,
                        const TestConfig* config)
 {
     FILE *output = NULL;
+    HistogramJob* jobs = NULL;
+
+    /* Without hash names, run every available hash function */
+    const size_t job_count = argc > 1 ? (size_t) argc - 1
+                                      : histogram_variant_count;
 
     SAFE_BLOCK_START
     {
-        if (config->filename)
-        {
-            ASSERT_MESSAGE(
-                output = fopen(config->filename,
-                                config->append_to_file ? "a" : "w"),
-                action_result != NULL,
-                "Failed to open output file");
-        }
-        else output = stdout;
+        for (int i = 1; i < argc; ++i)
+            ASSERT_MESSAGE(find_variant(argv[i]), action_result != NULL,
+                           "Unknown hash function");
 
+        ASSERT_MESSAGE(output = open_output(config), action_result != NULL,
+                       "Failed to open output file");
+
+        ASSERT_MESSAGE(
+            jobs = (HistogramJob*) calloc(job_count, sizeof(*jobs)),
+            action_result != NULL,
+            "Failed to allocate memory");
     }
     SAFE_BLOCK_HANDLE_ERRORS
     {
@@ -44,33 +188,328 @@ int run_test_histogram([[maybe_unused]] int argc,
         return 1;
     }
     SAFE_BLOCK_END
-    
-    srand(0);
 
-    FixedHashTable table = {};
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        jobs[i].variant = argc > 1 ? find_variant(argv[i + 1])
+                                   : &histogram_variants[i];
+        jobs[i].bucket_count = 1000;
+        jobs[i].key_count = 1'000'000;
+        jobs[i].dist = KEY_DIST_UNIFORM;
+        jobs[i].seed = 0;
+    }
+
+    int status = run_jobs(jobs, job_count, get_thread_count());
+
+    for (size_t i = 0; status == 0 && i < job_count; ++i)
+    {
+        fputs(jobs[i].variant->hash_name, output);
+        for (size_t j = 0; j < jobs[i].bucket_count; ++j)
+            fprintf(output, ",%zu", jobs[i].bucket_sizes[j]);
+        fputc('\n', output);
+    }
+
+    free_jobs(jobs, job_count);
+    if (output != stdout)
+        fclose(output);
+
+    return status < 0 ? 1 : 0;
+}
+
+int run_test_histogram_sweep(int argc, const char* const* argv,
+                             const TestConfig* config)
+{
+    FILE *output = NULL;
+    HistogramJob* jobs = NULL;
+    size_t thread_count = get_thread_count();
+
+    const size_t job_count = histogram_variant_count * KEY_DIST_COUNT
+                           * sweep_bucket_count_count;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 2, action_result,
+                       "Expected at most number of threads");
+        if (argc > 1)
+            ASSERT_MESSAGE(thread_count = strtoul(argv[1], NULL, 10),
+                           action_result > 0 && action_result <= 1024,
+                           "Invalid number of threads");
+
+        ASSERT_MESSAGE(output = open_output(config), action_result != NULL,
+                       "Failed to open output file");
+
+        ASSERT_MESSAGE(
+            jobs = (HistogramJob*) calloc(job_count, sizeof(*jobs)),
+            action_result != NULL,
+            "Failed to allocate memory");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    size_t job = 0;
+    for (size_t i = 0; i < histogram_variant_count; ++i)
+        for (size_t dist = 0; dist < KEY_DIST_COUNT; ++dist)
+            for (size_t j = 0; j < sweep_bucket_count_count; ++j, ++job)
+            {
+                jobs[job].variant = &histogram_variants[i];
+                jobs[job].bucket_count = sweep_bucket_counts[j];
+                jobs[job].key_count = sweep_keys_per_bucket
+                                    * sweep_bucket_counts[j];
+                jobs[job].dist = (key_dist) dist;
+                jobs[job].seed = (unsigned) job;
+            }
+
+    int status = run_jobs(jobs, job_count, thread_count);
+
+    /* hash,distribution,bucket_count,bucket sizes... */
+    for (size_t i = 0; status == 0 && i < job_count; ++i)
+    {
+        fprintf(output, "%s,%s,%zu", jobs[i].variant->hash_name,
+                                     key_dist_names[jobs[i].dist],
+                                     jobs[i].bucket_count);
+        for (size_t j = 0; j < jobs[i].bucket_count; ++j)
+            fprintf(output, ",%zu", jobs[i].bucket_sizes[j]);
+        fputc('\n', output);
+    }
+
+    free_jobs(jobs, job_count);
+    if (output != stdout)
+        fclose(output);
+
+    return status < 0 ? 1 : 0;
+}
+
+int run_test_corpus_histogram(int argc, const char* const* argv,
+                              const TestConfig* config)
+{
+    FILE *output = NULL;
+    HistogramJob* jobs = NULL;
+    corpus_format format = CORPUS_FORMAT_TEXT;
+    size_t bucket_count = 0;
+    struct stat info = {};
+
+    const size_t job_count = argc > 4 ? (size_t) argc - 4 : 0;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc > 4, action_result,
+            "Expected corpus file, format, bucket count and hash functions");
+        ASSERT_ZERO_MESSAGE(stat(argv[1], &info),
+                            "Failed to open corpus file");
+        ASSERT_ZERO_MESSAGE(corpus_parse_format(argv[2], &format),
+                            "Unknown corpus format");
+        ASSERT_MESSAGE(bucket_count = strtoul(argv[3], NULL, 10),
+                       action_result > 0,
+                       "Invalid bucket count");
+        for (int i = 4; i < argc; ++i)
+            ASSERT_MESSAGE(find_variant(argv[i]), action_result != NULL,
+                           "Unknown hash function");
+
+        ASSERT_MESSAGE(output = open_output(config), action_result != NULL,
+                       "Failed to open output file");
+
+        ASSERT_MESSAGE(
+            jobs = (HistogramJob*) calloc(job_count, sizeof(*jobs)),
+            action_result != NULL,
+            "Failed to allocate memory");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        if (output && output != stdout)
+            fclose(output);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    /* Every thread streams its own copy of corpus */
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        jobs[i].variant = find_variant(argv[i + 4]);
+        jobs[i].bucket_count = bucket_count;
+        jobs[i].corpus_path = argv[1];
+        jobs[i].format = format;
+        jobs[i].key_count = (size_t) info.st_size;
+    }
+
+    int status = run_jobs(jobs, job_count, get_thread_count());
+    if (status < 0)
+        fputs("Error: Failed to read corpus\n", stderr);
+
+    for (size_t i = 0; status == 0 && i < job_count; ++i)
+    {
+        fputs(jobs[i].variant->hash_name, output);
+        for (size_t j = 0; j < jobs[i].bucket_count; ++j)
+            fprintf(output, ",%zu", jobs[i].bucket_sizes[j]);
+        fputc('\n', output);
+    }
+
+    free_jobs(jobs, job_count);
+    if (output != stdout)
+        fclose(output);
+
+    return status < 0 ? 1 : 0;
+}
+
+static const HistogramVariant* find_variant(const char* hash_name)
+{
+    for (size_t i = 0; i < histogram_variant_count; ++i)
+        if (strcmp(histogram_variants[i].hash_name, hash_name) == 0)
+            return &histogram_variants[i];
+
+    return NULL;
+}
+
+static int run_jobs(HistogramJob* jobs, size_t job_count,
+                    size_t thread_count)
+{
+    size_t total_keys = 0;
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        jobs[i].bucket_sizes = (size_t*) calloc(jobs[i].bucket_count,
+                                                sizeof(*jobs[i].bucket_sizes));
+        if (!jobs[i].bucket_sizes)
+            return -1;
+        total_keys += jobs[i].key_count;
+    }
+
+    HistogramQueue queue = {
+        .jobs = jobs,
+        .job_count = job_count,
+        .next_job = 0,
+        .done_jobs = 0,
+        .done_keys = 0
+    };
+
+    if (thread_count > job_count)
+        thread_count = job_count;
+
+    pthread_t* threads = (pthread_t*) calloc(thread_count, sizeof(*threads));
+    if (!threads)
+        return -1;
+
+    size_t started = 0;
+    for (; started < thread_count; ++started)
+        if (pthread_create(&threads[started], NULL, run_worker, &queue) != 0)
+            break;
+
+    /* Started workers finish remaining jobs anyway */
+    const timespec period = {
+        .tv_sec = 0,
+        .tv_nsec = (long) progress_period_ms * 1'000'000
+    };
+    while (started > 0
+            && __atomic_load_n(&queue.done_jobs, __ATOMIC_ACQUIRE) < job_count)
+    {
+        progress_bar(__atomic_load_n(&queue.done_keys, __ATOMIC_RELAXED),
+                     total_keys, NAN);
+        nanosleep(&period, NULL);
+    }
+
+    for (size_t i = 0; i < started; ++i)
+        pthread_join(threads[i], NULL);
+    free(threads);
+
+    progress_bar(total_keys, total_keys, NAN);
+    putchar('\n');
+
+    if (started == 0)
+        return -1;
+
+    for (size_t i = 0; i < job_count; ++i)
+        if (jobs[i].status < 0)
+            return -1;
 
-    fixed_hash_table_ctor(&table, 1000);
-    fill_table(&table, 1'000'000);
-    dump_contents(output, &table);
-    fixed_hash_table_dtor(&table);
-    fclose(output);
-    
     return 0;
 }
 
-static void dump_contents(FILE* output, const FixedHashTable* table)
+static void* run_worker(void* queue_ptr)
+{
+    HistogramQueue* queue = (HistogramQueue*) queue_ptr;
+
+    for (;;)
+    {
+        const size_t index = __atomic_fetch_add(&queue->next_job, 1,
+                                                __ATOMIC_RELAXED);
+        if (index >= queue->job_count)
+            break;
+
+        HistogramJob* job = &queue->jobs[index];
+        job->status = job->variant->run(job, &queue->done_keys);
+
+        __atomic_fetch_add(&queue->done_jobs, 1, __ATOMIC_RELEASE);
+    }
+
+    return NULL;
+}
+
+static void free_jobs(HistogramJob* jobs, size_t job_count)
+{
+    for (size_t i = 0; i < job_count; ++i)
+        free(jobs[i].bucket_sizes);
+    free(jobs);
+}
+
+template <typename Preset, typename Preset::hash_fn* Hash>
+static int build_histogram(HistogramJob* job, size_t* progress)
 {
-    fputs(STR(HASH_FUNCTION), output);
+    FixedHashTable<Preset, Hash> table = {};
 
-    for (size_t i = 0; i < table->bucket_count; ++i)
+    if (fixed_hash_table_ctor(&table, job->bucket_count) < 0)
+        return -1;
+
+    int status = 0;
+    if (job->corpus_path)
+        status = fill_table_corpus(&table, job->corpus_path, job->format,
+                                   progress);
+    else
+        fill_table(&table, job->key_count, job->dist, &job->seed, progress);
+
+    for (size_t i = 0; i < table.bucket_count; ++i)
+        job->bucket_sizes[i] = get_bucket_size(&table.buckets[i]);
+
+    fixed_hash_table_dtor(&table);
+    return status;
+}
+
+template <typename Preset, typename Preset::hash_fn* Hash>
+static int fill_table_corpus(FixedHashTable<Preset, Hash>* table,
+                             const char* path, corpus_format format,
+                             size_t* progress)
+{
+    Corpus corpus = {};
+    if (corpus_open(path, format, &corpus) < 0)
+        return -1;
+
+    typename Preset::key_type key = {};
+    size_t reported = 0;
+    int status = 0;
+
+    while ((status = corpus_next(&corpus, &key)) > 0)
     {
-        const FixedHashTableEntry* entry = &table->buckets[i];
-        fprintf(output, ",%zu", get_bucket_size(entry));
+        fixed_hash_table_add_key(table, key);
+
+        const size_t offset = corpus_get_offset(&corpus);
+        if (offset - reported >= progress_step * 64)
+        {
+            __atomic_fetch_add(progress, offset - reported, __ATOMIC_RELAXED);
+            reported = offset;
+        }
     }
-    fputc('\n', output);
+
+    __atomic_fetch_add(progress, corpus.file_size - reported,
+                       __ATOMIC_RELAXED);
+    corpus_close(&corpus);
+
+    return status;
 }
 
-static size_t get_bucket_size(const FixedHashTableEntry* head)
+template <typename Entry>
+static size_t get_bucket_size(const Entry* head)
 {
     size_t size = 0;
     while ((head = head->next))
@@ -79,48 +518,87 @@ static size_t get_bucket_size(const FixedHashTableEntry* head)
     return size;
 }
 
-#if defined HASH_TABLE_KEY_INT
-
-void fill_table(FixedHashTable* table, size_t data_size)
+template <HashPresetInt::hash_fn* Hash>
+static void fill_table(FixedHashTable<HashPresetInt, Hash>* table,
+                       size_t data_size, key_dist dist, unsigned* seed,
+                       size_t* progress)
 {
     for (size_t i = 0; i < data_size; ++i)
     {
-        fixed_hash_table_add_key(table, rand());
-        progress_bar(i, data_size, NAN);
+        int32_t key = 0;
+        switch (dist)
+        {
+        case KEY_DIST_SEQUENTIAL: key = (int32_t) i;          break;
+        case KEY_DIST_STRUCTURED: key = (int32_t) (i * 1024); break;
+        case KEY_DIST_UNIFORM:
+        case KEY_DIST_COUNT:
+        default:
+            key = rand_r(seed);
+            break;
+        }
+
+        fixed_hash_table_add_key(table, key);
+        report_progress(i, progress);
     }
 }
 
-#elif defined HASH_TABLE_KEY_DOUBLE
-
-void fill_table(FixedHashTable* table, size_t data_size)
+template <HashPresetDouble::hash_fn* Hash>
+static void fill_table(FixedHashTable<HashPresetDouble, Hash>* table,
+                       size_t data_size, key_dist dist, unsigned* seed,
+                       size_t* progress)
 {
     for (size_t i = 0; i < data_size; ++i)
     {
-        fixed_hash_table_add_key(table,
-                (double) rand() * ((double)rand() / (double)rand()));
-        progress_bar(i, data_size, NAN);
+        double key = 0;
+        switch (dist)
+        {
+        case KEY_DIST_SEQUENTIAL: key = (double) i;          break;
+        case KEY_DIST_STRUCTURED: key = (double) i / 1024.0; break;
+        case KEY_DIST_UNIFORM:
+        case KEY_DIST_COUNT:
+        default:
+            key = (double) rand_r(seed)
+                * ((double) rand_r(seed) / (double) rand_r(seed));
+            break;
+        }
+
+        fixed_hash_table_add_key(table, key);
+        report_progress(i, progress);
     }
 }
 
-#elif defined HASH_TABLE_KEY_STR
-
-void fill_table(FixedHashTable* table, size_t data_size)
+template <HashPresetStr::hash_fn* Hash>
+static void fill_table(FixedHashTable<HashPresetStr, Hash>* table,
+                       size_t data_size, key_dist dist, unsigned* seed,
+                       size_t* progress)
 {
     const size_t max_len = 512;
+    const size_t structured_len = 8;
     char buffer[max_len] = "";
 
     for (size_t i = 0; i < data_size; ++i)
     {
-        size_t length = (size_t) rand() % max_len;
-        buffer[length] = '\0';
-        for (size_t j = 0; j < length; ++j)
-            buffer[j] = (char) ('a' + rand()%26);
+        switch (dist)
+        {
+        case KEY_DIST_SEQUENTIAL:
+            snprintf(buffer, max_len, "%zu", i);
+            break;
+        case KEY_DIST_STRUCTURED:
+        case KEY_DIST_UNIFORM:
+        case KEY_DIST_COUNT:
+        default:
+        {
+            size_t length = dist == KEY_DIST_STRUCTURED
+                          ? structured_len
+                          : (size_t) rand_r(seed) % max_len;
+            buffer[length] = '\0';
+            for (size_t j = 0; j < length; ++j)
+                buffer[j] = (char) ('a' + rand_r(seed)%26);
+            break;
+        }
+        }
+
         fixed_hash_table_add_key(table, buffer);
-        progress_bar(i, data_size, NAN);
+        report_progress(i, progress);
     }
 }
-
-#else
-#error Unknown KEY_TYPE
-#endif
-
@@ -18,7 +18,46 @@
 
 #include "test_utils/config.h"
 
+/**
+ * @brief Fill table with 1000 buckets with 10^6 uniform keys and print
+ * bucket sizes. Test options are hash function names (all by default).
+ * Hash functions are processed in parallel.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
 int run_test_histogram(int argc, const char* const* argv,
                        const TestConfig* config);
 
+/**
+ * @brief Print bucket sizes for every combination of hash function, key
+ * distribution and bucket count, computed on worker threads. Test option
+ * is number of threads (number of online CPUs by default).
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_histogram_sweep(int argc, const char* const* argv,
+                             const TestConfig* config);
+
+/**
+ * @brief Fill table with keys from corpus file and print bucket sizes.
+ * Test options are corpus file, corpus format, number of buckets and
+ * hash function names. Key type is defined by hash function.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_corpus_histogram(int argc, const char* const* argv,
+                              const TestConfig* config);
+
 #endif /* histogram.h */
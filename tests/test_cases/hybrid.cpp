@@ -0,0 +1,379 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload/table_ops.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/display.h"
+
+#include "hybrid.h"
+
+/* Key `i` is taken at random from `[i * stride, (i + 1) * stride)`, so that
+ * set has density `1 / stride` */
+static const uint32_t strides[] = { 1, 2, 4, 8, 16, 64, 1024 };
+static const size_t stride_count = sizeof(strides) / sizeof(*strides);
+
+static const size_t max_key_count = 1lu << 20;
+
+/* Keys are erased in ascending order down to this many, which is too few to
+ * keep even a single chunk, so that chunked set returns to hash table */
+static const size_t max_kept_key_count = 512;
+
+/* Set is checked around the next erased key every this many erasures */
+static const size_t erase_check_period = 61;
+static const size_t erase_check_keys = 64;
+
+struct HybridOptions
+{
+    size_t key_count;
+    size_t lookup_count;
+};
+
+struct HybridKeys
+{
+    /** Present keys in random order */
+    uint32_t* keys;
+    /** Present keys in ascending order */
+    uint32_t* sorted;
+    uint32_t* hits;
+    uint32_t* misses;
+};
+
+typedef int hybrid_fn(FILE* output, const HybridOptions* options,
+                      const HybridKeys* keys, uint32_t stride);
+
+template <typename Ops>
+static int run_hybrid(FILE* output, const HybridOptions* options,
+                      const HybridKeys* keys, uint32_t stride);
+
+static hybrid_fn* const hybrid_runs[] = {
+    run_hybrid<OpenAddrOps>,
+    run_hybrid<HybridSetOps>,
+};
+static const size_t hybrid_run_count =
+                            sizeof(hybrid_runs) / sizeof(*hybrid_runs);
+
+static void generate_keys(HybridKeys* keys, const HybridOptions* options,
+                          uint32_t stride);
+
+template <typename Ops>
+static int run_erase(typename Ops::table_t* table,
+                     const HybridOptions* options, const HybridKeys* keys);
+
+__always_inline
+static const char* set_mode([[maybe_unused]] const OpenAddrHashTable* table)
+{
+    return "hash";
+}
+
+__always_inline
+static const char* set_mode(const HybridSet* set)
+{
+    return set->mode == HYBRID_SET_HASH ? "hash" : "chunked";
+}
+
+__always_inline
+static size_t count_bitmaps([[maybe_unused]] const OpenAddrHashTable* table)
+{
+    return 0;
+}
+
+__always_inline
+static size_t count_bitmaps(const HybridSet* set)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < set->chunk_count; ++i)
+        count += set->chunks[i].bitmap != NULL;
+    return count;
+}
+
+__always_inline
+static size_t count_chunks([[maybe_unused]] const OpenAddrHashTable* table)
+{
+    return 0;
+}
+
+__always_inline
+static size_t count_chunks(const HybridSet* set)
+{
+    return set->chunk_count;
+}
+
+int run_test_hybrid(int argc, const char* const* argv,
+                    const TestConfig* config)
+{
+    FILE *output = NULL;
+    HybridOptions options = {
+        .key_count = max_key_count,
+        .lookup_count = 1'000'000
+    };
+    HybridKeys keys = {};
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 3, action_result,
+            "Expected at most number of keys and number of lookups");
+        if (argc > 1)
+            ASSERT_MESSAGE(options.key_count = strtoul(argv[1], NULL, 10),
+                           action_result > 0 && action_result <= max_key_count,
+                           "Number of keys must be in range [1, 1048576]");
+        if (argc > 2)
+            ASSERT_MESSAGE(options.lookup_count = strtoul(argv[2], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of lookups");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+
+        ASSERT_MESSAGE(
+            keys.keys = (uint32_t*) calloc(options.key_count,
+                                           sizeof(*keys.keys)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ASSERT_MESSAGE(
+            keys.sorted = (uint32_t*) calloc(options.key_count,
+                                             sizeof(*keys.sorted)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ASSERT_MESSAGE(
+            keys.hits = (uint32_t*) calloc(options.lookup_count,
+                                           sizeof(*keys.hits)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ASSERT_MESSAGE(
+            keys.misses = (uint32_t*) calloc(options.lookup_count,
+                                             sizeof(*keys.misses)),
+            action_result != NULL,
+            "Failed to allocate memory");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        free(keys.keys);
+        free(keys.sorted);
+        free(keys.hits);
+        free(keys.misses);
+        if (output && output != stdout)
+            fclose(output);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    if (!config->append_to_file)
+        fputs("name,density,keys,capacity,bytes_per_key,insert_ns,hit_ns,"
+              "miss_ns,mode\n", output);
+
+    const size_t total = stride_count * hybrid_run_count;
+    size_t done = 0;
+    double last_ms = NAN;
+    int status = 0;
+
+    for (size_t i = 0; i < stride_count && status == 0; ++i)
+    {
+        generate_keys(&keys, &options, strides[i]);
+
+        for (size_t j = 0; j < hybrid_run_count && status == 0; ++j)
+        {
+            progress_bar(done++, total, last_ms);
+            const uint64_t start_ns = bench_time_ns();
+
+            status = hybrid_runs[j](output, &options, &keys, strides[i]);
+
+            last_ms = (double) (bench_time_ns() - start_ns) / 1e6;
+        }
+    }
+
+    progress_bar(total, total, NAN);
+    putchar('\n');
+
+    if (status == -1)
+        fputs("Error: Lookup results differ from inserted "
+              "and erased keys\n", stderr);
+    else if (status == -2)
+        fputs("Error: Chunked set did not turn bitmaps into arrays "
+              "or return to hash table after erasing keys\n", stderr);
+
+    free(keys.keys);
+    free(keys.sorted);
+    free(keys.hits);
+    free(keys.misses);
+    if (output != stdout)
+        fclose(output);
+
+    return status != 0;
+}
+
+/**
+ * @brief Insert all keys, measure lookups of present and absent keys, then
+ * erase keys and check set contents
+ *
+ * @return 0 upon success, -1 if lookups are wrong, -2 if chunked set did
+ * not change its representation while keys were erased
+ */
+template <typename Ops>
+static int run_hybrid(FILE* output, const HybridOptions* options,
+                      const HybridKeys* keys, uint32_t stride)
+{
+    const double key_count = (double) options->key_count;
+    const double lookup_count = (double) options->lookup_count;
+
+    typename Ops::table_t table = {};
+    Ops::ctor(&table, TABLE_HASH_FIBONACCI);
+
+    const uint64_t insert_start = bench_time_ns();
+    for (size_t i = 0; i < options->key_count; ++i)
+        Ops::insert(&table, keys->keys[i]);
+    const double insert_ns = (double) (bench_time_ns() - insert_start);
+
+    size_t found = 0;
+    const uint64_t hit_start = bench_time_ns();
+    for (size_t i = 0; i < options->lookup_count; ++i)
+        found += (size_t) Ops::contains(&table, keys->hits[i]);
+    const double hit_ns = (double) (bench_time_ns() - hit_start);
+
+    const uint64_t miss_start = bench_time_ns();
+    for (size_t i = 0; i < options->lookup_count; ++i)
+        found -= (size_t) Ops::contains(&table, keys->misses[i]);
+    const double miss_ns = (double) (bench_time_ns() - miss_start);
+
+    if (found != options->lookup_count)
+    {
+        Ops::dtor(&table);
+        return -1;
+    }
+
+    const char* const mode = set_mode(&table);
+    const size_t capacity = Ops::capacity(&table);
+    const size_t footprint = Ops::footprint(&table);
+
+    const int status = run_erase<Ops>(&table, options, keys);
+    Ops::dtor(&table);
+    if (status != 0)
+        return status;
+
+    /* name,density,keys,capacity,bytes_per_key,insert_ns,hit_ns,miss_ns,
+     * mode */
+    fprintf(output, "%s,%.6lf,%zu,%zu,%.3lf,%.1lf,%.1lf,%.1lf,%s\n",
+                    Ops::test_name, 1.0 / (double) stride,
+                    options->key_count, capacity,
+                    (double) footprint / key_count,
+                    insert_ns / key_count,
+                    hit_ns / lookup_count, miss_ns / lookup_count,
+                    mode);
+    fflush(output);
+
+    return 0;
+}
+
+/**
+ * @brief Erase keys in ascending order, so that chunks of chunked set are
+ * emptied one by one and each bitmap turns into array before its chunk is
+ * removed. Keys around the erased one are looked up periodically, and the
+ * whole set is checked in the end.
+ *
+ * @return 0 upon success, -1 if lookups are wrong, -2 if chunked set did
+ * not change its representation
+ */
+template <typename Ops>
+static int run_erase(typename Ops::table_t* table,
+                     const HybridOptions* options, const HybridKeys* keys)
+{
+    const size_t key_count = options->key_count;
+    const size_t kept = key_count / 2 < max_kept_key_count
+                      ? key_count / 2 : max_kept_key_count;
+    const size_t erased = key_count - kept;
+
+    const int was_chunked = strcmp(set_mode(table), "chunked") == 0;
+    const int had_bitmaps = count_bitmaps(table) > 0;
+
+    /* Bitmap turned into array, if their number decreased, while chunk
+     * holding it was not removed */
+    int converted = 0;
+    size_t bitmaps = count_bitmaps(table);
+    size_t chunks = count_chunks(table);
+
+    for (size_t i = 0; i < erased; ++i)
+    {
+        if (Ops::erase(table, keys->sorted[i]) != 0)
+            return -1;
+
+        if (i % erase_check_period != 0)
+            continue;
+
+        if (Ops::contains(table, keys->sorted[i]))
+            return -1;
+        for (size_t j = i + 1; j < key_count && j <= i + erase_check_keys;
+                ++j)
+            if (!Ops::contains(table, keys->sorted[j]))
+                return -1;
+
+        const size_t new_bitmaps = count_bitmaps(table);
+        const size_t new_chunks = count_chunks(table);
+        converted |= new_bitmaps < bitmaps && new_chunks == chunks;
+        bitmaps = new_bitmaps;
+        chunks = new_chunks;
+    }
+
+    for (size_t i = 0; i < key_count; ++i)
+        if (Ops::contains(table, keys->sorted[i]) != (i >= erased))
+            return -1;
+
+    if (was_chunked && strcmp(set_mode(table), "hash") != 0)
+        return -2;
+    if (had_bitmaps && !converted)
+        return -2;
+
+    return 0;
+}
+
+/**
+ * @brief Generate keys in ascending and random order, present ones and
+ * absent ones, which lie in gaps between keys, or above key range if there
+ * are no gaps
+ */
+static void generate_keys(HybridKeys* keys, const HybridOptions* options,
+                          uint32_t stride)
+{
+    srand(0);
+    for (size_t i = 0; i < options->key_count; ++i)
+        keys->keys[i] = (uint32_t) i * stride + (uint32_t) rand() % stride;
+    memcpy(keys->sorted, keys->keys, options->key_count * sizeof(*keys->keys));
+
+    for (size_t i = options->key_count - 1; i > 0; --i)
+    {
+        const size_t j = (size_t) rand() % (i + 1);
+        const uint32_t tmp = keys->keys[i];
+        keys->keys[i] = keys->keys[j];
+        keys->keys[j] = tmp;
+    }
+
+    const uint32_t range = (uint32_t) options->key_count * stride;
+    for (size_t i = 0; i < options->lookup_count; ++i)
+    {
+        keys->hits[i] = keys->keys[(size_t) rand() % options->key_count];
+
+        if (stride == 1)
+        {
+            keys->misses[i] = range + (uint32_t) rand() % range;
+            continue;
+        }
+
+        /* Any other key of the same stride */
+        const size_t index = (size_t) rand() % options->key_count;
+        const uint32_t base = (uint32_t) index * stride;
+        const uint32_t offset = keys->sorted[index] - base;
+        keys->misses[i] = base + (offset + 1 + (uint32_t) rand() % (stride - 1))
+                                                                    % stride;
+    }
+}
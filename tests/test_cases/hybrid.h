@@ -0,0 +1,32 @@
+/**
+ * @file hybrid.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-06-04
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_HYBRID_H
+#define __TESTS_TEST_CASES_HYBRID_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Compare hybrid set with open addressing table on key sets of
+ * densities from 1 to 1/1024, then erase most keys and check that chunked
+ * sets return to hash table. Test options are number of keys and number
+ * of lookups.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_hybrid(int argc, const char* const* argv,
+                    const TestConfig* config);
+
+#endif /* hybrid.h */
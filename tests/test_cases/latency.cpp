@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload/workload.h"
+
+#include "test_utils/bench.h"
+
+#include "latency.h"
+
+static double get_ticks_per_ns(void);
+
+static void print_histogram(FILE* output, const char* test_name,
+                            const char* op_name,
+                            const LatencyHistogram* histogram,
+                            double ticks_per_ns);
+
+int run_test_latency(int argc, const char* const* argv,
+                     const TestConfig* config)
+{
+    FILE *output = NULL;
+    LatencyRecorder* recorder = NULL;
+    const WorkloadVariant* variant = NULL;
+    table_hash hash = TABLE_HASH_FIBONACCI;
+    size_t repeat = 1'000'000;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 5, action_result,
+            "Expected at most table type, generator, hash and command count");
+        ASSERT_MESSAGE(
+            variant = workload_find(argc > 1 ? argv[1] : "closed_addr",
+                                    argc > 2 ? argv[2] : "rand_cmd"),
+            action_result != NULL,
+            "Unknown table type or command generator");
+        if (argc > 3)
+            ASSERT_ZERO_MESSAGE(workload_parse_hash(argv[3], &hash),
+                                "Unknown hash function");
+        if (argc > 4)
+            ASSERT_MESSAGE(repeat = strtoul(argv[4], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of commands");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+
+        ASSERT_MESSAGE(
+            recorder = (LatencyRecorder*) calloc(1, sizeof(*recorder)),
+            action_result != NULL,
+            "Failed to allocate memory");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    const double ticks_per_ns = get_ticks_per_ns();
+
+    variant->run_recorded(repeat, hash, recorder);
+
+    /* name,op,count,p50_ns,p90_ns,p99_ns,p999_ns,max_ns */
+    print_histogram(output, variant->test_name, "insert",
+                    &recorder->insert, ticks_per_ns);
+    print_histogram(output, variant->test_name, "erase",
+                    &recorder->erase, ticks_per_ns);
+    print_histogram(output, variant->test_name, "contains",
+                    &recorder->contains, ticks_per_ns);
+    print_histogram(output, variant->test_name, "rehash",
+                    &recorder->rehash, ticks_per_ns);
+
+    free(recorder);
+    if (output != stdout)
+        fclose(output);
+
+    return 0;
+}
+
+static double get_ticks_per_ns(void)
+{
+    const uint64_t calibration_ns = 20'000'000;
+
+    const uint64_t start_ns = bench_time_ns();
+    const uint64_t start_ticks = bench_cycles();
+
+    uint64_t now_ns = start_ns;
+    while (now_ns - start_ns < calibration_ns)
+        now_ns = bench_time_ns();
+
+    return (double) (bench_cycles() - start_ticks)
+         / (double) (now_ns - start_ns);
+}
+
+static void print_histogram(FILE* output, const char* test_name,
+                            const char* op_name,
+                            const LatencyHistogram* histogram,
+                            double ticks_per_ns)
+{
+    const double percentiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    const size_t percentile_count = sizeof(percentiles) / sizeof(*percentiles);
+
+    fprintf(output, "%s,%s,%lu", test_name, op_name, histogram->total);
+    for (size_t i = 0; i < percentile_count; ++i)
+        fprintf(output, ",%.1lf",
+            (double) latency_histogram_percentile(histogram, percentiles[i])
+                / ticks_per_ns);
+    fprintf(output, ",%.1lf\n", (double) histogram->max / ticks_per_ns);
+}
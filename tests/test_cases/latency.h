@@ -0,0 +1,31 @@
+/**
+ * @file latency.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-23
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_LATENCY_H
+#define __TESTS_TEST_CASES_LATENCY_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Record latency of every command of table workload and report
+ * percentiles per command type. Test options are table type, command
+ * generator, table hash and number of commands.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_latency(int argc, const char* const* argv,
+                     const TestConfig* config);
+
+#endif /* latency.h */
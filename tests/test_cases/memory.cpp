@@ -0,0 +1,130 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload/table_ops.h"
+#include "workload/workload.h"
+
+#include "test_utils/display.h"
+#include "test_utils/memory.h"
+
+#include "memory.h"
+
+static const size_t min_key_count = 1024;
+static const size_t key_count_growth = 4;
+
+template <typename Ops>
+static void run_table(FILE* output, table_hash hash, size_t max_keys,
+                      size_t* done, size_t total);
+
+int run_test_memory(int argc, const char* const* argv,
+                    const TestConfig* config)
+{
+    FILE *output = NULL;
+    table_hash hash = TABLE_HASH_FIBONACCI;
+    size_t max_keys = 1lu << 22;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 3, action_result,
+                       "Expected at most hash and maximal number of keys");
+        if (argc > 1)
+            ASSERT_ZERO_MESSAGE(workload_parse_hash(argv[1], &hash),
+                                "Unknown hash function");
+        if (argc > 2)
+            ASSERT_MESSAGE(max_keys = strtoul(argv[2], NULL, 10),
+                           action_result >= min_key_count,
+                           "Invalid maximal number of keys");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    if (memory_reset_peak_rss() < 0)
+        fprintf(stderr, "Warning: cannot reset peak RSS, "
+                        "reporting peak over process lifetime\n");
+
+    size_t steps = 0;
+    for (size_t keys = min_key_count; keys <= max_keys;
+                                      keys *= key_count_growth)
+        ++steps;
+
+    fputs("name,keys,capacity,load_factor,table_bytes,heap_bytes,"
+          "bytes_per_key,peak_heap_bytes,allocs,reallocs,frees,"
+          "allocs_per_insert,alloc_bytes_per_insert,peak_rss_kb\n", output);
+
+    size_t done = 0;
+    run_table<OpenAddrOps>  (output, hash, max_keys, &done, 5 * steps);
+    run_table<HopscotchOps> (output, hash, max_keys, &done, 5 * steps);
+    run_table<ClosedAddrOps>(output, hash, max_keys, &done, 5 * steps);
+    run_table<HybridSetOps> (output, hash, max_keys, &done, 5 * steps);
+    run_table<FixedOps<hash_int_multiplicative>>
+                            (output, hash, max_keys, &done, 5 * steps);
+    progress_bar(done, 5 * steps, NAN);
+    putchar('\n');
+
+    if (output != stdout)
+        fclose(output);
+
+    return 0;
+}
+
+template <typename Ops>
+static void run_table(FILE* output, table_hash hash, size_t max_keys,
+                      size_t* done, size_t total)
+{
+    for (size_t keys = min_key_count; keys <= max_keys;
+                                      keys *= key_count_growth)
+    {
+        progress_bar((*done)++, total, NAN);
+
+        memory_reset_peak_rss();
+        memory_hook_reset();
+        memory_hook_enable(1);
+
+        typename Ops::table_t table = {};
+        Ops::ctor(&table, hash);
+        for (size_t i = 0; i < keys; ++i)
+            Ops::insert(&table, (uint32_t) i);
+
+        memory_hook_enable(0);
+
+        AllocStats stats = {};
+        memory_hook_get_stats(&stats);
+        const size_t peak_rss_kb = memory_get_peak_rss_kb();
+        const size_t capacity  = Ops::capacity(&table);
+        const size_t footprint = Ops::footprint(&table);
+
+        Ops::dtor(&table);
+
+        const double key_count = (double) keys;
+        fprintf(output, "%s,%zu,%zu,%.3lf,%zu,%ld,%.2lf,%ld,%zu,%zu,%zu,"
+                        "%.4lf,%.2lf,%zu\n",
+                        Ops::test_name, keys, capacity,
+                        key_count / (double) capacity, footprint,
+                        stats.live_bytes,
+                        (double) stats.live_bytes / key_count,
+                        stats.peak_live_bytes,
+                        stats.malloc_calls + stats.calloc_calls,
+                        stats.realloc_calls, stats.free_calls,
+                        (double) (stats.malloc_calls + stats.calloc_calls)
+                                                            / key_count,
+                        (double) stats.allocated_bytes / key_count,
+                        peak_rss_kb);
+    }
+}
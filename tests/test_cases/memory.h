@@ -0,0 +1,31 @@
+/**
+ * @file memory.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-27
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_MEMORY_H
+#define __TESTS_TEST_CASES_MEMORY_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Fill every table type with increasing number of keys and report
+ * heap bytes per key, allocation counts and peak resident set size. Test
+ * options are table hash and maximal number of keys.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_memory(int argc, const char* const* argv,
+                    const TestConfig* config);
+
+#endif /* memory.h */
@@ -0,0 +1,201 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload/table_ops.h"
+#include "workload/workload.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/display.h"
+#include "test_utils/keys.h"
+
+#include "probing.h"
+
+static const double min_load_factor = 0.5;
+static const double load_factor_step = 0.05;
+static const size_t load_factor_count = 10;
+
+/* Strided keys with identity hash share `size / key_stride` home slots */
+static const uint32_t key_stride = 256;
+
+struct ProbingOptions
+{
+    table_hash hash;
+    size_t size_exp;
+    size_t lookup_count;
+};
+
+typedef int probing_fn(FILE* output, const ProbingOptions* options,
+                       KeyLookups* keys, size_t* done, size_t total);
+
+template <typename Ops>
+static int run_probe(FILE* output, const ProbingOptions* options,
+                     KeyLookups* keys, size_t* done, size_t total);
+
+static probing_fn* const probe_runs[] = {
+    run_probe<OpenAddrOps>,
+    run_probe<OpenAddrTriangularOps>,
+    run_probe<OpenAddrDoubleOps>,
+    run_probe<OpenAddrCacheLineOps>,
+};
+static const size_t probe_run_count = sizeof(probe_runs) / sizeof(*probe_runs);
+
+int run_test_probing(int argc, const char* const* argv,
+                     const TestConfig* config)
+{
+    FILE *output = NULL;
+    ProbingOptions options = {
+        .hash = TABLE_HASH_FIBONACCI,
+        .size_exp = 16,
+        .lookup_count = 100'000
+    };
+    KeyLookups keys = {};
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 4, action_result,
+            "Expected at most hash, table size exponent "
+            "and number of lookups");
+        if (argc > 1)
+            ASSERT_ZERO_MESSAGE(workload_parse_hash(argv[1], &options.hash),
+                                "Unknown hash function");
+        if (argc > 2)
+            ASSERT_MESSAGE(options.size_exp = strtoul(argv[2], NULL, 10),
+                           action_result >= 10 && action_result <= 22,
+                           "Table size exponent must be in range [10, 22]");
+        if (argc > 3)
+            ASSERT_MESSAGE(options.lookup_count = strtoul(argv[3], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of lookups");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+
+        ASSERT_MESSAGE(
+            keys.hits = (uint32_t*) calloc(options.lookup_count,
+                                           sizeof(*keys.hits)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ASSERT_MESSAGE(
+            keys.misses = (uint32_t*) calloc(options.lookup_count,
+                                             sizeof(*keys.misses)),
+            action_result != NULL,
+            "Failed to allocate memory");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        free(keys.hits);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    if (!config->append_to_file)
+        fputs("name,hash,key_set,keys,capacity,load_factor,"
+              "hit_ns,miss_ns\n", output);
+
+    const size_t total = probe_run_count * KEY_SET_COUNT * load_factor_count;
+    size_t done = 0;
+    int status = 0;
+
+    for (size_t i = 0; i < probe_run_count && status == 0; ++i)
+        status = probe_runs[i](output, &options, &keys, &done, total);
+
+    progress_bar(total, total, NAN);
+    putchar('\n');
+
+    if (status != 0)
+        fputs("Error: Lookup results differ from inserted keys\n", stderr);
+
+    free(keys.hits);
+    free(keys.misses);
+    if (output != stdout)
+        fclose(output);
+
+    return status != 0;
+}
+
+/**
+ * @brief Fill table of fixed size to every load factor and measure lookups
+ * of present and absent keys
+ */
+template <typename Ops>
+static int run_probe(FILE* output, const ProbingOptions* options,
+                     KeyLookups* keys, size_t* done, size_t total)
+{
+    const size_t capacity = 1lu << options->size_exp;
+    const double lookup_count = (double) options->lookup_count;
+    double last_ms = NAN;
+
+    for (size_t set_index = 0; set_index < KEY_SET_COUNT; ++set_index)
+    {
+        const key_set set = (key_set) set_index;
+
+        typename Ops::table_t table = {};
+        Ops::ctor(&table, options->hash);
+
+        /* Table reaches tested size with default fill factor, which is
+         * then raised. Keys are inserted incrementally, so table at every
+         * load factor contains keys of all smaller ones. */
+        size_t key_count = 0;
+        for (; key_count < capacity / 2; ++key_count)
+            Ops::insert(&table, get_key(set, key_count, key_stride));
+        open_addr_hash_table_set_fill_factor(&table, 0.99);
+
+        for (size_t step = 0; step < load_factor_count; ++step)
+        {
+            progress_bar((*done)++, total, last_ms);
+            const uint64_t start_ns = bench_time_ns();
+
+            const double load_factor = min_load_factor
+                                     + (double) step * load_factor_step;
+            const size_t target = (size_t) (load_factor * (double) capacity);
+            for (; key_count < target; ++key_count)
+                Ops::insert(&table, get_key(set, key_count, key_stride));
+
+            generate_lookups(keys, set, key_count, options->lookup_count,
+                             key_stride);
+
+            size_t found = 0;
+            const uint64_t hit_start = bench_time_ns();
+            for (size_t i = 0; i < options->lookup_count; ++i)
+                found += (size_t) Ops::contains(&table, keys->hits[i]);
+            const double hit_ns = (double) (bench_time_ns() - hit_start);
+
+            const uint64_t miss_start = bench_time_ns();
+            for (size_t i = 0; i < options->lookup_count; ++i)
+                found -= (size_t) Ops::contains(&table, keys->misses[i]);
+            const double miss_ns = (double) (bench_time_ns() - miss_start);
+
+            if (found != options->lookup_count
+                    || Ops::capacity(&table) != capacity)
+            {
+                Ops::dtor(&table);
+                return -1;
+            }
+
+            /* name,hash,key_set,keys,capacity,load_factor,hit_ns,miss_ns */
+            fprintf(output, "%s,%s,%s,%zu,%zu,%.3lf,%.1lf,%.1lf\n",
+                            Ops::test_name, TABLE_HASH_NAMES[options->hash],
+                            KEY_SET_NAMES[set], key_count, capacity,
+                            (double) key_count / (double) capacity,
+                            hit_ns / lookup_count, miss_ns / lookup_count);
+            fflush(output);
+
+            last_ms = (double) (bench_time_ns() - start_ns) / 1e6;
+        }
+
+        Ops::dtor(&table);
+    }
+
+    return 0;
+}
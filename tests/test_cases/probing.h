@@ -0,0 +1,32 @@
+/**
+ * @file probing.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_PROBING_H
+#define __TESTS_TEST_CASES_PROBING_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Measure lookups in open addressing table with every probe sequence
+ * at load factors from 0.5 to 0.95 for random, sequential and strided keys.
+ * Test options are hash, base 2 logarithm of table size and number of
+ * lookups.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_probing(int argc, const char* const* argv,
+                     const TestConfig* config);
+
+#endif /* probing.h */
@@ -0,0 +1,510 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "hash_table/sharded_hash_table.h"
+#include "workload/workload.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/display.h"
+
+#include "scaling.h"
+
+enum scaling_table
+{
+    /** Single table behind one lock */
+    SCALING_LOCKED      = 0,
+    /** Table split into shards with separate locks */
+    SCALING_SHARDED     = 1,
+    /** Every thread owns separate table, no synchronization */
+    SCALING_PER_THREAD  = 2,
+    SCALING_TABLE_COUNT
+};
+
+static const char* const scaling_table_names[SCALING_TABLE_COUNT] = {
+    "locked",
+    "sharded",
+    "per_thread",
+};
+
+static const char* const scaling_test_names[SCALING_TABLE_COUNT] = {
+    "locked_hash_table",
+    "sharded_hash_table",
+    "per_thread_hash_table",
+};
+
+static const size_t sharded_shard_exp = 6;
+static const size_t key_range = 1lu << 20;
+
+/* Commands are generated in advance and repeated cyclically */
+static const size_t op_buffer_size = 1lu << 16;
+/* Stop flag is checked once in this many commands */
+static const size_t stop_check_period = 1024;
+
+struct ScalingOptions
+{
+    scaling_table table;
+    trace_mix mix;
+    int shared_keys;
+    size_t max_threads;
+    double duration_ms;
+};
+
+/** State shared by all threads of one run */
+struct ScalingRun
+{
+    const ScalingOptions* options;
+    /** NULL for per-thread tables */
+    ShardedHashTable* table;
+    size_t thread_count;
+
+    /** Threads wait until `started` is set, main thread waits until all
+     * of them are `ready` */
+    pthread_mutex_t start_lock;
+    pthread_cond_t  start_cond;
+    size_t ready;
+    int started;
+
+    int stop;
+};
+
+struct alignas(64) ScalingThread
+{
+    pthread_t thread;
+    ScalingRun* run;
+    size_t index;
+
+    uint64_t done_ops;
+    int had_error;
+};
+
+struct ScalingResult
+{
+    double mops;
+    double min_thread_mops;
+    double max_thread_mops;
+    /** Jain's fairness index, 1 if all threads did equal work */
+    double fairness;
+};
+
+static int parse_table(const char* name, scaling_table* table);
+
+static int run_threads(const ScalingOptions* options, size_t thread_count,
+                       ScalingThread* threads, ScalingResult* result);
+
+static void open_start_gate(ScalingRun* run, size_t wait_count);
+
+static void* run_thread(void* context);
+
+template <scaling_table Table>
+static void run_ops(ScalingThread* self, OpenAddrHashTable* own,
+                    const uint8_t* ops, const uint32_t* keys);
+
+static uint32_t get_key(const ScalingRun* run, size_t thread_index,
+                        unsigned* seed);
+
+static size_t get_partition_size(const ScalingRun* run);
+
+static uint32_t get_partition_key(const ScalingRun* run, size_t thread_index,
+                                  size_t offset);
+
+static void prefill(const ScalingRun* run, size_t thread_index,
+                    OpenAddrHashTable* own);
+
+int run_test_scaling(int argc, const char* const* argv,
+                     const TestConfig* config)
+{
+    FILE *output = NULL;
+    ScalingThread* threads = NULL;
+    ScalingResult* results = NULL;
+
+    const long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    ScalingOptions options = {
+        .table = SCALING_SHARDED,
+        .mix = TRACE_MIX_READ_HEAVY,
+        .shared_keys = 1,
+        .max_threads = cpu_count > 0 ? (size_t) cpu_count : 1,
+        .duration_ms = 200
+    };
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 6, action_result,
+            "Expected at most table type, command mix, key partitioning, "
+            "thread count and duration");
+        if (argc > 1)
+            ASSERT_ZERO_MESSAGE(parse_table(argv[1], &options.table),
+                                "Unknown table type");
+        if (argc > 2)
+            ASSERT_ZERO_MESSAGE(trace_parse_mix(argv[2], &options.mix),
+                                "Unknown command mix");
+        if (argc > 3)
+        {
+            ASSERT_MESSAGE(strcasecmp(argv[3], "shared") == 0
+                            || strcasecmp(argv[3], "disjoint") == 0,
+                           action_result,
+                           "Key partitioning must be shared or disjoint");
+            options.shared_keys = strcasecmp(argv[3], "shared") == 0;
+        }
+        if (argc > 4)
+            ASSERT_MESSAGE(options.max_threads = strtoul(argv[4], NULL, 10),
+                           action_result > 0 && action_result <= 1024,
+                           "Invalid number of threads");
+        if (argc > 5)
+            ASSERT_MESSAGE(options.duration_ms = strtod(argv[5], NULL),
+                           action_result > 0,
+                           "Invalid duration");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+
+        ASSERT_MESSAGE(
+            threads = (ScalingThread*) aligned_alloc(alignof(ScalingThread),
+                                options.max_threads * sizeof(*threads)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ASSERT_MESSAGE(
+            results = (ScalingResult*) calloc(options.max_threads,
+                                              sizeof(*results)),
+            action_result != NULL,
+            "Failed to allocate memory");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        free(threads);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    int status = 0;
+    for (size_t i = 0; i < options.max_threads && status == 0; ++i)
+    {
+        progress_bar(i, options.max_threads, NAN);
+        status = run_threads(&options, i + 1, threads, &results[i]);
+    }
+    progress_bar(options.max_threads, options.max_threads, NAN);
+    putchar('\n');
+
+    if (status == 0)
+    {
+        fputs("name,mix,keys,threads,mops,speedup,fairness,"
+              "min_thread_mops,max_thread_mops\n", output);
+
+        for (size_t i = 0; i < options.max_threads; ++i)
+            fprintf(output, "%s,%s,%s,%zu,%.3lf,%.3lf,%.4lf,%.3lf,%.3lf\n",
+                            scaling_test_names[options.table],
+                            TRACE_MIX_NAMES[options.mix],
+                            options.shared_keys ? "shared" : "disjoint",
+                            i + 1, results[i].mops,
+                            results[i].mops / results[0].mops,
+                            results[i].fairness,
+                            results[i].min_thread_mops,
+                            results[i].max_thread_mops);
+    }
+    else fprintf(stderr, "Error: Failed to run threads\n");
+
+    free(threads);
+    free(results);
+    if (output != stdout)
+        fclose(output);
+
+    return status < 0 ? 1 : 0;
+}
+
+static int parse_table(const char* name, scaling_table* table)
+{
+    for (size_t i = 0; i < SCALING_TABLE_COUNT; ++i)
+    {
+        if (strcasecmp(scaling_table_names[i], name) == 0)
+        {
+            *table = (scaling_table) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+static int run_threads(const ScalingOptions* options, size_t thread_count,
+                       ScalingThread* threads, ScalingResult* result)
+{
+    ShardedHashTable table = {};
+    ScalingRun run = {
+        .options = options,
+        .table = NULL,
+        .thread_count = thread_count,
+        .start_lock = PTHREAD_MUTEX_INITIALIZER,
+        .start_cond = PTHREAD_COND_INITIALIZER,
+        .ready = 0,
+        .started = 0,
+        .stop = 0
+    };
+
+    if (options->table != SCALING_PER_THREAD)
+    {
+        const size_t shard_exp = options->table == SCALING_SHARDED
+                                    ? sharded_shard_exp : 0;
+        if (sharded_hash_table_ctor(&table, shard_exp) < 0)
+            return -1;
+        run.table = &table;
+        prefill(&run, 0, NULL);
+    }
+
+    size_t started = 0;
+    for (; started < thread_count; ++started)
+    {
+        memset(&threads[started], 0, sizeof(threads[started]));
+        threads[started].run = &run;
+        threads[started].index = started;
+        if (pthread_create(&threads[started].thread, NULL, run_thread,
+                           &threads[started]) != 0)
+            break;
+    }
+
+    int status = 0;
+    if (started < thread_count)
+    {
+        /* Started threads are let through and exit without running */
+        __atomic_store_n(&run.stop, 1, __ATOMIC_RELAXED);
+        open_start_gate(&run, 0);
+        for (size_t i = 0; i < started; ++i)
+            pthread_join(threads[i].thread, NULL);
+        status = -1;
+    }
+    else
+    {
+        open_start_gate(&run, thread_count);
+        const uint64_t start_ns = bench_time_ns();
+
+        const uint64_t duration_ns = (uint64_t) (options->duration_ms * 1e6);
+        const timespec duration = {
+            .tv_sec  = (time_t) (duration_ns / 1'000'000'000),
+            .tv_nsec = (long)   (duration_ns % 1'000'000'000)
+        };
+        nanosleep(&duration, NULL);
+
+        __atomic_store_n(&run.stop, 1, __ATOMIC_RELAXED);
+        for (size_t i = 0; i < thread_count; ++i)
+            pthread_join(threads[i].thread, NULL);
+
+        const double elapsed_us = (double) (bench_time_ns() - start_ns) / 1e3;
+
+        double sum = 0, sum_squares = 0;
+        result->min_thread_mops = INFINITY;
+        result->max_thread_mops = 0;
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            if (threads[i].had_error)
+                status = -1;
+
+            const double mops = (double) threads[i].done_ops / elapsed_us;
+            sum += mops;
+            sum_squares += mops * mops;
+            result->min_thread_mops = fmin(result->min_thread_mops, mops);
+            result->max_thread_mops = fmax(result->max_thread_mops, mops);
+        }
+
+        result->mops = sum;
+        result->fairness = sum * sum / ((double) thread_count * sum_squares);
+    }
+
+    pthread_cond_destroy(&run.start_cond);
+    pthread_mutex_destroy(&run.start_lock);
+    if (run.table)
+        sharded_hash_table_dtor(&table);
+
+    return status;
+}
+
+/* Wait until `wait_count` threads are ready, then let all of them run */
+static void open_start_gate(ScalingRun* run, size_t wait_count)
+{
+    pthread_mutex_lock(&run->start_lock);
+    while (run->ready < wait_count)
+        pthread_cond_wait(&run->start_cond, &run->start_lock);
+    run->started = 1;
+    pthread_cond_broadcast(&run->start_cond);
+    pthread_mutex_unlock(&run->start_lock);
+}
+
+static void* run_thread(void* context)
+{
+    ScalingThread* self = (ScalingThread*) context;
+    ScalingRun* run = self->run;
+
+    const long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu_count > 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(self->index % (size_t) cpu_count, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+
+    uint8_t*  ops  = (uint8_t*)  calloc(op_buffer_size, sizeof(*ops));
+    uint32_t* keys = (uint32_t*) calloc(op_buffer_size, sizeof(*keys));
+    if (!ops || !keys)
+        self->had_error = 1;
+
+    unsigned seed = (unsigned) self->index + 1;
+    const trace_mix mix = run->options->mix;
+    for (size_t i = 0; !self->had_error && i < op_buffer_size; ++i)
+    {
+        const unsigned roll = (unsigned) rand_r(&seed) % 100;
+        if (roll < TRACE_MIX_PERCENTS[mix][0])
+            ops[i] = CMD_INSERT;
+        else if (roll < TRACE_MIX_PERCENTS[mix][0] + TRACE_MIX_PERCENTS[mix][1])
+            ops[i] = CMD_ERASE;
+        else
+            ops[i] = CMD_CONTAINS;
+        keys[i] = get_key(run, self->index, &seed);
+    }
+
+    OpenAddrHashTable own = {};
+    if (run->options->table == SCALING_PER_THREAD)
+    {
+        open_addr_hash_table_ctor(&own);
+        prefill(run, self->index, &own);
+    }
+
+    pthread_mutex_lock(&run->start_lock);
+    ++run->ready;
+    pthread_cond_broadcast(&run->start_cond);
+    while (!run->started)
+        pthread_cond_wait(&run->start_cond, &run->start_lock);
+    pthread_mutex_unlock(&run->start_lock);
+
+    if (!self->had_error && !__atomic_load_n(&run->stop, __ATOMIC_RELAXED))
+    {
+        switch (run->options->table)
+        {
+        case SCALING_LOCKED:
+        case SCALING_SHARDED:
+            run_ops<SCALING_SHARDED>(self, &own, ops, keys);
+            break;
+        case SCALING_PER_THREAD:
+            run_ops<SCALING_PER_THREAD>(self, &own, ops, keys);
+            break;
+        case SCALING_TABLE_COUNT:
+        default:
+            break;
+        }
+    }
+
+    open_addr_hash_table_dtor(&own);
+    free(ops);
+    free(keys);
+
+    return NULL;
+}
+
+template <scaling_table Table>
+static void run_ops(ScalingThread* self, OpenAddrHashTable* own,
+                    const uint8_t* ops, const uint32_t* keys)
+{
+    ShardedHashTable* table = self->run->table;
+    const int* stop = &self->run->stop;
+
+    uint64_t done = 0;
+    for (size_t i = 0; ; i = (i + 1) & (op_buffer_size - 1))
+    {
+        if constexpr (Table == SCALING_PER_THREAD)
+        {
+            switch ((command) ops[i])
+            {
+            case CMD_INSERT:   open_addr_hash_table_insert  (own, keys[i]);
+                               break;
+            case CMD_ERASE:    open_addr_hash_table_erase   (own, keys[i]);
+                               break;
+            case CMD_CONTAINS: open_addr_hash_table_contains(own, keys[i]);
+                               break;
+            default:
+                break;
+            }
+        }
+        else
+        {
+            switch ((command) ops[i])
+            {
+            case CMD_INSERT:   sharded_hash_table_insert  (table, keys[i]);
+                               break;
+            case CMD_ERASE:    sharded_hash_table_erase   (table, keys[i]);
+                               break;
+            case CMD_CONTAINS: sharded_hash_table_contains(table, keys[i]);
+                               break;
+            default:
+                break;
+            }
+        }
+
+        ++done;
+        if (done % stop_check_period == 0
+                && __atomic_load_n(stop, __ATOMIC_RELAXED))
+            break;
+    }
+
+    self->done_ops = done;
+}
+
+/* Disjoint keys of thread are congruent to its index modulo thread count */
+static uint32_t get_key(const ScalingRun* run, size_t thread_index,
+                        unsigned* seed)
+{
+    const size_t random = (size_t) rand_r(seed);
+    return get_partition_key(run, thread_index,
+                             random % get_partition_size(run));
+}
+
+static size_t get_partition_size(const ScalingRun* run)
+{
+    return run->options->shared_keys ? key_range
+                                     : key_range / run->thread_count;
+}
+
+static uint32_t get_partition_key(const ScalingRun* run, size_t thread_index,
+                                  size_t offset)
+{
+    if (run->options->shared_keys)
+        return (uint32_t) offset;
+
+    return (uint32_t) (offset * run->thread_count + thread_index);
+}
+
+/* Half of keys of every partition is present before the run */
+static void prefill(const ScalingRun* run, size_t thread_index,
+                    OpenAddrHashTable* own)
+{
+    const size_t partition = get_partition_size(run);
+
+    /* Shared table holds partitions of all threads */
+    const size_t owner_count = own || run->options->shared_keys
+                                    ? 1 : run->thread_count;
+    for (size_t owner = 0; owner < owner_count; ++owner)
+    {
+        const size_t index = own ? thread_index : owner;
+        for (size_t offset = 0; offset < partition; offset += 2)
+        {
+            const uint32_t key = get_partition_key(run, index, offset);
+            if (own)
+                open_addr_hash_table_insert(own, key);
+            else
+                sharded_hash_table_insert(run->table, key);
+        }
+    }
+}
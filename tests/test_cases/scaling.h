@@ -0,0 +1,33 @@
+/**
+ * @file scaling.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-28
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_SCALING_H
+#define __TESTS_TEST_CASES_SCALING_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Run command mix from 1 up to N pinned threads against thread-safe
+ * table and report throughput, speedup and per-thread fairness. Test
+ * options are table type (locked, sharded or per_thread), command mix,
+ * key partitioning (shared or disjoint), maximal number of threads (number
+ * of online CPUs by default) and duration of every run in milliseconds.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_scaling(int argc, const char* const* argv,
+                     const TestConfig* config);
+
+#endif /* scaling.h */
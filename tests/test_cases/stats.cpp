@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload/table_ops.h"
+
+#include "stats.h"
+
+static const size_t min_key_count = 1024;
+static const size_t max_key_count = 1lu << 24;
+
+typedef FixedOps<hash_int_identity> FixedIdentityOps;
+
+typedef int stats_fn(FILE* output, size_t key_count);
+
+template <typename Ops>
+static int run_stats(FILE* output, size_t key_count);
+
+static stats_fn* const stats_runs[] = {
+    run_stats<OpenAddrOps>,
+    run_stats<ClosedAddrOps>,
+    run_stats<HopscotchOps>,
+    run_stats<FixedIdentityOps>,
+};
+static const size_t stats_run_count = sizeof(stats_runs) / sizeof(*stats_runs);
+
+int run_test_stats(int argc, const char* const* argv,
+                   const TestConfig* config)
+{
+    FILE *output = NULL;
+    size_t key_count = 1'000'000;
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 2, action_result,
+                       "Expected at most number of keys");
+        if (argc > 1)
+            ASSERT_MESSAGE(key_count = strtoul(argv[1], NULL, 10),
+                           action_result >= min_key_count
+                                && action_result <= max_key_count,
+                           "Number of keys must be in range [1024, 16777216]");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    if (!config->append_to_file)
+        fputs("name,keys,capacity,hit_probe_mean,hit_probe_max,chain_mean,"
+              "chain_max,max_displacement,tombstone_ratio,rehashes,"
+              "rehash_ms,check\n", output);
+
+    int status = 0;
+    int failed = 0;
+    for (size_t i = 0; i < stats_run_count && status >= 0; ++i)
+    {
+        status = stats_runs[i](output, key_count);
+        failed |= status;
+    }
+
+    if (status < 0)
+        fputs("Error: Table statistics are disabled, "
+              "rebuild with 'make STATS=1'\n", stderr);
+    else if (failed)
+        fputs("Error: Lookups of sequential keys under identity hash "
+              "inspected more than one slot\n", stderr);
+
+    if (output != stdout)
+        fclose(output);
+
+    return status < 0 || failed;
+}
+
+template <typename Ops>
+static void identity_ctor(typename Ops::table_t* table,
+                          [[maybe_unused]] size_t key_count)
+{
+    Ops::ctor(table, TABLE_HASH_IDENTITY);
+}
+
+/* Key `k` lands in bucket `k` */
+template <>
+void identity_ctor<FixedIdentityOps>(FixedIdentityOps::table_t* table,
+                                     size_t key_count)
+{
+    FixedIdentityOps::ctor(table, TABLE_HASH_IDENTITY, key_count);
+}
+
+static int get_stats(const OpenAddrHashTable* table, TableStats* stats)
+{
+    return open_addr_hash_table_get_stats(table, stats);
+}
+
+static int get_stats(const ClosedAddrHashTable* table, TableStats* stats)
+{
+    return closed_addr_hash_table_get_stats(table, stats);
+}
+
+static int get_stats(const HopscotchHashTable* table, TableStats* stats)
+{
+    return hopscotch_hash_table_get_stats(table, stats);
+}
+
+static int get_stats(const FixedIdentityOps::table_t* table, TableStats* stats)
+{
+    return fixed_hash_table_get_stats(table, stats);
+}
+
+/**
+ * @brief Insert keys `0..key_count-1` and look all of them up. Under
+ * identity hash every key has its own home slot or bucket, so that every
+ * lookup must inspect exactly one slot or node.
+ *
+ * @return 0 if check passed, 1 if it failed, -1 if statistics are disabled
+ */
+template <typename Ops>
+static int run_stats(FILE* output, size_t key_count)
+{
+    typename Ops::table_t table = {};
+    identity_ctor<Ops>(&table, key_count);
+
+    for (size_t key = 0; key < key_count; ++key)
+        Ops::insert(&table, (uint32_t) key);
+
+    TableStats filled = {};
+    TableStats looked_up = {};
+    if (get_stats(&table, &filled) < 0)
+    {
+        Ops::dtor(&table);
+        return -1;
+    }
+
+    size_t found = 0;
+    for (size_t key = 0; key < key_count; ++key)
+        found += (size_t) Ops::contains(&table, (uint32_t) key);
+
+    get_stats(&table, &looked_up);
+
+    /* Insertions are recorded too, so lookups are the difference */
+    size_t lookups = 0, probes = 0, max_probe = 0;
+    for (size_t i = 0; i < TABLE_STATS_HIST_SIZE; ++i)
+    {
+        const size_t count = (size_t) (looked_up.probe_lengths[i]
+                                       - filled.probe_lengths[i]);
+        lookups += count;
+        probes  += count * i;
+        if (count)
+            max_probe = i;
+    }
+
+    size_t chains = 0, chain_keys = 0, max_chain = 0;
+    for (size_t i = 1; i < TABLE_STATS_HIST_SIZE; ++i)
+    {
+        const size_t count = (size_t) looked_up.chain_lengths[i];
+        chains     += count;
+        chain_keys += count * i;
+        if (count)
+            max_chain = i;
+    }
+
+    const int passed = found == key_count && lookups == key_count
+                    && probes == key_count && max_probe == 1
+                    && looked_up.max_displacement == 0;
+
+    /* name,keys,capacity,hit_probe_mean,hit_probe_max,chain_mean,chain_max,
+     * max_displacement,tombstone_ratio,rehashes,rehash_ms,check */
+    fprintf(output, "%s,%zu,%zu,%.3lf,%zu,%.3lf,%zu,%zu,%.4lf,%zu,%.3lf,%s\n",
+                    Ops::test_name, key_count, Ops::capacity(&table),
+                    lookups ? (double) probes / (double) lookups : 0,
+                    max_probe,
+                    chains ? (double) chain_keys / (double) chains : 0,
+                    max_chain, looked_up.max_displacement,
+                    looked_up.tombstone_ratio,
+                    (size_t) looked_up.rehash_count,
+                    (double) looked_up.rehash_ns / 1e6,
+                    passed ? "ok" : "failed");
+    fflush(output);
+
+    Ops::dtor(&table);
+    return passed ? 0 : 1;
+}
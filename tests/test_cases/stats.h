@@ -0,0 +1,32 @@
+/**
+ * @file stats.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-06-06
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_STATS_H
+#define __TESTS_TEST_CASES_STATS_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Report telemetry of open addressing, closed addressing, hopscotch
+ * and fixed tables filled with sequential keys under identity hash, and
+ * check that every lookup inspects one slot or node. Requires build with
+ * `STATS=1`. Test option is number of keys.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_stats(int argc, const char* const* argv,
+                   const TestConfig* config);
+
+#endif /* stats.h */
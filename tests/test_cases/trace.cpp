@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload/trace.h"
+
+#include "trace.h"
+
+int run_test_trace(int argc, const char* const* argv,
+                   [[maybe_unused]] const TestConfig* config)
+{
+    TraceSpec spec = {
+        .keys = TRACE_KEYS_UNIFORM,
+        .mix = TRACE_MIX_BALANCED,
+        .count = 1'000'000,
+        .key_range = 1lu << 31,
+        .seed = 0
+    };
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc >= 2 && argc <= 6, action_result,
+            "Expected output file, key distribution, command mix, "
+            "command count and key range");
+        if (argc > 2)
+            ASSERT_ZERO_MESSAGE(trace_parse_keys(argv[2], &spec.keys),
+                                "Unknown key distribution");
+        if (argc > 3)
+            ASSERT_ZERO_MESSAGE(trace_parse_mix(argv[3], &spec.mix),
+                                "Unknown command mix");
+        if (argc > 4)
+            ASSERT_MESSAGE(spec.count = strtoul(argv[4], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of commands");
+        if (argc > 5)
+            ASSERT_MESSAGE(spec.key_range = strtoul(argv[5], NULL, 10),
+                           action_result > 0 && action_result <= 1lu << 32,
+                           "Invalid key range");
+
+        ASSERT_ZERO_MESSAGE(trace_generate(argv[1], &spec),
+                            "Failed to write trace");
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    return 0;
+}
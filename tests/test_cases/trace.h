@@ -0,0 +1,30 @@
+/**
+ * @file trace.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-25
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_TRACE_H
+#define __TESTS_TEST_CASES_TRACE_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Generate binary command trace. Test options are output file,
+ * key distribution, command mix, number of commands and key range.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_trace(int argc, const char* const* argv,
+                   const TestConfig* config);
+
+#endif /* trace.h */
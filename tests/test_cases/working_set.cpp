@@ -0,0 +1,311 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include "meerkat_assert/asserts.h"
+
+#include "workload/table_ops.h"
+#include "workload/workload.h"
+
+#include "test_utils/bench.h"
+#include "test_utils/cache_info.h"
+#include "test_utils/display.h"
+#include "test_utils/keys.h"
+
+#include "working_set.h"
+
+enum steady_op
+{
+    /** Lookup of present key */
+    OP_HIT      = 0,
+    /** Lookup of absent key */
+    OP_MISS     = 1,
+    /** Erase of present key immediately followed by its insertion */
+    OP_UPDATE   = 2,
+};
+
+/* Probabilities of hit and miss in percent, rest are updates */
+static const unsigned hit_percent  = 45;
+static const unsigned miss_percent = 45;
+
+static const size_t min_capacity_exp = 10;
+
+struct SweepOptions
+{
+    table_hash hash;
+    double load_factor;
+    size_t max_bytes;
+    size_t op_count;
+};
+
+struct SteadyOps
+{
+    uint8_t*  ops;
+    uint32_t* keys;
+    size_t count;
+};
+
+template <typename Ops>
+struct SteadyContext
+{
+    typename Ops::table_t* table;
+    const SteadyOps* ops;
+};
+
+typedef int sweep_fn(FILE* output, const SweepOptions* options,
+                     const CacheInfo* cache, SteadyOps* ops);
+
+struct SweepVariant
+{
+    const char* table_name;
+    sweep_fn* run;
+};
+
+template <typename Ops>
+static int run_sweep(FILE* output, const SweepOptions* options,
+                     const CacheInfo* cache, SteadyOps* ops);
+
+static const SweepVariant sweep_variants[] = {
+    { OpenAddrOps::name,   run_sweep<OpenAddrOps>   },
+    { HopscotchOps::name,  run_sweep<HopscotchOps>  },
+    { ClosedAddrOps::name, run_sweep<ClosedAddrOps> },
+};
+static const size_t sweep_variant_count =
+                        sizeof(sweep_variants) / sizeof(*sweep_variants);
+
+static const SweepVariant* find_variant(const char* table_name);
+
+static void generate_ops(SteadyOps* ops, size_t key_count);
+
+template <typename Ops>
+static void run_steady(void* context);
+
+int run_test_working_set(int argc, const char* const* argv,
+                         const TestConfig* config)
+{
+    FILE *output = NULL;
+    const SweepVariant* variant = NULL;
+    SteadyOps ops = {};
+    size_t max_mib = 0;
+
+    CacheInfo cache = {};
+    cache_info_detect(&cache);
+
+    SweepOptions options = {
+        .hash = TABLE_HASH_FIBONACCI,
+        .load_factor = 0.5,
+        .max_bytes = 10 * cache.sizes[CACHE_LLC],
+        .op_count = 1'000'000
+    };
+
+    SAFE_BLOCK_START
+    {
+        ASSERT_MESSAGE(argc <= 6, action_result,
+            "Expected at most table type, hash, load factor, "
+            "maximal footprint and command count");
+        ASSERT_MESSAGE(
+            variant = find_variant(argc > 1 ? argv[1] : "closed_addr"),
+            action_result != NULL,
+            "Unknown table type");
+        if (argc > 2)
+            ASSERT_ZERO_MESSAGE(workload_parse_hash(argv[2], &options.hash),
+                                "Unknown hash function");
+        if (argc > 3)
+            ASSERT_MESSAGE(options.load_factor = strtod(argv[3], NULL),
+                           action_result > 0 && action_result < 0.75,
+                           "Load factor must be in range (0, 0.75)");
+        if (argc > 4)
+            ASSERT_MESSAGE(max_mib = strtoul(argv[4], NULL, 10),
+                           action_result > 0,
+                           "Invalid maximal footprint");
+        if (argc > 5)
+            ASSERT_MESSAGE(options.op_count = strtoul(argv[5], NULL, 10),
+                           action_result > 0,
+                           "Invalid number of commands");
+
+        if (config->filename)
+        {
+            ASSERT_MESSAGE(
+                output = fopen(config->filename,
+                                config->append_to_file ? "a" : "w"),
+                action_result != NULL,
+                "Failed to open output file");
+        }
+        else output = stdout;
+
+        ASSERT_MESSAGE(
+            ops.ops  = (uint8_t*)  calloc(options.op_count, sizeof(*ops.ops)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ASSERT_MESSAGE(
+            ops.keys = (uint32_t*) calloc(options.op_count, sizeof(*ops.keys)),
+            action_result != NULL,
+            "Failed to allocate memory");
+        ops.count = options.op_count;
+
+        if (max_mib)
+            options.max_bytes = max_mib << 20;
+    }
+    SAFE_BLOCK_HANDLE_ERRORS
+    {
+        fprintf(stderr, "Error: %s\n", assertion_info.message);
+        free(ops.ops);
+        return 1;
+    }
+    SAFE_BLOCK_END
+
+    fprintf(stderr, "Cache sizes: L1 %zuK, L2 %zuK, LLC %zuK\n",
+                    cache.sizes[CACHE_L1]  / 1024,
+                    cache.sizes[CACHE_L2]  / 1024,
+                    cache.sizes[CACHE_LLC] / 1024);
+
+    fputs("name,hash,keys,capacity,load_factor,bytes,level,"
+          "ns_per_op,stddev_ns_per_op,ci95_ns_per_op,cycles_per_op\n", output);
+
+    const int status = variant->run(output, &options, &cache, &ops);
+    putchar('\n');
+
+    if (status < 0)
+        fprintf(stderr, "Error: Failed to run benchmark\n");
+
+    free(ops.ops);
+    free(ops.keys);
+    if (output != stdout)
+        fclose(output);
+
+    return status < 0 ? 1 : 0;
+}
+
+static const SweepVariant* find_variant(const char* table_name)
+{
+    for (size_t i = 0; i < sweep_variant_count; ++i)
+        if (strcasecmp(sweep_variants[i].table_name, table_name) == 0)
+            return &sweep_variants[i];
+
+    return NULL;
+}
+
+template <typename Ops>
+static int run_sweep(FILE* output, const SweepOptions* options,
+                     const CacheInfo* cache, SteadyOps* ops)
+{
+    const BenchOptions bench_options = BENCH_DEFAULT_OPTIONS;
+
+    typename Ops::table_t table = {};
+    Ops::ctor(&table, options->hash);
+
+    srand(0);
+
+    size_t key_count = 0;
+    size_t footprint = 0;
+    double last_ms = NAN;
+
+    /* Keys are inserted incrementally, so table of every size contains
+     * keys of all smaller ones */
+    for (size_t exp = min_capacity_exp;
+         footprint < options->max_bytes && exp < 32; ++exp)
+    {
+        const size_t target = (size_t) (options->load_factor
+                                        * (double) (1lu << exp));
+        for (; key_count < target; ++key_count)
+            if (Ops::insert(&table, get_key(key_count)) < 0)
+            {
+                Ops::dtor(&table);
+                return -1;
+            }
+
+        footprint = Ops::footprint(&table);
+        progress_bar(footprint < options->max_bytes ? footprint >> 10
+                                                    : options->max_bytes >> 10,
+                     options->max_bytes >> 10, last_ms);
+
+        generate_ops(ops, key_count);
+
+        SteadyContext<Ops> context = {
+            .table = &table,
+            .ops = ops
+        };
+
+        BenchResult result = {};
+        const uint64_t start_ns = bench_time_ns();
+        if (bench_measure(run_steady<Ops>, &context, &bench_options,
+                          &result) < 0)
+        {
+            Ops::dtor(&table);
+            return -1;
+        }
+        last_ms = (double) (bench_time_ns() - start_ns) / 1e6;
+
+        const double op_count = (double) ops->count;
+        const size_t capacity = Ops::capacity(&table);
+        fprintf(output, "%s,%s,%zu,%zu,%.3lf,%zu,%s,%.3lf,%.3lf,%.3lf,%.2lf\n",
+                        Ops::test_name, TABLE_HASH_NAMES[options->hash],
+                        key_count, capacity,
+                        (double) key_count / (double) capacity, footprint,
+                        CACHE_LEVEL_NAMES[cache_info_fit(cache, footprint)],
+                        result.mean_ns / op_count, result.stddev_ns / op_count,
+                        result.ci95_ns / op_count,
+                        result.mean_cycles / op_count);
+        fflush(output);
+    }
+
+    Ops::dtor(&table);
+    return 0;
+}
+
+static void generate_ops(SteadyOps* ops, size_t key_count)
+{
+    const size_t absent_count = (1lu << 32) - key_count;
+
+    for (size_t i = 0; i < ops->count; ++i)
+    {
+        const unsigned roll = (unsigned) rand() % 100;
+        const size_t index = (size_t) rand() * (size_t) RAND_MAX + (size_t) rand();
+
+        if (roll < hit_percent)
+        {
+            ops->ops[i] = OP_HIT;
+            ops->keys[i] = get_key(index % key_count);
+        }
+        else if (roll < hit_percent + miss_percent)
+        {
+            ops->ops[i] = OP_MISS;
+            ops->keys[i] = get_key(key_count + index % absent_count);
+        }
+        else
+        {
+            ops->ops[i] = OP_UPDATE;
+            ops->keys[i] = get_key(index % key_count);
+        }
+    }
+}
+
+/* Table contents are the same before and after the call */
+template <typename Ops>
+static void run_steady(void* context)
+{
+    const SteadyContext<Ops>* steady = (const SteadyContext<Ops>*) context;
+
+    typename Ops::table_t* table = steady->table;
+    const uint8_t*  ops   = steady->ops->ops;
+    const uint32_t* keys  = steady->ops->keys;
+    const size_t    count = steady->ops->count;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        switch ((steady_op) ops[i])
+        {
+        case OP_HIT:
+        case OP_MISS:
+            Ops::contains(table, keys[i]);
+            break;
+        case OP_UPDATE:
+            Ops::erase (table, keys[i]);
+            Ops::insert(table, keys[i]);
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,33 @@
+/**
+ * @file working_set.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief
+ *
+ * @version 0.1
+ * @date 2023-05-26
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_CASES_WORKING_SET_H
+#define __TESTS_TEST_CASES_WORKING_SET_H
+
+#include "test_utils/config.h"
+
+/**
+ * @brief Prefill table to target load factor and measure fixed number of
+ * steady-state commands, doubling table capacity from L1-resident size up
+ * to maximal footprint. Test options are table type, table hash, load
+ * factor, maximal table footprint in MiB (10 times LLC size by default)
+ * and number of measured commands.
+ *
+ * @param[in] argc	    - Argument vector length
+ * @param[in] argv	    - Argument vector
+ * @param[in] config	- Test configuration
+ *
+ * @return Exit status
+ */
+int run_test_working_set(int argc, const char* const* argv,
+                         const TestConfig* config);
+
+#endif /* working_set.h */
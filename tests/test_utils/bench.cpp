@@ -0,0 +1,104 @@
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+#include <x86intrin.h>
+
+#include "./math.h"
+
+#include "./bench.h"
+
+uint64_t bench_time_ns(void)
+{
+    timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t) ts.tv_sec * 1'000'000'000lu + (uint64_t) ts.tv_nsec;
+}
+
+uint64_t bench_cycles(void)
+{
+    unsigned aux = 0;
+    return __rdtscp(&aux);
+}
+
+static size_t calibrate(bench_fn* function, void* context, double min_ns);
+
+int bench_measure(bench_fn* function, void* context,
+                  const BenchOptions* options, BenchResult* result)
+{
+    if (!function || !options || !result || options->samples < 2)
+        return -1;
+
+    double* sample_ns     = (double*) calloc(options->samples, sizeof(double));
+    double* sample_cycles = (double*) calloc(options->samples, sizeof(double));
+    if (!sample_ns || !sample_cycles)
+    {
+        free(sample_ns);
+        free(sample_cycles);
+        return -1;
+    }
+
+    const size_t reps = calibrate(function, context,
+                                  options->min_sample_ms * 1e6);
+
+    for (size_t i = 0; i < options->warmup_samples * reps; ++i)
+        function(context);
+
+    if (options->counters)
+        perf_counters_start(options->counters);
+
+    for (size_t i = 0; i < options->samples; ++i)
+    {
+        const uint64_t start_cycles = bench_cycles();
+        const uint64_t start_ns     = bench_time_ns();
+
+        for (size_t j = 0; j < reps; ++j)
+            function(context);
+
+        const uint64_t end_ns     = bench_time_ns();
+        const uint64_t end_cycles = bench_cycles();
+
+        sample_ns[i]     = (double) (end_ns - start_ns) / (double) reps;
+        sample_cycles[i] = (double) (end_cycles - start_cycles) / (double) reps;
+    }
+
+    for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i)
+        result->counters[i] = NAN;
+
+    if (options->counters)
+    {
+        perf_counters_stop(options->counters);
+        if (perf_counters_read(options->counters, result->counters) == 0)
+            for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i)
+                result->counters[i] /= (double) (reps * options->samples);
+    }
+
+    result->repetitions = reps;
+    result->samples     = options->samples;
+    result->mean_ns     = get_mean(sample_ns, options->samples);
+    result->stddev_ns   = get_stddev(sample_ns, result->mean_ns,
+                                     options->samples);
+    result->ci95_ns     = get_confidence_95(result->stddev_ns,
+                                            options->samples);
+    result->mean_cycles = get_mean(sample_cycles, options->samples);
+
+    for (size_t i = 0; i < options->samples && i < BENCH_MAX_SAMPLES; ++i)
+        result->sample_ns[i] = sample_ns[i];
+
+    free(sample_ns);
+    free(sample_cycles);
+
+    return 0;
+}
+
+static size_t calibrate(bench_fn* function, void* context, double min_ns)
+{
+    /* First call also warms up caches and allocator */
+    uint64_t start = bench_time_ns();
+    function(context);
+    double single_ns = (double) (bench_time_ns() - start);
+
+    if (single_ns < 1)
+        single_ns = 1;
+
+    return (size_t) ceil(min_ns / single_ns);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file bench.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief In-process benchmark engine
+ *
+ * @version 0.1
+ * @date 2023-05-22
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_UTILS_BENCH_H
+#define __TESTS_TEST_UTILS_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "./perf_counters.h"
+
+/**
+ * @brief Measured code. Must perform the same work on every call.
+ *
+ * @param[inout] context - User-provided context
+ */
+typedef void bench_fn(void* context);
+
+struct BenchOptions
+{
+    /** Number of untimed calibrated runs before measurement */
+    size_t warmup_samples;
+    /** Number of timed samples */
+    size_t samples;
+    /** Minimal duration of one sample, calls are repeated to reach it */
+    double min_sample_ms;
+    /** Counters enabled during timed samples, may be NULL */
+    PerfCounters* counters;
+};
+
+/** Maximal number of samples stored in `BenchResult` */
+static const size_t BENCH_MAX_SAMPLES = 32;
+
+struct BenchResult
+{
+    /** Number of calls of measured function per sample */
+    size_t repetitions;
+    size_t samples;
+
+    /** Statistics of time of one call of measured function */
+    double mean_ns;
+    double stddev_ns;
+    /** Half-width of 95% confidence interval of mean */
+    double ci95_ns;
+
+    double mean_cycles;
+
+    /** Time of one call in every sample, first `BENCH_MAX_SAMPLES` only */
+    double sample_ns[BENCH_MAX_SAMPLES];
+
+    /** Counter values per call, NaN if not collected */
+    double counters[PERF_COUNTER_COUNT];
+};
+
+static const BenchOptions BENCH_DEFAULT_OPTIONS = {
+    .warmup_samples = 1,
+    .samples = 10,
+    .min_sample_ms = 10,
+    .counters = NULL
+};
+
+/**
+ * @brief Get monotonic time in nanoseconds
+ */
+uint64_t bench_time_ns(void);
+
+/**
+ * @brief Read timestamp counter, waiting for preceding instructions
+ */
+uint64_t bench_cycles(void);
+
+/**
+ * @brief Measure execution time of function. Function is first run once
+ * to calibrate number of calls per sample, then warmed up and measured.
+ *
+ * @param[in]    function   - Measured function
+ * @param[inout] context    - Context passed to `function`
+ * @param[in]    options    - Measurement options
+ * @param[out]   result     - Measurement results
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int bench_measure(bench_fn* function, void* context,
+                  const BenchOptions* options, BenchResult* result);
+
+#endif /* bench.h */
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <unistd.h>
+
+#include "./cache_info.h"
+
+static const size_t fallback_sizes[CACHE_DRAM] = {
+    32  * 1024,
+    256 * 1024,
+    8   * 1024 * 1024,
+};
+
+static size_t read_sysfs_size(unsigned level);
+
+void cache_info_detect(CacheInfo* info)
+{
+    const long sysconf_sizes[CACHE_DRAM] = {
+        sysconf(_SC_LEVEL1_DCACHE_SIZE),
+        sysconf(_SC_LEVEL2_CACHE_SIZE),
+        sysconf(_SC_LEVEL3_CACHE_SIZE),
+    };
+
+    for (unsigned i = 0; i < CACHE_DRAM; ++i)
+    {
+        size_t size = sysconf_sizes[i] > 0 ? (size_t) sysconf_sizes[i]
+                                           : read_sysfs_size(i + 1);
+        /* No L3, last level is L2 */
+        if (size == 0 && i == CACHE_LLC)
+            size = info->sizes[CACHE_L2];
+
+        info->sizes[i] = size ? size : fallback_sizes[i];
+    }
+
+    info->sizes[CACHE_DRAM] = 0;
+}
+
+cache_level cache_info_fit(const CacheInfo* info, size_t bytes)
+{
+    for (unsigned i = 0; i < CACHE_DRAM; ++i)
+        if (bytes <= info->sizes[i])
+            return (cache_level) i;
+
+    return CACHE_DRAM;
+}
+
+static size_t read_sysfs_size(unsigned level)
+{
+    for (unsigned index = 0; ; ++index)
+    {
+        char path[128] = "";
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu0/cache/index%u/level", index);
+
+        FILE* file = fopen(path, "r");
+        if (!file)
+            return 0;
+
+        unsigned found_level = 0;
+        const int read = fscanf(file, "%u", &found_level);
+        fclose(file);
+
+        if (read != 1 || found_level != level)
+            continue;
+
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu0/cache/index%u/type", index);
+        file = fopen(path, "r");
+        char type[16] = "";
+        if (file)
+        {
+            if (fscanf(file, "%15s", type) != 1)
+                type[0] = '\0';
+            fclose(file);
+        }
+        if (type[0] == 'I') /* Instruction cache */
+            continue;
+
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu0/cache/index%u/size", index);
+        file = fopen(path, "r");
+        if (!file)
+            return 0;
+
+        size_t size_kb = 0;
+        const int read_size = fscanf(file, "%zuK", &size_kb);
+        fclose(file);
+
+        return read_size == 1 ? size_kb * 1024 : 0;
+    }
+}
@@ -0,0 +1,52 @@
+/**
+ * @file cache_info.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief Data cache sizes of host CPU
+ *
+ * @version 0.1
+ * @date 2023-05-26
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_UTILS_CACHE_INFO_H
+#define __TESTS_TEST_UTILS_CACHE_INFO_H
+
+#include <stddef.h>
+
+enum cache_level
+{
+    CACHE_L1    = 0,
+    CACHE_L2    = 1,
+    CACHE_LLC   = 2,
+    CACHE_DRAM  = 3,
+    CACHE_LEVEL_COUNT
+};
+
+static const char* const CACHE_LEVEL_NAMES[CACHE_LEVEL_COUNT] = {
+    "L1",
+    "L2",
+    "LLC",
+    "DRAM",
+};
+
+struct CacheInfo
+{
+    /** Sizes in bytes, indexed by `cache_level` (DRAM size is unused) */
+    size_t sizes[CACHE_LEVEL_COUNT];
+};
+
+/**
+ * @brief Detect data cache sizes. Uses sysconf, falling back to sysfs and
+ * then to typical desktop values.
+ *
+ * @param[out] info - Detected cache sizes
+ */
+void cache_info_detect(CacheInfo* info);
+
+/**
+ * @brief Get smallest memory level which can hold `bytes` bytes
+ */
+cache_level cache_info_fit(const CacheInfo* info, size_t bytes);
+
+#endif /* cache_info.h */
@@ -10,6 +10,8 @@ int configure_tests(int argc, const char* const* argv, TestConfig* config)
     config->test_case = TEST_NONE;
     config->filename = NULL;
     config->append_to_file = 0;
+    config->write_samples = 0;
+    config->storage = STORAGE_HEAP;
 
     int parsed = parse_args(argc, argv, &TEST_ARGS, config);
 
@@ -33,12 +35,126 @@ int test_select_test_case(const char* const* str, void* params)
         return 1;
     }
 
+    if (strcasecmp(test_name, "histogram_sweep") == 0)
+    {
+        config->test_case = TEST_HISTOGRAM_SWEEP;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "corpus_histogram") == 0)
+    {
+        config->test_case = TEST_CORPUS_HISTOGRAM;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "corpus_benchmark") == 0)
+    {
+        config->test_case = TEST_CORPUS_BENCHMARK;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "batch_lookup") == 0)
+    {
+        config->test_case = TEST_BATCH_LOOKUP;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "filter") == 0)
+    {
+        config->test_case = TEST_FILTER;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "allocators") == 0)
+    {
+        config->test_case = TEST_ALLOCATORS;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "extendible") == 0)
+    {
+        config->test_case = TEST_EXTENDIBLE;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "probing") == 0)
+    {
+        config->test_case = TEST_PROBING;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "adaptive") == 0)
+    {
+        config->test_case = TEST_ADAPTIVE;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "hybrid") == 0)
+    {
+        config->test_case = TEST_HYBRID;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "stats") == 0)
+    {
+        config->test_case = TEST_STATS;
+        return 1;
+    }
+
     if (strcasecmp(test_name, "benchmark") == 0)
     {
         config->test_case = TEST_BENCHMARK_FULL;
         return 1;
     }
 
+    if (strcasecmp(test_name, "adversarial") == 0)
+    {
+        config->test_case = TEST_ADVERSARIAL;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "latency") == 0)
+    {
+        config->test_case = TEST_LATENCY;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "counters") == 0)
+    {
+        config->test_case = TEST_COUNTERS;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "trace") == 0)
+    {
+        config->test_case = TEST_TRACE;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "working_set") == 0)
+    {
+        config->test_case = TEST_WORKING_SET;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "memory") == 0)
+    {
+        config->test_case = TEST_MEMORY;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "scaling") == 0)
+    {
+        config->test_case = TEST_SCALING;
+        return 1;
+    }
+
+    if (strcasecmp(test_name, "compare") == 0)
+    {
+        config->test_case = TEST_COMPARE;
+        return 1;
+    }
+
     fprintf(stderr, "Error: unknown test case '%s'\n", test_name);
     config->had_error = 1;
     return -1;
@@ -78,6 +194,32 @@ int test_set_append([[maybe_unused]] const char* const* str, void* params)
     return 0;
 }
 
+int test_set_samples([[maybe_unused]] const char* const* str, void* params)
+{
+    TestConfig* config = (TestConfig*) params;
+    if (config->test_case != TEST_NONE)
+        return -1;
+
+    config->write_samples = 1;
+    return 0;
+}
+
+int test_set_storage(const char* const* str, void* params)
+{
+    TestConfig* config = (TestConfig*) params;
+    if (config->test_case != TEST_NONE)
+        return -1;
+
+    if (storage_parse_backend(*str, &config->storage) < 0)
+    {
+        fprintf(stderr, "Error: unknown storage backend '%s'\n", *str);
+        config->had_error = 1;
+        return -1;
+    }
+
+    return 1;
+}
+
 __attribute__((noreturn))
 int test_get_help([[maybe_unused]] const char* const* str,
                   [[maybe_unused]] void* params)
@@ -16,11 +16,32 @@
 
 #include "meerkat_args/argparser.h"
 
+#include "hash_table/storage.h"
+
 enum TestCase
 {
     TEST_NONE,
     TEST_BENCHMARK_FULL,
     TEST_HISTOGRAM,
+    TEST_HISTOGRAM_SWEEP,
+    TEST_CORPUS_HISTOGRAM,
+    TEST_CORPUS_BENCHMARK,
+    TEST_BATCH_LOOKUP,
+    TEST_FILTER,
+    TEST_ALLOCATORS,
+    TEST_EXTENDIBLE,
+    TEST_PROBING,
+    TEST_ADAPTIVE,
+    TEST_HYBRID,
+    TEST_STATS,
+    TEST_ADVERSARIAL,
+    TEST_LATENCY,
+    TEST_COUNTERS,
+    TEST_TRACE,
+    TEST_WORKING_SET,
+    TEST_MEMORY,
+    TEST_SCALING,
+    TEST_COMPARE,
 };
 
 struct TestConfig
@@ -29,6 +50,8 @@ struct TestConfig
     TestCase test_case;
     const char* filename;
     int append_to_file;
+    int write_samples;
+    storage_backend storage;
 };
 
 /**
@@ -72,6 +95,26 @@ int test_set_output(const char* const* str, void* params);
  */
 int test_set_append(const char* const* str, void* params);
 
+/**
+ * @brief Write every timed sample instead of summary statistics
+ *
+ * @param[in]    str    Parameter array
+ * @param[inout] params TestConfig instance
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int test_set_samples(const char* const* str, void* params);
+
+/**
+ * @brief Set storage backend of table arrays
+ *
+ * @param[in]    str    Parameter array
+ * @param[inout] params TestConfig instance
+ *
+ * @return 1 upon success, -1 otherwise
+ */
+int test_set_storage(const char* const* str, void* params);
+
 /**
  * @brief Print help message and exit
  *
@@ -96,6 +139,20 @@ static const arg_tag TEST_TAGS[] = {
         .description = 
             "If '-o' flag was specified, append to file instead of trunctating"
     },
+    {
+        .short_tag = '\0',
+        .long_tag = "samples",
+        .callback = test_set_samples,
+        .description = 
+            "Benchmark writes 'name,size,ms' row per sample, for 'compare'"
+    },
+    {
+        .short_tag = '\0',
+        .long_tag = "storage",
+        .callback = test_set_storage,
+        .description = 
+            "Table array storage, heap, mmap or hugetlb (default: heap)"
+    },
     {
         .short_tag = 'h',
         .long_tag = "help",
@@ -107,7 +164,31 @@ static const arg_tag TEST_TAGS[] = {
 
 static const arg_info TEST_ARGS = {
     .help_message = 
-        "hash_table_tests [-o <FILE> [--append]] <TEST CASE> [TEST OPTIONS]",
+        "hash_table_tests [-o <FILE> [--append]] [--samples] "
+        "[--storage <BACKEND>] <TEST CASE> [TEST OPTIONS]\n"
+        "\n"
+        "Test cases:\n"
+        "    histogram [HASH...]\n"
+        "    histogram_sweep [THREADS]\n"
+        "    corpus_histogram <FILE> <FORMAT> <BUCKETS> <HASH...>\n"
+        "    corpus_benchmark <FILE> <FORMAT> [TABLE [HASH]]\n"
+        "    batch_lookup [HASH [MAX KEYS [LOOKUPS]]]\n"
+        "    filter [HASH [KEYS [LOOKUPS]]]\n"
+        "    allocators [TABLE [KEYS]]\n"
+        "    extendible <FILE> [KEYS [POOL PAGES [LOOKUPS]]]\n"
+        "    probing [HASH [SIZE EXP [LOOKUPS]]]\n"
+        "    adaptive [KEYS [LOOKUPS]]\n"
+        "    hybrid [KEYS [LOOKUPS]]\n"
+        "    stats [KEYS]\n"
+        "    benchmark [TABLE [GENERATOR [HASH]]]\n"
+        "    adversarial\n"
+        "    latency [TABLE [GENERATOR [HASH [COMMANDS]]]]\n"
+        "    counters [HASH [COMMANDS]]\n"
+        "    trace <FILE> [KEYS [MIX [COMMANDS [KEY RANGE]]]]\n"
+        "    working_set [TABLE [HASH [LOAD FACTOR [MAX MIB [COMMANDS]]]]]\n"
+        "    memory [HASH [MAX KEYS]]\n"
+        "    scaling [TABLE [MIX [KEYS [MAX THREADS [DURATION MS]]]]]\n"
+        "    compare <BASELINE CSV> <CANDIDATE CSV> [THRESHOLD % [ALPHA]]",
     .name_handler = NULL,
     .plain_handler = test_select_test_case,
     .tags = TEST_TAGS,
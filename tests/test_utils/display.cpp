@@ -1,12 +1,29 @@
 #include <stdio.h>
+#include <stdint.h>
 #include <math.h>
+#include <time.h>
 
 #include "./display.h"
 
 static const size_t bar_length = 24;
+static const uint64_t redraw_period_ns = 100'000'000;
+
+static uint64_t get_time_ns(void)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1'000'000'000 + (uint64_t) now.tv_nsec;
+}
 
 void progress_bar(size_t done, size_t total, double last_ms)
 {
+    static uint64_t last_draw_ns = 0;
+
+    const uint64_t now_ns = get_time_ns();
+    if (done != 0 && done < total && now_ns - last_draw_ns < redraw_period_ns)
+        return;
+    last_draw_ns = now_ns;
+
     const double percentage = (double) done / (double) total;
     
     const size_t fill    = (size_t) round((double)bar_length * percentage);
@@ -13,7 +13,8 @@
 #define __TESTS_TEST_UTILS_DISPLAY_H
 
 /**
- * @brief Output progress bar on screen
+ * @brief Output progress bar on screen. Redraws are throttled to 10 per
+ * second, first and last states are always drawn.
  * 
  * @param[in] done	    - Number of completed events
  * @param[in] total	    - Total number of events to complete
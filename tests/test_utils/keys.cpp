@@ -0,0 +1,70 @@
+#include <stdlib.h>
+
+#include "./keys.h"
+
+uint32_t get_key(size_t index)
+{
+    uint32_t key = (uint32_t) index;
+    key ^= key >> 16;
+    key *= 0x85EBCA6B;
+    key ^= key >> 13;
+    key *= 0xC2B2AE35;
+    key ^= key >> 16;
+    return key;
+}
+
+uint64_t get_key_64(size_t index)
+{
+    uint64_t key = index;
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDlu;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53lu;
+    key ^= key >> 33;
+    return key;
+}
+
+uint32_t get_key(key_set set, size_t index, uint32_t stride)
+{
+    switch (set)
+    {
+    case KEY_SET_SEQUENTIAL:
+        return (uint32_t) index;
+    case KEY_SET_STRIDED:
+        return (uint32_t) index * stride;
+    case KEY_SET_RANDOM:
+    case KEY_SET_COUNT:
+    default:
+        return get_key(index);
+    }
+}
+
+uint32_t get_absent_key(key_set set, size_t key_count, uint32_t stride)
+{
+    const uint32_t random = (uint32_t) rand();
+
+    switch (set)
+    {
+    case KEY_SET_SEQUENTIAL:
+        return (uint32_t) key_count + random;
+    case KEY_SET_STRIDED:
+        /* Gaps between present keys */
+        return get_key(set, random % key_count, stride)
+                                        + 1 + random % (stride - 1);
+    case KEY_SET_RANDOM:
+    case KEY_SET_COUNT:
+    default:
+        return get_key(set, key_count + random, stride);
+    }
+}
+
+void generate_lookups(KeyLookups* lookups, key_set set, size_t key_count,
+                      size_t lookup_count, uint32_t stride)
+{
+    srand(0);
+    for (size_t i = 0; i < lookup_count; ++i)
+    {
+        lookups->hits[i] = get_key(set, (size_t) rand() % key_count, stride);
+        lookups->misses[i] = get_absent_key(set, key_count, stride);
+    }
+}
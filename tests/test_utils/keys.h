@@ -0,0 +1,99 @@
+/**
+ * @file keys.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ *
+ * @brief Key generators of test cases
+ *
+ * @version 0.1
+ * @date 2023-06-06
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_UTILS_KEYS_H
+#define __TESTS_TEST_UTILS_KEYS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum key_set
+{
+    /** Scrambled indices */
+    KEY_SET_RANDOM,
+    /** Indices themselves */
+    KEY_SET_SEQUENTIAL,
+    /** Indices multiplied by stride */
+    KEY_SET_STRIDED,
+    KEY_SET_COUNT
+};
+
+static const char* const KEY_SET_NAMES[KEY_SET_COUNT] = {
+    "random",
+    "sequential",
+    "strided",
+};
+
+struct KeyLookups
+{
+    uint32_t* hits;
+    uint32_t* misses;
+};
+
+/**
+ * @brief Scramble index with MurmurHash3 finalizer. It is a bijection, so
+ * that distinct indices give distinct keys.
+ *
+ * @param[in] index     - Key index
+ *
+ * @return Key
+ */
+uint32_t get_key(size_t index);
+
+/**
+ * @brief Scramble index with 64-bit MurmurHash3 finalizer. It is a bijection,
+ * so that distinct indices give distinct keys.
+ *
+ * @param[in] index     - Key index
+ *
+ * @return Key
+ */
+uint64_t get_key_64(size_t index);
+
+/**
+ * @brief Get key of set with given index. Distinct indices give distinct
+ * keys, as long as strided keys do not overflow.
+ *
+ * @param[in] set       - Key set
+ * @param[in] index     - Key index
+ * @param[in] stride    - Distance between strided keys
+ *
+ * @return Key
+ */
+uint32_t get_key(key_set set, size_t index, uint32_t stride);
+
+/**
+ * @brief Get random key, which is not among first `key_count` keys of set.
+ * Uses `rand()`.
+ *
+ * @param[in] set       - Key set
+ * @param[in] key_count - Number of present keys
+ * @param[in] stride    - Distance between strided keys
+ *
+ * @return Key
+ */
+uint32_t get_absent_key(key_set set, size_t key_count, uint32_t stride);
+
+/**
+ * @brief Fill `lookup_count` hits among first `key_count` keys of set and
+ * as many misses. Random generator is reset, so that every call with the
+ * same arguments gives the same lookups.
+ *
+ * @param[out] lookups      - Arrays of at least `lookup_count` keys
+ * @param[in]  set          - Key set
+ * @param[in]  key_count    - Number of present keys
+ * @param[in]  lookup_count - Number of hits and misses
+ * @param[in]  stride       - Distance between strided keys
+ */
+void generate_lookups(KeyLookups* lookups, key_set set, size_t key_count,
+                      size_t lookup_count, uint32_t stride);
+
+#endif /* keys.h */
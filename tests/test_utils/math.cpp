@@ -1,4 +1,5 @@
 #include <math.h>
+#include <stdlib.h>
 
 #include "./math.h"
 
@@ -22,6 +23,103 @@ double get_stddev(const double* data, double mean, size_t data_size)
     return sqrt(variance / (double)(data_size - 1));
 }
 
+double get_confidence_95(double stddev, size_t data_size)
+{
+    /* Two-sided 97.5% quantiles of t-distribution for 1..30 degrees of
+     * freedom, normal approximation afterwards */
+    static const double t_quantile[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+         2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+         2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    const size_t quantile_count = sizeof(t_quantile) / sizeof(*t_quantile);
+
+    if (data_size < 2)
+        return NAN;
+
+    const size_t freedom = data_size - 1;
+    const double t = freedom <= quantile_count ? t_quantile[freedom - 1]
+                                               : 1.960;
+
+    return t * stddev / sqrt((double) data_size);
+}
+
+static int compare_doubles(const void* lhs, const void* rhs)
+{
+    const double a = *(const double*) lhs;
+    const double b = *(const double*) rhs;
+    return (a > b) - (a < b);
+}
+
+double get_median(double* data, size_t data_size)
+{
+    if (data_size == 0)
+        return NAN;
+
+    qsort(data, data_size, sizeof(*data), compare_doubles);
+
+    const size_t mid = data_size / 2;
+    return data_size % 2 ? data[mid] : (data[mid - 1] + data[mid]) / 2;
+}
+
+double get_mann_whitney_p(const double* x, size_t x_size,
+                          const double* y, size_t y_size)
+{
+    if (x_size == 0 || y_size == 0)
+        return NAN;
+
+    /* Number of pairs where value from `y` is greater, ties count as half */
+    double u = 0;
+    for (size_t i = 0; i < x_size; ++i)
+        for (size_t j = 0; j < y_size; ++j)
+        {
+            if (y[j] > x[i])
+                u += 1;
+            else if (!(y[j] < x[i]))
+                u += 0.5;
+        }
+
+    const double n = (double) x_size, m = (double) y_size;
+    const double mean = n * m / 2;
+    const double sigma = sqrt(n * m * (n + m + 1) / 12);
+
+    /* Continuity correction */
+    const double z = (u - mean - 0.5) / sigma;
+    return 0.5 * erfc(z / M_SQRT2);
+}
+
+int get_bootstrap_interval(const double* data, size_t data_size, double alpha,
+                           double* low, double* high)
+{
+    const size_t resamples = 10'000;
+
+    if (data_size == 0)
+        return -1;
+
+    double* means = (double*) calloc(resamples, sizeof(*means));
+    if (!means)
+        return -1;
+
+    /* Fixed seed, so that repeated comparisons give the same answer */
+    unsigned seed = 0;
+    for (size_t i = 0; i < resamples; ++i)
+    {
+        double sum = 0;
+        for (size_t j = 0; j < data_size; ++j)
+            sum += data[(size_t) rand_r(&seed) % data_size];
+        means[i] = sum / (double) data_size;
+    }
+
+    qsort(means, resamples, sizeof(*means), compare_doubles);
+
+    const size_t low_index = (size_t) (alpha * (double) (resamples - 1));
+    *low  = means[low_index];
+    *high = means[resamples - 1 - low_index];
+
+    free(means);
+    return 0;
+}
+
 double get_round_exponent(double value)
 {
     const double exponent = pow(10, round(log10(fabs(value))));
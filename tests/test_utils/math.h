@@ -35,6 +35,57 @@ double get_mean(const double* data, size_t data_size);
  */
 double get_stddev(const double* data, double mean, size_t data_size);
 
+/**
+ * @brief Calculate half-width of 95% confidence interval of mean
+ * using Student's t-distribution
+ *
+ * @param[in] stddev    - Sample standard deviation
+ * @param[in] data_size - Number of samples
+ *
+ * @return Half-width of confidence interval
+ */
+double get_confidence_95(double stddev, size_t data_size);
+
+/**
+ * @brief Calculate median of values. Values are sorted in place.
+ *
+ * @param[inout] data       - Values to calculate median of
+ * @param[in]    data_size  - Length of `data`
+ *
+ * @return Median value in `data`
+ */
+double get_median(double* data, size_t data_size);
+
+/**
+ * @brief One-sided Mann-Whitney U test with normal approximation (use at
+ * least 8 values in each sample)
+ *
+ * @param[in] x         - First sample
+ * @param[in] x_size    - Length of `x`
+ * @param[in] y         - Second sample
+ * @param[in] y_size    - Length of `y`
+ *
+ * @return p-value of hypothesis that values in `y` tend to be greater than
+ * values in `x`
+ */
+double get_mann_whitney_p(const double* x, size_t x_size,
+                          const double* y, size_t y_size);
+
+/**
+ * @brief Calculate bootstrap confidence interval of mean
+ *
+ * @param[in]  data         - Sample
+ * @param[in]  data_size    - Length of `data`
+ * @param[in]  alpha        - Probability of true mean being below `low`
+ *                            (and above `high`)
+ * @param[out] low          - Lower bound of interval
+ * @param[out] high         - Upper bound of interval
+ *
+ * @return 0 upon success, -1 otherwise
+ */
+int get_bootstrap_interval(const double* data, size_t data_size, double alpha,
+                           double* low, double* high);
+
 /**
  * @brief Get exponent for rounding to most significant digit
  *
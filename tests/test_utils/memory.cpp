@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <sys/resource.h>
+#include <new>
+
+#include "./memory.h"
+
+extern "C"
+{
+    void* __real_malloc (size_t size);
+    void* __real_calloc (size_t count, size_t size);
+    void* __real_realloc(void* ptr, size_t size);
+    void  __real_free   (void* ptr);
+
+    void* __wrap_malloc (size_t size);
+    void* __wrap_calloc (size_t count, size_t size);
+    void* __wrap_realloc(void* ptr, size_t size);
+    void  __wrap_free   (void* ptr);
+}
+
+static int hook_enabled = 0;
+static AllocStats hook_stats = {};
+
+__always_inline
+static void record_alloc(void* ptr)
+{
+    if (!ptr) return;
+
+    const size_t size = malloc_usable_size(ptr);
+    hook_stats.allocated_bytes += size;
+    hook_stats.live_bytes += (int64_t) size;
+    if (hook_stats.live_bytes > hook_stats.peak_live_bytes)
+        hook_stats.peak_live_bytes = hook_stats.live_bytes;
+}
+
+__always_inline
+static void record_free(void* ptr)
+{
+    if (!ptr) return;
+
+    hook_stats.live_bytes -= (int64_t) malloc_usable_size(ptr);
+}
+
+void* __wrap_malloc(size_t size)
+{
+    void* ptr = __real_malloc(size);
+    if (hook_enabled)
+    {
+        ++hook_stats.malloc_calls;
+        record_alloc(ptr);
+    }
+    return ptr;
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+    void* ptr = __real_calloc(count, size);
+    if (hook_enabled)
+    {
+        ++hook_stats.calloc_calls;
+        record_alloc(ptr);
+    }
+    return ptr;
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+    if (!hook_enabled)
+        return __real_realloc(ptr, size);
+
+    /* Old block is accounted before call, as it may be freed by it */
+    const size_t old_size = ptr ? malloc_usable_size(ptr) : 0;
+
+    void* new_ptr = __real_realloc(ptr, size);
+
+    ++hook_stats.realloc_calls;
+    if (new_ptr || size == 0)
+        hook_stats.live_bytes -= (int64_t) old_size;
+    record_alloc(new_ptr);
+
+    return new_ptr;
+}
+
+void __wrap_free(void* ptr)
+{
+    if (hook_enabled && ptr)
+    {
+        ++hook_stats.free_calls;
+        record_free(ptr);
+    }
+    __real_free(ptr);
+}
+
+/* Default operator new calls malloc from inside libstdc++, which is not
+ * wrapped, so it is replaced to allocate through wrappers */
+void* operator new(size_t size)
+{
+    if (size == 0)
+        size = 1;
+
+    void* ptr = NULL;
+    while (!(ptr = __wrap_malloc(size)))
+    {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    try { return operator new(size); }
+    catch (const std::bad_alloc&) { return NULL; }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    __wrap_free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    __wrap_free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    __wrap_free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    __wrap_free(ptr);
+}
+
+void memory_hook_enable(int enabled)
+{
+    hook_enabled = enabled;
+}
+
+void memory_hook_reset(void)
+{
+    memset(&hook_stats, 0, sizeof(hook_stats));
+}
+
+void memory_hook_get_stats(AllocStats* stats)
+{
+    *stats = hook_stats;
+}
+
+int memory_reset_peak_rss(void)
+{
+    FILE* clear_refs = fopen("/proc/self/clear_refs", "w");
+    if (!clear_refs)
+        return -1;
+
+    /* "5" resets peak RSS (VmHWM) to current RSS, see proc(5) */
+    const int written = fputs("5", clear_refs);
+    return fclose(clear_refs) == 0 && written >= 0 ? 0 : -1;
+}
+
+size_t memory_get_peak_rss_kb(void)
+{
+    FILE* status = fopen("/proc/self/status", "r");
+    if (status)
+    {
+        char line[128] = "";
+        size_t peak_kb = 0;
+        while (fgets(line, sizeof(line), status))
+            if (sscanf(line, "VmHWM: %zu kB", &peak_kb) == 1)
+                break;
+        fclose(status);
+
+        if (peak_kb)
+            return peak_kb;
+    }
+
+    rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+    return (size_t) usage.ru_maxrss;
+}
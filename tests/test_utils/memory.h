@@ -0,0 +1,68 @@
+/**
+ * @file memory.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief Heap allocation counting and peak resident set size
+ *
+ * Allocation functions are interposed with `-Wl,--wrap`, so only calls made
+ * from objects of test binary are counted (allocations made inside libc,
+ * e.g. by `strdup`, are not). Global `operator new` and `operator delete`
+ * are replaced to go through the same wrappers, so that blocks of standard
+ * containers are counted as `malloc` calls. Counting is disabled by default and is not
+ * thread-safe.
+ *
+ * @version 0.1
+ * @date 2023-05-27
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_UTILS_MEMORY_H
+#define __TESTS_TEST_UTILS_MEMORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct AllocStats
+{
+    size_t malloc_calls;
+    size_t calloc_calls;
+    size_t realloc_calls;
+    size_t free_calls;
+
+    /** Usable size of all allocated blocks */
+    size_t allocated_bytes;
+    /** Allocated minus freed usable size since last reset, may be negative
+     * if blocks allocated before reset were freed */
+    int64_t live_bytes;
+    int64_t peak_live_bytes;
+};
+
+/**
+ * @brief Enable or disable allocation counting
+ */
+void memory_hook_enable(int enabled);
+
+/**
+ * @brief Reset allocation counters
+ */
+void memory_hook_reset(void);
+
+/**
+ * @brief Get allocation counters accumulated since last reset
+ */
+void memory_hook_get_stats(AllocStats* stats);
+
+/**
+ * @brief Reset peak resident set size of process
+ *
+ * @return 0 upon success, -1 if not supported (peak is then reported for
+ * the whole process lifetime)
+ */
+int memory_reset_peak_rss(void);
+
+/**
+ * @brief Get peak resident set size in KiB since start or last reset
+ */
+size_t memory_get_peak_rss_kb(void);
+
+#endif /* memory.h */
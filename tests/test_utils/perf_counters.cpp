@@ -0,0 +1,143 @@
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "./perf_counters.h"
+
+struct CounterConfig
+{
+    uint32_t type;
+    uint64_t config;
+};
+
+static constexpr uint64_t cache_event(uint64_t cache, uint64_t op,
+                                      uint64_t result)
+{
+    return cache | (op << 8) | (result << 16);
+}
+
+static const CounterConfig counter_configs[PERF_COUNTER_COUNT] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D,
+                                      PERF_COUNT_HW_CACHE_OP_READ,
+                                      PERF_COUNT_HW_CACHE_RESULT_MISS) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB,
+                                      PERF_COUNT_HW_CACHE_OP_READ,
+                                      PERF_COUNT_HW_CACHE_RESULT_MISS) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+static int open_counter(const CounterConfig* config, int group_fd)
+{
+    perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.type = config->type;
+    attr.config = config->config;
+    attr.disabled = group_fd < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID
+                     | PERF_FORMAT_TOTAL_TIME_ENABLED
+                     | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+size_t perf_counters_open(PerfCounters* counters)
+{
+    counters->leader_fd = -1;
+    for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+        counters->fds[i] = -1;
+        counters->ids[i] = 0;
+    }
+
+    size_t opened = 0;
+    for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+        const int fd = open_counter(&counter_configs[i], counters->leader_fd);
+        if (fd < 0)
+            continue;
+
+        if (ioctl(fd, PERF_EVENT_IOC_ID, &counters->ids[i]) < 0)
+        {
+            close(fd);
+            continue;
+        }
+
+        if (counters->leader_fd < 0)
+            counters->leader_fd = fd;
+        counters->fds[i] = fd;
+        ++ opened;
+    }
+
+    return opened;
+}
+
+void perf_counters_close(PerfCounters* counters)
+{
+    /* Members first, leader last */
+    for (size_t i = PERF_COUNTER_COUNT; i > 0; --i)
+        if (counters->fds[i - 1] >= 0)
+            close(counters->fds[i - 1]);
+
+    memset(counters, 0, sizeof(*counters));
+    counters->leader_fd = -1;
+}
+
+void perf_counters_start(PerfCounters* counters)
+{
+    if (counters->leader_fd < 0) return;
+
+    ioctl(counters->leader_fd, PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP);
+    ioctl(counters->leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void perf_counters_stop(PerfCounters* counters)
+{
+    if (counters->leader_fd < 0) return;
+
+    ioctl(counters->leader_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+}
+
+int perf_counters_read(const PerfCounters* counters,
+                       double values[PERF_COUNTER_COUNT])
+{
+    for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i)
+        values[i] = NAN;
+
+    if (counters->leader_fd < 0)
+        return -1;
+
+    /* nr, time_enabled, time_running, then (value, id) pairs */
+    uint64_t buffer[3 + 2 * PERF_COUNTER_COUNT] = {};
+    if (read(counters->leader_fd, buffer, sizeof(buffer)) < 0)
+        return -1;
+
+    const uint64_t count   = buffer[0];
+    const uint64_t enabled = buffer[1];
+    const uint64_t running = buffer[2];
+
+    /* Group was never scheduled on PMU */
+    if (running == 0)
+        return -1;
+
+    const double scale = (double) enabled / (double) running;
+
+    for (uint64_t i = 0; i < count && i < PERF_COUNTER_COUNT; ++i)
+    {
+        const uint64_t value = buffer[3 + 2 * i];
+        const uint64_t id    = buffer[3 + 2 * i + 1];
+
+        for (size_t j = 0; j < PERF_COUNTER_COUNT; ++j)
+            if (counters->fds[j] >= 0 && counters->ids[j] == id)
+                values[j] = (double) value * scale;
+    }
+
+    return 0;
+}
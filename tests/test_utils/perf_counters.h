@@ -0,0 +1,90 @@
+/**
+ * @file perf_counters.h
+ * @author MeerkatBoss (solodovnikov.ia@phystech.edu)
+ * 
+ * @brief Hardware performance counters via perf_event_open
+ *
+ * @version 0.1
+ * @date 2023-05-24
+ *
+ * @copyright Copyright MeerkatBoss (c) 2023
+ */
+#ifndef __TESTS_TEST_UTILS_PERF_COUNTERS_H
+#define __TESTS_TEST_UTILS_PERF_COUNTERS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+enum perf_counter
+{
+    PERF_CYCLES         = 0,
+    PERF_INSTRUCTIONS   = 1,
+    PERF_L1D_MISSES     = 2,
+    PERF_LLC_MISSES     = 3,
+    PERF_DTLB_MISSES    = 4,
+    PERF_BRANCH_MISSES  = 5,
+    PERF_COUNTER_COUNT
+};
+
+static const char* const PERF_COUNTER_NAMES[PERF_COUNTER_COUNT] = {
+    "cycles",
+    "instructions",
+    "l1d_misses",
+    "llc_misses",
+    "dtlb_misses",
+    "branch_misses",
+};
+
+/**
+ * @brief Group of counters of calling thread. Counters which could not be
+ * opened are skipped, if none are available all operations are no-op.
+ */
+struct PerfCounters
+{
+    int fds[PERF_COUNTER_COUNT];
+    uint64_t ids[PERF_COUNTER_COUNT];
+    int leader_fd;
+};
+
+/**
+ * @brief Open counters
+ *
+ * @param[out] counters - Counter group
+ *
+ * @return Number of available counters
+ */
+size_t perf_counters_open(PerfCounters* counters);
+
+/**
+ * @brief Close counters
+ *
+ * @param[inout] counters - Counter group
+ */
+void perf_counters_close(PerfCounters* counters);
+
+/**
+ * @brief Reset counters to zero and start counting
+ *
+ * @param[inout] counters - Counter group
+ */
+void perf_counters_start(PerfCounters* counters);
+
+/**
+ * @brief Stop counting
+ *
+ * @param[inout] counters - Counter group
+ */
+void perf_counters_stop(PerfCounters* counters);
+
+/**
+ * @brief Read counter values, scaled if group was multiplexed
+ *
+ * @param[in]  counters - Counter group
+ * @param[out] values   - Counter values, NaN for unavailable counters
+ *
+ * @return 0 upon success, -1 if no counters were read
+ */
+int perf_counters_read(const PerfCounters* counters,
+                       double values[PERF_COUNTER_COUNT]);
+
+#endif /* perf_counters.h */